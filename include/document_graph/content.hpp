@@ -24,6 +24,10 @@ namespace hypha
 
         const std::string toString() const;
 
+        // appends the canonical encoding used by toString, without building a temporary string
+        void appendTo(std::string &out) const;
+        const size_t encodedSize() const;
+
         // NOTE: not using m_ notation because this changes serialization format
         std::string label;
         FlexValue value;
@@ -89,11 +89,12 @@ namespace hypha
         eosio::time_point created_date;
         eosio::name contract;
 
-        // toString iterates through all content, all levels, concatenating all values
-        // the resulting string is used for fingerprinting and hashing
+        // toString iterates through all content, all levels, appending all values to one reserved buffer
+        // the resulting string is used for fingerprinting and hashing, its bytes must never change
         const std::string toString();
         static const std::string toString(const ContentGroups &contentGroups);
         static const std::string toString(const ContentGroup &contentGroup);
+        static void appendTo(const ContentGroup &contentGroup, std::string &out);
 
         EOSLIB_SERIALIZE(Document, (id)(hash)(creator)(content_groups)(certificates)(created_date)(contract))
 
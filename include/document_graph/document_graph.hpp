@@ -12,6 +12,7 @@
 #include <document_graph/content.hpp>
 #include <document_graph/document.hpp>
 #include <document_graph/edge.hpp>
+#include <document_graph/edge_range.hpp>
 
 namespace hypha
 {
@@ -32,6 +33,14 @@ namespace hypha
         std::vector<Edge> getEdgesTo(const eosio::checksum256 &toNode, const eosio::name &edgeName);
         std::vector<Edge> getEdgesToOrFail(const eosio::checksum256 &toNode, const eosio::name &edgeName);
 
+        // lazy views over the same indexes, prefer these when not every edge is needed
+        EdgesBetween edgesBetween(const eosio::checksum256 &fromNode, const eosio::checksum256 &toNode);
+        EdgesFrom edgesFrom(const eosio::checksum256 &fromNode, const eosio::name &edgeName);
+        EdgesTo edgesTo(const eosio::checksum256 &toNode, const eosio::name &edgeName);
+
+        bool hasEdgesFrom(const eosio::checksum256 &fromNode, const eosio::name &edgeName);
+        Edge getEdgeFromOrFail(const eosio::checksum256 &fromNode, const eosio::name &edgeName);
+
         Edge createEdge(eosio::name &creator, const eosio::checksum256 &fromNode, const eosio::checksum256 &toNode, const eosio::name &edgeName);
 
         Document updateDocument(const eosio::name &updater,
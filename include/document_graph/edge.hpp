@@ -58,9 +58,16 @@ namespace hypha
                            const eosio::checksum256 &_to_node,
                            const eosio::name &_edge_name);
 
+        // rewrites the secondary index keys of up to _batch_size edges starting at primary key _start
+        // returns whether edges remain and the primary key to resume from
+        static std::pair<bool, uint64_t> reindex(const eosio::name &_contract,
+                                                 const uint64_t &_start,
+                                                 const uint64_t &_batch_size);
+
         uint64_t id; // hash of from_node, to_node, and edge_name
 
         // these three additional indexes allow isolating/querying edges more precisely (less iteration)
+        // keys are built with indexKey, edges written before that use the legacy concatHash keys until reindexed
         uint64_t from_node_edge_name_index;
         uint64_t from_node_to_node_index;
         uint64_t to_node_edge_name_index;
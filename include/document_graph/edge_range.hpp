@@ -0,0 +1,119 @@
+#pragma once
+
+#include <iterator>
+#include <utility>
+
+#include <eosio/name.hpp>
+#include <eosio/multi_index.hpp>
+
+#include <document_graph/edge.hpp>
+
+namespace hypha
+{
+    // EdgeRange walks one of the hashed edge indexes lazily and stops at the first edge whose key
+    // does not match, so exists/first only read the rows they need and nothing is copied into vectors.
+    // Rows are cached by the table the range owns, references into a range must not outlive it.
+    // While quests::reindexedges is still running a group can be split between the indexKey key
+    // and the legacy concatHash key, so the range walks the new key first and then the legacy one.
+    // Drop the legacy key once the reindex has completed on every deployment.
+    template <eosio::name::raw IndexName, uint64_t (Edge::*KeyOf)() const>
+    class EdgeRange
+    {
+        using index_type = decltype(std::declval<Edge::edge_table &>().template get_index<IndexName>());
+        using index_iterator = typename index_type::const_iterator;
+
+    public:
+        class iterator
+        {
+        public:
+            using iterator_category = std::input_iterator_tag;
+            using value_type = Edge;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const Edge *;
+            using reference = const Edge &;
+
+            iterator(const index_type *index, index_iterator itr, uint64_t key, uint64_t legacy_key)
+                : m_index(index), m_itr(itr), m_key(key), m_legacy_key(legacy_key) { skipMismatch(); }
+
+            const Edge &operator*() const { return *m_itr; }
+            const Edge *operator->() const { return &*m_itr; }
+
+            iterator &operator++()
+            {
+                ++m_itr;
+                skipMismatch();
+                return *this;
+            }
+
+            bool operator==(const iterator &other) const { return m_itr == other.m_itr; }
+            bool operator!=(const iterator &other) const { return m_itr != other.m_itr; }
+
+        private:
+            // the index is sorted by key, so the first mismatch ends the current key, then the legacy key is walked
+            void skipMismatch()
+            {
+                if (m_itr == m_index->cend() || ((*m_itr).*KeyOf)() == m_key)
+                {
+                    return;
+                }
+                if (m_legacy_key != m_key)
+                {
+                    m_key = m_legacy_key;
+                    m_itr = m_index->find(m_key);
+                    if (m_itr == m_index->cend() || ((*m_itr).*KeyOf)() == m_key)
+                    {
+                        return;
+                    }
+                }
+                m_itr = m_index->cend();
+            }
+
+            const index_type *m_index;
+            index_iterator m_itr;
+            uint64_t m_key;
+            uint64_t m_legacy_key;
+        };
+
+        EdgeRange(const eosio::name &contract, uint64_t key, uint64_t legacy_key)
+            : m_table(contract, contract.value), m_index(m_table.template get_index<IndexName>()), m_key(key), m_legacy_key(legacy_key) {}
+
+        EdgeRange(const EdgeRange &) = delete;
+        EdgeRange &operator=(const EdgeRange &) = delete;
+
+        iterator begin() const { return iterator(&m_index, m_index.find(m_key), m_key, m_legacy_key); }
+        iterator end() const { return iterator(&m_index, m_index.cend(), m_key, m_key); }
+
+        bool exists() const { return begin() != end(); }
+
+        uint64_t count() const
+        {
+            uint64_t total = 0;
+            for (auto itr = begin(); itr != end(); ++itr)
+            {
+                total++;
+            }
+            return total;
+        }
+
+        std::pair<bool, Edge> first() const
+        {
+            auto itr = begin();
+            if (itr != end())
+            {
+                return std::pair<bool, Edge>(true, *itr);
+            }
+            return std::pair<bool, Edge>(false, Edge{});
+        }
+
+    private:
+        Edge::edge_table m_table;
+        index_type m_index;
+        uint64_t m_key;
+        uint64_t m_legacy_key;
+    };
+
+    using EdgesBetween = EdgeRange<eosio::name("byfromto"), &Edge::by_from_node_to_node_index>;
+    using EdgesFrom = EdgeRange<eosio::name("byfromname"), &Edge::by_from_node_edge_name_index>;
+    using EdgesTo = EdgeRange<eosio::name("bytoname"), &Edge::by_to_node_edge_name_index>;
+
+} // namespace hypha
@@ -14,4 +14,10 @@ namespace hypha
     const std::uint64_t concatHash(const eosio::checksum256 sha1, const eosio::checksum256 sha2);
     const std::uint64_t concatHash(const eosio::checksum256 sha, const eosio::name label);
 
+    // secondary edge index keys, mixed from the raw checksum words instead of hex strings
+    const std::uint64_t mix64(std::uint64_t x);
+    const std::uint64_t foldHash(const eosio::checksum256 &sha);
+    const std::uint64_t indexKey(const eosio::checksum256 &sha1, const eosio::checksum256 &sha2);
+    const std::uint64_t indexKey(const eosio::checksum256 &sha, const eosio::name &label);
+
 } // namespace hypha
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include <eosio/asset.hpp>
 #include <eosio/transaction.hpp>
 #include <eosio/singleton.hpp>
+#include <eosio/binary_extension.hpp>
 #include <contracts.hpp>
 #include <tables.hpp>
 #include <tables/price_history_table.hpp>
@@ -21,6 +22,7 @@ CONTRACT sale : public contract {
         pricehistory(receiver, receiver.value),
         rounds(receiver, receiver.value),
         dailystats(receiver, receiver.value),
+        dayepoch(receiver, receiver.value),
         payhistory(receiver, receiver.value),
         flags(receiver, receiver.value)
         {}
@@ -57,6 +59,8 @@ CONTRACT sale : public contract {
 
     ACTION updatevol(uint64_t round_id, uint64_t volume);
 
+    ACTION calcrounds();
+
     //ACTION testhusd(name from, name to, asset quantity);
 
   private:
@@ -65,9 +69,12 @@ CONTRACT sale : public contract {
     void on_husd(name from, name to, asset quantity, string memo);
 
     asset token_for_usd(asset usd_quantity, asset token_asset);
+    double round_usd(uint64_t volume, asset hypha_usd);
+    void update_round_totals(uint64_t round_id);
     void update_price(); 
     void price_update_aux();
     bool is_paused();
+    uint64_t current_day();
     bool is_set(name flag);
 
     void price_history_update(); 
@@ -122,17 +129,27 @@ CONTRACT sale : public contract {
       uint64_t id;
       uint64_t max_sold;
       asset hypha_usd;
+      eosio::binary_extension<double> usd_total; // USD value (x token precision) of all rounds up to this one
 
       uint64_t primary_key()const { return id; }
+      uint64_t by_max_sold()const { return max_sold; }
+      double by_usd_total()const { return usd_total.value_or(0); }
     };
     
     TABLE stattable {
       name buyer_account;
       uint64_t tokens_purchased;
+      eosio::binary_extension<uint64_t> day; // day epoch the purchases were made in
       
       uint64_t primary_key()const { return buyer_account.value; }
     };
 
+    // dailystats rows of an older day count as zero, onperiod only advances the day
+    TABLE day_epoch_table {
+      uint64_t day = 0;
+      uint64_t timestamp = 0;
+    };
+
     TABLE soldtable {
       uint64_t id;
       uint64_t total_sold;
@@ -176,8 +193,14 @@ CONTRACT sale : public contract {
     typedef eosio::multi_index<"price"_n, price_table> dump_for_price;
     
     typedef multi_index<"dailystats"_n, stattable> stattables;
+
+    typedef singleton<"dayepoch"_n, day_epoch_table> day_epoch_tables;
+    typedef eosio::multi_index<"dayepoch"_n, day_epoch_table> dump_for_day_epoch;
     
-    typedef multi_index<"rounds"_n, round_table> round_tables;
+    typedef multi_index<"rounds"_n, round_table,
+      indexed_by<"bymaxsold"_n,const_mem_fun<round_table, uint64_t, &round_table::by_max_sold>>,
+      indexed_by<"byusdtotal"_n,const_mem_fun<round_table, double, &round_table::by_usd_total>>
+    > round_tables;
 
     typedef eosio::multi_index<"payhistory"_n, payhistory_table,
       indexed_by<"bypaymentid"_n,const_mem_fun<payhistory_table, uint64_t, &payhistory_table::by_payment_id>>
@@ -195,6 +218,8 @@ CONTRACT sale : public contract {
 
     stattables dailystats;
 
+    day_epoch_tables dayepoch;
+
     payhistory_tables payhistory;
 
     flags_tables flags;
@@ -213,7 +238,7 @@ extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
           (addround)(initsale)(initrounds)(priceupdate)
           (pause)(unpause)(setflag)
           (incprice)
-          (updatevol)
+          (updatevol)(calcrounds)
           //(testhusd)
           )
       }
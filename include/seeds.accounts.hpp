@@ -10,6 +10,7 @@
 #include <tables/ban_table.hpp>
 #include <tables/config_float_table.hpp>
 #include <tables/deferred_id_table.hpp>
+#include <tables/rank_bounds_table.hpp>
 #include <utils.hpp>
 
 using namespace eosio;
@@ -29,6 +30,8 @@ CONTRACT accounts : public contract {
           flags(receiver, receiver.value),
           rep(receiver, receiver.value),
           sizes(receiver, receiver.value),
+          rankbounds(receiver, receiver.value),
+          rankpasses(receiver, receiver.value),
           balances(contracts::harvest, contracts::harvest.value),
           config(contracts::settings, contracts::settings.value),
           configfloat(contracts::settings, contracts::settings.value),
@@ -69,11 +72,13 @@ CONTRACT accounts : public contract {
 
       ACTION rankreps();
       ACTION rankorgreps();
-      ACTION rankrep(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name scope);
+      ACTION rankrep(uint64_t start_val, uint64_t start_id, uint64_t current, uint64_t chunksize, name scope);
+      ACTION mergerepdlt(name scope);
+      ACTION countreps(name scope, uint64_t start, uint64_t chunksize);
 
       ACTION rankcbss();
       ACTION rankorgcbss();
-      ACTION rankcbs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name scope);
+      ACTION rankcbs(uint64_t start_val, uint64_t start_id, uint64_t current, uint64_t chunksize, name scope);
 
       ACTION changesize(name id, int64_t delta);
 
@@ -116,6 +121,9 @@ CONTRACT accounts : public contract {
       const name individual_scope = get_self();
       const name organization_scope = "org"_n;
 
+      // rep values counted exactly by the rep count tree, higher values share the last node
+      const uint64_t rep_count_nodes = 1 << 16;
+
       const name not_found = ""_n;
 
       const name reputation_reward_resident = "refrep1.ind"_n;
@@ -167,6 +175,12 @@ CONTRACT accounts : public contract {
       uint64_t countrefs(name user, int check_num_residents);
       uint64_t rep_score(name user);
       void add_rep_item(name account, uint64_t reputation, name scope);
+      void change_rep(name account, int64_t delta, name scope);
+      void apply_rep_delta(name account, int64_t delta, name scope);
+      void count_rep(name account, int64_t old_rep, int64_t new_rep, name scope);
+      bool rep_counted(name scope);
+      uint64_t rep_position(name account, name scope);
+      void demote_to_rank(name to, uint64_t rank);
       uint64_t config_get(name key);
       double config_float_get(name key);
       void size_change(name id, int delta);
@@ -183,6 +197,7 @@ CONTRACT accounts : public contract {
       void calc_vouch_rep(name account);
       name get_scope(name type);
       void send_add_cbs_org(name user, uint64_t amount);
+      void send_mark_dirty(std::vector<name> accounts);
       void send_bantree(name account);
       void check_is_banned(name account);
 
@@ -194,6 +209,18 @@ CONTRACT accounts : public contract {
 
       DEFINE_REP_TABLE_MULTI_INDEX
 
+      DEFINE_REP_DELTA_TABLE
+
+      DEFINE_REP_DELTA_TABLE_MULTI_INDEX
+
+      DEFINE_REP_COUNT_TABLE
+
+      DEFINE_REP_COUNT_TABLE_MULTI_INDEX
+
+      DEFINE_REP_COUNT_STATE_TABLE
+
+      DEFINE_REP_COUNT_STATE_SINGLETON
+
       DEFINE_SIZE_TABLE
 
       DEFINE_SIZE_TABLE_MULTI_INDEX
@@ -202,6 +229,14 @@ CONTRACT accounts : public contract {
 
       DEFINE_CBS_TABLE_MULTI_INDEX
 
+      DEFINE_RANK_BOUNDS_TABLE
+
+      DEFINE_RANK_BOUNDS_TABLE_MULTI_INDEX
+
+      DEFINE_RANK_PASS_TABLE
+
+      DEFINE_RANK_PASS_TABLE_MULTI_INDEX
+
       DEFINE_BAN_TABLE
       DEFINE_BAN_TABLE_MULTI_INDEX
 
@@ -375,6 +410,8 @@ CONTRACT accounts : public contract {
     user_tables users;
     rep_tables rep;
     size_tables sizes;
+    rank_bounds_tables rankbounds;
+    rank_pass_tables rankpasses;
 
     size_tables history_sizes;
     resident_tables residents;
@@ -427,7 +464,7 @@ CONTRACT accounts : public contract {
 EOSIO_DISPATCH(accounts, (reset)(adduser)(canresident)(makeresident)(cancitizen)(makecitizen)(update)(addref)(invitevouch)(addrep)(changesize)
 (subrep)(testsetrep)(testsetrs)(testcitizen)(testresident)(testvisitor)(testremove)(testsetcbs)
 (testreward)(requestvouch)(vouch)(pnishvouched)
-(rankreps)(rankorgreps)(rankrep)(rankcbss)(rankorgcbss)(rankcbs)
+(rankreps)(rankorgreps)(rankrep)(mergerepdlt)(countreps)(rankcbss)(rankorgcbss)(rankcbs)
 (flag)(removeflag)(punish)(pnshvouchers)(evaldemote)(bantree)(delegateflag)(undlgateflag)(mimicflag)
 (refinfo)(unban)
 (testmvouch)
@@ -6,6 +6,7 @@
 #include <eosio/time.hpp>
 #include <eosio/transaction.hpp>
 #include <eosio/singleton.hpp>
+#include <eosio/binary_extension.hpp>
 #include <contracts.hpp>
 #include <utils.hpp>
 #include <tables/config_table.hpp>
@@ -105,16 +106,10 @@ CONTRACT dao : public contract {
 
       ACTION undelegate(const name & delegator, const name & scope);
 
-      ACTION mimicvote(const name & delegatee, const name & delegator, const name & scope, const uint64_t & proposal_id, const double & percentage_used, const name & option, const uint64_t chunksize);
-
-      ACTION voteonbehalf(const name & voter, const uint64_t & proposal_id, const uint64_t & amount, const name & option);
+      ACTION pooldelegs(const name & scope, const uint64_t & start, const uint64_t & chunksize);
 
       ACTION decayvoices();
 
-      ACTION decayvoice(const uint64_t & start, const uint64_t & chunksize);
-
-      ACTION mimicrevert(const name & delegatee, const uint64_t & delegator, const name & scope, const uint64_t & proposal_id, const uint64_t & chunksize);
-
       ACTION updatevoices();
 
       ACTION updatevoice(const uint64_t & start, const name & scope);
@@ -144,6 +139,9 @@ CONTRACT dao : public contract {
 
       ACTION testsetvoice(const name & account, const uint64_t & amount);
 
+      // prints the voice an account can vote with in a scope, decay and delegation pool spends applied
+      ACTION voiceof(const name & account, const name & scope);
+
 
 
       name get_fund_type(const name & fund);
@@ -209,19 +207,33 @@ CONTRACT dao : public contract {
         name account;
         uint64_t amount;
         bool favour;
+        eosio::binary_extension<uint64_t> delegated; // voice of the voter's delegation pools counted with this vote
 
         uint64_t primary_key()const { return account.value; }
       };
       typedef eosio::multi_index<"votes"_n, vote_table> votes_tables;
 
+      // balance is not the voice an account has now, it is stored against the scope's decay factor at write time
+      // voice = floor(balance * voicedecay factor of the scope / decay_factor), rows without decay_factor were
+      // written at factor 1; a delegator's voice is further reduced by what its delegation pool spent, voiceof prints it
       TABLE voice_table {
         name account;
         uint64_t balance;
+        eosio::binary_extension<double> decay_factor;
 
         uint64_t primary_key()const { return account.value; }
       };
       typedef eosio::multi_index<"voice"_n, voice_table> voice_tables;
 
+      // cumulative voice decay of a scope, a decay period only multiplies this factor
+      TABLE voice_decay_table {
+        name scope;
+        double factor;
+
+        uint64_t primary_key()const { return scope.value; }
+      };
+      typedef eosio::multi_index<"voicedecay"_n, voice_decay_table> voice_decay_tables;
+
       TABLE active_table {
         name account;
         uint64_t timestamp;
@@ -244,6 +256,11 @@ CONTRACT dao : public contract {
         name delegatee;
         double weight;
         uint64_t timestamp;
+        eosio::binary_extension<double> pool_factor; // delegatee's pool live factor when the delegator's voice was written
+        eosio::binary_extension<uint64_t> pool_epoch;
+        eosio::binary_extension<uint64_t> written; // when the voice was written into the pool
+        eosio::binary_extension<double> prior_units; // units before that write, for the votes the pool cast before it
+        eosio::binary_extension<uint64_t> prior_epoch;
 
         uint64_t primary_key()const { return delegator.value; }
         uint64_t by_delegatee()const { return delegatee.value; }
@@ -256,6 +273,55 @@ CONTRACT dao : public contract {
         const_mem_fun<delegate_trust_table, uint128_t, &delegate_trust_table::by_delegatee_delegator>>
       > delegate_trust_tables;
 
+      // scoped by voice scope, voice of a delegatee's delegators
+      // a delegatee that delegates itself can not vote, its pool is linked into its delegatee's and counted there,
+      // so a vote only spends the voter's pool, by scaling its factor
+      // live factor = factor * parent's live factor / parent_factor, a linked pool keeps its factor until it is unlinked
+      // a fully spent pool moves to a new epoch, delegators and linked pools of older epochs have no voice left
+      // the dhos scope is not pooled, dho votes are copied to delegators
+      TABLE delegation_pool_table {
+        name delegatee;
+        name parent; // who the delegatee delegates to
+        double units; // voice / (decay factor * live factor) at write time, of the delegators and the linked pools
+        double factor;
+        uint64_t epoch;
+        uint64_t delegators;
+        double parent_factor; // parent's live factor when linked
+        uint64_t parent_epoch;
+        uint64_t linked;
+        uint64_t votes; // votes cast with the pool this cycle, erasepartpts hands them down to the delegators
+        bool nonneutral; // none of them was neutral
+        name credit_from; // next delegator to hand the votes down to
+
+        uint64_t primary_key()const { return delegatee.value; }
+        uint64_t by_votes()const { return votes; }
+      };
+      typedef eosio::multi_index<"delpools"_n, delegation_pool_table,
+        indexed_by<"byvotes"_n,
+        const_mem_fun<delegation_pool_table, uint64_t, &delegation_pool_table::by_votes>>
+      > delegation_pool_tables;
+
+      // scoped by the voting pool's delegatee, what a vote spent from the pool while the proposal is active
+      // lets a delegator who leaves take its share of the vote with it
+      TABLE pool_spend_table {
+        uint64_t proposal_id;
+        uint64_t epoch; // pool epoch the vote spent
+        double spent_per_unit; // pool factor * decay factor * percentage used at vote time
+        uint64_t spent; // voice still counted in the voter's vote
+        uint64_t timestamp;
+
+        uint64_t primary_key()const { return proposal_id; }
+      };
+      typedef eosio::multi_index<"poolspends"_n, pool_spend_table> pool_spend_tables;
+
+      // where a pool sits below the pool that votes for it, after refresh_pool
+      struct pool_link {
+        name root;
+        double live_factor;
+        double root_ratio; // units of the pool in units of the root pool
+        uint64_t linked; // latest time a pool of the chain was linked
+      };
+
       TABLE voted_proposals_table { // scoped by cycle
         uint64_t proposal_id;
 
@@ -361,21 +427,41 @@ CONTRACT dao : public contract {
 
     void set_voice(const name & user, const uint64_t & amount, const name & scope);
     double voice_change(const name & user, const uint64_t & amount, const bool & reduce, const name & scope);
+    double voice_decay_factor(const name & scope);
+    uint64_t voice_balance(const voice_table & v, const double & factor);
+    void write_voice(voice_table & v, const uint64_t & amount, const double & factor);
+    double pool_units(const uint64_t & balance, const double & decay_factor, const double & pool_factor);
+    uint64_t get_voice(const voice_table & v, const name & scope);
+    void store_voice(const name & user, const name & scope, const uint64_t & amount);
+    void decay_voice();
     void erase_voice(const name & user);
     void recover_voice(const name & account);
     uint64_t calculate_decay(const uint64_t & voice_amount);
     bool is_trust_delegated(const name & account, const name & scope);
-    void send_mimic_delegatee_vote(const name & delegatee, const name & scope, const uint64_t & proposal_id, const double & percentage_used, const name & option);
+    void join_pool(const name & delegator, const name & delegatee, const name & scope);
+    void leave_pool(const name & delegator, const name & scope);
+    double pool_live_factor(const delegation_pool_table & pool, const name & scope);
+    pool_link refresh_pool(delegation_pool_tables & pools, const name & delegatee);
+    void add_pool_units(delegation_pool_tables & pools, const name & delegatee, const double & units);
+    void link_pool(delegation_pool_tables & pools, const name & delegatee, const name & parent);
+    void unlink_pool(delegation_pool_tables & pools, const name & delegatee);
+    void write_pool_share(delegate_trust_table & item, const double & live_factor, const uint64_t & epoch, const double & prior_units, const uint64_t & prior_epoch);
+    uint64_t spend_pool(const name & delegatee, const name & scope, const uint64_t & proposal_id, const double & percentage, const name & option);
+    void settle_pool_spends(delegation_pool_tables & pools, const delegate_trust_table & d, const pool_link & link, const name & scope);
+    void clear_pool_spends(const name & delegatee, const name & scope);
+    uint64_t credit_pools(const uint64_t & batch_size);
+    name active_proposal_scope(const uint64_t & proposal_id);
     void add_voted_proposal(const uint64_t & proposal_id);
     void increase_voice_cast(const uint64_t & amount, const name & option, const name & prop_type);
     void add_voice_cast(const uint64_t & cycle, const uint64_t & voice_cast, const name & type);
 
     // void check_citizen(const name & account);
-    void vote_aux(const name & voter, const uint64_t & referendum_id, const uint64_t & amount, const name & option, const bool & is_delegated);
+    void vote_aux(const name & voter, const uint64_t & referendum_id, const uint64_t & amount, const name & option);
     bool revert_vote(const name & voter, const uint64_t & referendum_id);
+    void add_participant(const name & voter, const name & option, const double & rep_multiplier, const uint64_t & count = 1);
+    void add_active(const name & voter);
     // void check_attributes(const std::map<std::string, VariantValue> & args);
     uint64_t active_cutoff_date();
-    bool has_delegates(const name & voter, const name & scope);
     bool is_active(const name & account, const uint64_t & cutoff_date);
     
     void init_cycle_new_stats();
@@ -395,13 +481,13 @@ extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
           (reset)(initcycle)
           (create)(update)(cancel)(onperiod)(evaluate)(callback)
           (changetrust)(addactive)
-          (favour)(against)(neutral)(revertvote)(voteonbehalf)
-          (delegate)(undelegate)(mimicvote)(mimicrevert)
-          (decayvoices)(decayvoice)
+          (favour)(against)(neutral)(revertvote)
+          (delegate)(undelegate)(pooldelegs)
+          (decayvoices)
           (updatevoices)(updatevoice)
           (erasepartpts)
           (createdho)(removedho)(removedhovts)(votedhos)(dhomimicvote)(dhocleanvts)(dhocleanvote)(dhocalcdists)
-          (testsetvoice)(deletescope)(addvoice)
+          (testsetvoice)(voiceof)(deletescope)(addvoice)
         )
       }
   }
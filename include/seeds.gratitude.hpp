@@ -2,6 +2,9 @@
 #include <eosio/asset.hpp>
 #include <eosio/transaction.hpp>
 #include <eosio/singleton.hpp>
+#include <eosio/binary_extension.hpp>
+#include <map>
+#include <limits>
 #include <seeds.token.hpp>
 #include <contracts.hpp>
 #include <utils.hpp>
@@ -23,8 +26,10 @@ CONTRACT gratitude : public contract {
       : contract(receiver, code, ds),
         balances(receiver, receiver.value),
         acks(receiver, receiver.value),
+        acktotals(receiver, receiver.value),
         stats(receiver, receiver.value),
         stats2(receiver, receiver.value),
+        roundstatus(receiver, receiver.value),
         sizes(receiver, receiver.value),
         users(contracts::accounts, contracts::accounts.value),
         config(contracts::settings, contracts::settings.value)
@@ -44,12 +49,15 @@ CONTRACT gratitude : public contract {
     // Called after all acks are calculated
     ACTION payround(uint64_t start, uint64_t usable_bal);
 
-    // Recursivelly calculate acks
+    // Calculate acks for a batch of donors, then continue with the next batch
     ACTION calcacks(uint64_t start);
 
     // For stats migration
     ACTION migratestats();
 
+    // Moves acks stored as receiver lists into ack counts
+    ACTION migrateacks();
+
     // Calculate acks for testing
     ACTION testacks();
 
@@ -59,14 +67,31 @@ CONTRACT gratitude : public contract {
 
   private:
 
+    // gratitude moved by settled acks, applied with one write per account
+    struct gratz_delta {
+      int64_t remaining = 0;
+      int64_t received = 0;
+    };
+
+    struct ack_settlement {
+      std::map<name, gratz_delta> deltas;
+      uint64_t num_transfers = 0;
+      uint64_t volume = 0;
+    };
+
     void check_user(name account);
     void init_balances(name account);
     void reset_balances(name account);
-    void _calc_acks(name account);
+    uint64_t _calc_acks(name donor, uint64_t num_acks, uint64_t from, uint64_t & share, uint64_t & budget, ack_settlement & settlement);
+    void add_acks(name donor, name receiver, uint64_t count);
+    void clear_ack_counts(name donor);
+    void flush_acks(const ack_settlement & settlement);
+    void set_round_status(name stage, uint64_t cursor, uint64_t processed, uint64_t receiver = 0, uint64_t share = 0);
     void add_gratitude(name account, asset quantity);
     void sub_gratitude(name account, asset quantity);
     uint64_t get_current_volume();
     void update_stats(name from, name to, asset quantity);
+    void add_round_volume(uint64_t num_transfers, uint64_t volume);
     void _transfer(name beneficiary, asset quantity, string memo);
     uint64_t config_get(name key);
     void size_change(name id, int delta);
@@ -100,6 +125,7 @@ CONTRACT gratitude : public contract {
       uint64_t by_received() const { return received.amount; }
     };
 
+    // Legacy acks, only read by migrateacks
     TABLE acks_table {
       name donor;
       vector<name> receivers; // can have duplicates
@@ -107,6 +133,21 @@ CONTRACT gratitude : public contract {
       uint64_t primary_key() const { return donor.value; }
     };
 
+    TABLE ack_total_table {
+      name donor;
+      uint64_t total; // acks given this round, duplicates included
+
+      uint64_t primary_key() const { return donor.value; }
+    };
+
+    // SCOPE by donor
+    TABLE ack_count_table {
+      name receiver;
+      uint64_t count;
+
+      uint64_t primary_key() const { return receiver.value; }
+    };
+
     TABLE stats_table {
       uint64_t round_id;
       uint64_t num_transfers;
@@ -125,6 +166,20 @@ CONTRACT gratitude : public contract {
       uint64_t primary_key() const { return round_id; }
     };
 
+    // progress of the round being closed
+    // stage is idle, calcacks or payround, cursor is where the next batch starts
+    // receiver is where the cursor donor's ack counts resume when a batch ended inside them,
+    // share is the per-ack amount fixed by the donor's first part
+    TABLE round_status_table {
+      uint64_t round_id = 0;
+      name stage = "idle"_n;
+      uint64_t cursor = 0;
+      uint64_t processed = 0;
+      uint64_t timestamp = 0;
+      eosio::binary_extension<uint64_t> receiver;
+      eosio::binary_extension<uint64_t> share;
+    };
+
     typedef eosio::multi_index<"balances"_n, balance_table,
         indexed_by<"byreceived"_n,
         const_mem_fun<balance_table, uint64_t, &balance_table::by_received>>
@@ -132,14 +187,23 @@ CONTRACT gratitude : public contract {
 
     typedef eosio::multi_index<"acks"_n, acks_table> acks_tables;
 
+    typedef eosio::multi_index<"acktotals"_n, ack_total_table> ack_total_tables;
+
+    typedef eosio::multi_index<"ackcounts"_n, ack_count_table> ack_count_tables;
+
     typedef eosio::multi_index<"stats"_n, stats_table> stats_tables;
 
     typedef eosio::multi_index<"stats2"_n, stats_table_v2> stats_tables_v2;
 
+    typedef eosio::singleton<"roundstatus"_n, round_status_table> round_status_tables;
+    typedef eosio::multi_index<"roundstatus"_n, round_status_table> dump_for_round_status;
+
     balance_tables balances;
     acks_tables acks;
+    ack_total_tables acktotals;
     stats_tables stats;
     stats_tables_v2 stats2;
+    round_status_tables roundstatus;
 
     // External tables
     user_tables users;
@@ -166,6 +230,7 @@ extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
           (calcacks)
           (testacks)
           (migratestats)
+          (migrateacks)
         )
       }
   }
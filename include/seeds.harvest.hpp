@@ -15,6 +15,8 @@
 #include <tables/config_float_table.hpp>
 #include <tables/cbs_table.hpp>
 #include <tables/cspoints_table.hpp>
+#include <tables/trx_window_table.hpp>
+#include <tables/rank_bounds_table.hpp>
 #include <tables/organization_table.hpp>
 #include <eosio/singleton.hpp>
 #include <tables/dho_share_table.hpp>
@@ -42,6 +44,9 @@ CONTRACT harvest : public contract {
         monthlyqevs(receiver, receiver.value),
         mintrate(receiver, receiver.value),
         regioncstemp(receiver, receiver.value),
+        csdirty(receiver, receiver.value),
+        rankbounds(receiver, receiver.value),
+        rankpasses(receiver, receiver.value),
         config(contracts::settings, contracts::settings.value),
         configfloat(contracts::settings, contracts::settings.value),
         users(contracts::accounts, contracts::accounts.value),
@@ -68,25 +73,29 @@ CONTRACT harvest : public contract {
     ACTION runharvest();
 
     ACTION rankplanteds();
-    ACTION rankplanted(uint128_t start_val, uint64_t chunk, uint64_t chunksize);
+    ACTION rankplanted(uint128_t start_val, uint64_t current, uint64_t chunksize);
 
     ACTION calctrxpts(); // calculate transaction points // 24h interval
     ACTION calctrxpt(uint64_t start_val, uint64_t chunk, uint64_t chunksize);
 
     ACTION ranktxs(); // rank transaction score // 1h interval
     ACTION rankorgtxs(); // rank org transaction score
-    ACTION ranktx(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name table);
+    ACTION ranktx(uint64_t start_val, uint64_t start_id, uint64_t current, uint64_t chunksize, name table);
 
     ACTION calccss(); // calculate contribution points // 1h inteval
     ACTION updatecs(name account); 
     ACTION calccs(uint64_t start_val, uint64_t chunk, uint64_t chunksize);
+    ACTION calcdirtycs(uint64_t chunksize); // recalculate contribution points of dirty accounts only
+    ACTION markdirty(std::vector<name> accounts);
 
     ACTION rankcss(); // rank contribution score //
     ACTION rankorgcss();
-    ACTION rankcs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name cs_scope);
+    ACTION rankcs(uint64_t start_val, uint64_t start_id, uint64_t current, uint64_t chunksize, name cs_scope);
+    ACTION mergecsdlt(name cs_scope); // apply contribution points scored while rankcs was in flight
 
     ACTION rankrgncss();
-    ACTION rankrgncs(uint64_t start, uint64_t chunk, uint64_t chunksize);
+    ACTION sumrgncs(uint64_t start, uint64_t chunksize);
+    ACTION rankrgncs(uint64_t start, uint64_t current, uint64_t chunksize);
 
     ACTION updatetxpt(name account);
     ACTION calctotal(uint64_t startval);
@@ -95,6 +104,7 @@ CONTRACT harvest : public contract {
 
     ACTION testclaim(name from, uint64_t request_id, uint64_t sec_rewind);
     ACTION testupdatecs(name account, uint64_t contribution_score);
+    ACTION testaccrue(name cs_scope, asset amount);
     ACTION testcspoints(name account, uint64_t contribution_points);
     
     ACTION setorgtxpt(name organization, uint64_t tx_points);
@@ -104,6 +114,8 @@ CONTRACT harvest : public contract {
     ACTION testcalcmqev(uint64_t day, uint64_t total_volume, uint64_t circulating);
     ACTION calcmintrate();
 
+    ACTION claimharvest(name account);
+    // DEPRECATED - users and orgs claim their harvest, kept for distributions scheduled before the upgrade
     ACTION disthvstusrs(uint64_t start, uint64_t chunksize, asset total_amount);
     ACTION disthvstorgs(uint64_t start, uint64_t chunksize, asset total_amount);
     ACTION disthvstrgns(uint64_t start, uint64_t chunksize, asset total_amount);
@@ -130,6 +142,8 @@ CONTRACT harvest : public contract {
     name cs_size = "cs.sz"_n;
     name sum_rank_users = "usr.rnk.sz"_n;
     name sum_rank_orgs = "org.rnk.sz"_n;
+    name claim_rank_users = "usr.clm.sz"_n; // sum of the ranks in hrvstclaims, what accrual is shared among
+    name claim_rank_orgs = "org.clm.sz"_n;
     name sum_rank_rgns = "rgn.rnk.sz"_n;
     name cs_rgn_size = "rgn.cs.sz"_n;
     name cs_org_size = "org.cs.sz"_n;
@@ -152,7 +166,14 @@ CONTRACT harvest : public contract {
     void sub_planted(name account, asset quantity);
     void change_total(bool add, asset quantity);
     void calc_contribution_score(name account, name type);
-    void add_cs_to_region(name account, uint32_t points);
+    void set_contribution_points(name account, name cs_scope, uint64_t contribution_points);
+    void add_cs_to_region(name region, uint32_t points);
+    void mark_dirty(name account);
+    uint64_t resolve_rank(name code, name ranking, uint128_t key, uint64_t stored_rank);
+    uint64_t claim_rank(name account, name cs_scope, uint64_t rank);
+    bool settle_claim(name account, name cs_scope, uint64_t rank);
+    void accrue_harvest(name cs_scope, asset amount);
+    void pay_claim(name account);
 
     void size_change(name id, int delta);
     void size_set(name id, uint64_t newsize);
@@ -262,10 +283,47 @@ CONTRACT harvest : public contract {
 
     DEFINE_CS_POINTS_TABLE_MULTI_INDEX
 
+    DEFINE_CS_DELTA_TABLE
+
+    DEFINE_CS_DELTA_TABLE_MULTI_INDEX
+
     DEFINE_SIZE_TABLE
 
     DEFINE_SIZE_TABLE_MULTI_INDEX
 
+    DEFINE_RANK_BOUNDS_TABLE
+
+    DEFINE_RANK_BOUNDS_TABLE_MULTI_INDEX
+
+    DEFINE_RANK_PASS_TABLE
+
+    DEFINE_RANK_PASS_TABLE_MULTI_INDEX
+
+    // harvest for users and organizations is pulled instead of pushed
+    // every harvest adds amount / sum of ranks to per_rank of its pool, once
+    TABLE claim_pool_table {
+      name pool; // cs scope
+      double per_rank;
+      uint64_t outstanding; // accrued and not paid out yet
+
+      uint64_t primary_key() const { return pool.value; }
+    };
+
+    typedef eosio::multi_index<"claimpools"_n, claim_pool_table> claim_pool_tables;
+
+    // SCOPE by cs scope
+    // an account is owed rank * (per_rank - snapshot), settled into unclaimed whenever its rank changes
+    TABLE harvest_claim_table {
+      name account;
+      uint64_t rank;
+      double snapshot;
+      double unclaimed;
+
+      uint64_t primary_key() const { return account.value; }
+    };
+
+    typedef eosio::multi_index<"hrvstclaims"_n, harvest_claim_table> harvest_claim_tables;
+
     // DEPRECATED - REMOVE ONCE APPS ARE UPDATED // 
     DEFINE_HARVEST_TABLE
     
@@ -380,6 +438,10 @@ CONTRACT harvest : public contract {
       const_mem_fun<transaction_points_table, uint64_t, &transaction_points_table::by_points>>
     > transaction_points_tables;
 
+    DEFINE_TRX_WINDOW_TABLE
+
+    DEFINE_TRX_WINDOW_TABLE_MULTI_INDEX
+
     typedef eosio::multi_index<"qevs"_n, qev_table,
       indexed_by<"byvolume"_n,
       const_mem_fun<qev_table, uint64_t, &qev_table::by_volume>>
@@ -398,6 +460,15 @@ CONTRACT harvest : public contract {
       const_mem_fun<region_cs_temporal_table, uint64_t, &region_cs_temporal_table::by_cs_points>>
     > region_cs_temporal_tables;
 
+    // accounts with a changed rank input since their contribution points were last calculated
+    TABLE cs_dirty_table {
+      name account;
+
+      uint64_t primary_key() const { return account.value; }
+    };
+
+    typedef eosio::multi_index<"csdirty"_n, cs_dirty_table> cs_dirty_tables;
+
     TABLE mint_rate_table {
       uint64_t id;
       int64_t mint_rate;
@@ -439,6 +510,12 @@ CONTRACT harvest : public contract {
     monthly_qev_tables monthlyqevs;
     mint_rate_tables mintrate;
     region_cs_temporal_tables regioncstemp;
+    cs_dirty_tables csdirty;
+    rank_bounds_tables rankbounds;
+    rank_pass_tables rankpasses;
+
+    // boundaries read once per action
+    std::map<name, utils::rank_resolver> rank_resolvers;
 
     // DEPRECATED - remove
     typedef eosio::multi_index<"harvest"_n, harvest_table> harvest_tables;
@@ -467,12 +544,12 @@ extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
           EOSIO_DISPATCH_HELPER(harvest, 
           (payforcpu)(reset)
           (unplant)(claimrefund)(cancelrefund)(sow)
-          (ranktx)(calctrxpt)(calctrxpts)(rankplanted)(rankplanteds)(calccss)(calccs)(rankcss)(rankorgcss)(rankcs)(ranktxs)(rankorgtxs)(updatecs)(rankrgncss)(rankrgncs)
+          (ranktx)(calctrxpt)(calctrxpts)(rankplanted)(rankplanteds)(calccss)(calccs)(calcdirtycs)(markdirty)(rankcss)(rankorgcss)(rankcs)(mergecsdlt)(ranktxs)(rankorgtxs)(updatecs)(rankrgncss)(sumrgncs)(rankrgncs)
           (updatetxpt)(calctotal)
           (setorgtxpt)
-          (testclaim)(testupdatecs)(testcalcmqev)(testcspoints)
+          (testclaim)(testupdatecs)(testaccrue)(testcalcmqev)(testcspoints)
           (calcmqevs)(calcmintrate)
-          (runharvest)(disthvstusrs)(disthvstorgs)(disthvstrgns)(disthvstdhos)
+          (runharvest)(claimharvest)(disthvstusrs)(disthvstorgs)(disthvstrgns)(disthvstdhos)
           (logaction)(lgcalcmqevs)(lgrunhrvst)(lgcalmntrte)(resetlogs)(resetlgroups)
           (ldsthvstusrs)(ldsthvstorgs)(ldsthvstrgns)
         )
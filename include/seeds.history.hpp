@@ -7,11 +7,13 @@
 #include <tables/config_float_table.hpp>
 #include <tables/size_table.hpp>
 #include <tables/organization_table.hpp>
+#include <tables/trx_window_table.hpp>
 
 #include <contracts.hpp>
 #include <tables/user_table.hpp>
 
 #include <cmath>
+#include <map>
 
 using namespace eosio;
 using std::string;
@@ -50,6 +52,10 @@ CONTRACT history : public contract {
 
         ACTION savepoints(uint64_t id, uint64_t timestamp);
 
+        ACTION processtrxs(uint64_t chunksize);
+
+        ACTION kicktrxs();
+
         ACTION sendtrxcbp(uint64_t deferred_id, name from, name to);
 
         ACTION updatetxpt(uint64_t deferred_id, name from);
@@ -86,18 +92,33 @@ CONTRACT history : public contract {
       uint64_t get_size(name id);
       void fire_orgtx_calc(name organization, uint128_t start_val, uint64_t chunksize, uint64_t running_total);
       bool clean_old_tx(name org, uint64_t chunksize);
+      struct trx_points {
+        name from;
+        name to;
+        bool to_is_organization;
+        int64_t from_points;
+        int64_t to_points;
+        int64_t qualifying_volume;
+      };
+
+      bool eval_points(uint64_t id, uint64_t day, trx_points & points);
       void save_from_metrics (name from, int64_t & from_points, int64_t & qualifying_volume, uint64_t & day);
-      void send_update_txpoints (name from);
+      void add_trx_points (name account, int64_t points, uint64_t day);
+      void add_qev (uint64_t scope, int64_t qualifying_volume, uint64_t day);
+      void send_process_trxs ();
+      bool process_trxs_stalled (uint64_t now);
+      void cbp_rewards (name from, name to);
+      bool has_cbp_rewards (name from, name to);
+      void send_trx_cbp (name from, name to);
+      void add_window_points (name account, int64_t points, uint64_t day);
       double config_float_get(name key);
       double get_transaction_multiplier(name account, name other);
-      void send_trx_cbp_reward_action(name from, name to);
       void send_add_cbs(name account, int points);
       void trx_cbp_reward(name account, name key);
       
       // migration functions
       void save_migration_user_transaction(name from, name to, asset quantity, uint64_t timestamp);
       void adjust_transactions(uint64_t id, uint64_t timestamp);
-      uint64_t get_deferred_id();
 
       TABLE citizen_table {
         uint64_t id;
@@ -223,6 +244,25 @@ CONTRACT history : public contract {
         uint64_t primary_key() const { return account.value; }
       };
 
+      // transfers saved by trxentry, processed in batches by processtrxs
+      TABLE pending_trx_table {
+        uint64_t id;
+        uint64_t transaction_id;
+        uint64_t timestamp;
+        name from;
+        name to;
+        uint64_t volume;
+        bool from_is_organization;
+        bool to_is_organization;
+
+        uint64_t primary_key() const { return id; }
+      };
+
+      // state of the pending transfers processor
+      TABLE pending_trx_status_table {
+        uint64_t last_sent = 0; // when processtrxs was last scheduled
+      };
+
       TABLE processed_trx_table {
         uint64_t id;
         uint64_t transaction_id;
@@ -304,6 +344,11 @@ CONTRACT history : public contract {
 
       typedef eosio::multi_index<"totals"_n, totals_table> totals_tables;
 
+      typedef eosio::multi_index<"pendingtrxs"_n, pending_trx_table> pending_trx_tables;
+
+      typedef singleton<"pendingstat"_n, pending_trx_status_table> pending_trx_status_tables;
+      typedef eosio::multi_index<"pendingstat"_n, pending_trx_status_table> dump_for_pending_trx_status;
+
       typedef eosio::multi_index<"ptrx"_n, processed_trx_table,
         indexed_by<"bytimestmpid"_n,
         const_mem_fun<processed_trx_table, uint128_t, &processed_trx_table::by_timestamp_id>>
@@ -326,6 +371,10 @@ CONTRACT history : public contract {
 
       DEFINE_SIZE_TABLE_MULTI_INDEX
 
+      DEFINE_TRX_WINDOW_TABLE
+
+      DEFINE_TRX_WINDOW_TABLE_MULTI_INDEX
+
       user_tables users;
       resident_tables residents;
       citizen_tables citizens;
@@ -342,7 +391,7 @@ EOSIO_DISPATCH(history,
   (addcitizen)(addresident)
   (updatestatus)
   (numtrx)
-  (deldailytrx)(savepoints)
+  (deldailytrx)(savepoints)(processtrxs)(kicktrxs)
   (testtotalqev)
   (sendtrxcbp)(updatetxpt)
   (cleanptrxs)
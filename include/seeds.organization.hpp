@@ -1,12 +1,14 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <eosio/transaction.hpp>
+#include <eosio/binary_extension.hpp>
 #include <contracts.hpp>
 #include <utils.hpp>
 #include <tables.hpp>
 #include <tables/config_table.hpp>
 #include <tables/rep_table.hpp>
 #include <tables/organization_table.hpp>
+#include <tables/rank_bounds_table.hpp>
 #include <cmath> 
 
 using namespace eosio;
@@ -26,6 +28,8 @@ CONTRACT organization : public contract {
               cbsorgs(receiver, receiver.value),
               sizes(receiver, receiver.value),
               avgvotes(receiver, receiver.value),
+              rankbounds(receiver, receiver.value),
+              rankpasses(receiver, receiver.value),
               refs(contracts::accounts, contracts::accounts.value),
               users(contracts::accounts, contracts::accounts.value),
               balances(contracts::harvest, contracts::harvest.value),
@@ -69,11 +73,11 @@ CONTRACT organization : public contract {
 
         ACTION rankappuses();
 
-        ACTION rankappuse(uint128_t start, uint64_t chunk, uint64_t chunksize);
+        ACTION rankappuse(uint128_t start, uint64_t current, uint64_t chunksize);
 
         ACTION rankregens();
 
-        ACTION rankregen(uint64_t start, uint64_t chunk, uint64_t chunksize);
+        ACTION rankregen(uint64_t start, uint64_t start_id, uint64_t chunk, uint64_t chunksize);
 
         ACTION makethrivble(name organization);
 
@@ -224,6 +228,14 @@ CONTRACT organization : public contract {
 
         DEFINE_REP_TABLE_MULTI_INDEX
 
+        DEFINE_RANK_BOUNDS_TABLE
+
+        DEFINE_RANK_BOUNDS_TABLE_MULTI_INDEX
+
+        DEFINE_RANK_PASS_TABLE
+
+        DEFINE_RANK_PASS_TABLE_MULTI_INDEX
+
 
         TABLE totals_table {
             name account;
@@ -244,6 +256,9 @@ CONTRACT organization : public contract {
             string app_long_name;
             bool is_banned;
             uint64_t number_of_uses;
+            eosio::binary_extension<int64_t> trailing_points; // sum of daus_totals days from window_start on
+            eosio::binary_extension<uint64_t> trailing_users;
+            eosio::binary_extension<uint64_t> window_start; // first day still counted, earlier days have been expired
 
             uint64_t primary_key() const { return app_name.value; }
             uint64_t by_org() const { return org_name.value; }
@@ -402,6 +417,8 @@ CONTRACT organization : public contract {
         balance_tables balances;
         ref_tables refs;
         avg_vote_tables avgvotes;
+        rank_bounds_tables rankbounds;
+        rank_pass_tables rankpasses;
         totals_tables totals;
         planted_tables planted;
 
@@ -423,7 +440,7 @@ CONTRACT organization : public contract {
         void check_referrals(name organization, uint64_t min_visitors_invited, uint64_t min_residents_invited);
         void check_status_requirements(name organization, uint64_t status);
         void history_update_org_status(name organization, uint64_t status);
-        void calculate_trailing_app_use(const name & appname, const uint64_t & cutoff, const int64_t & threshold);
+        void calculate_trailing_app_use(app_tables::const_iterator & appitr, const uint64_t & cutoff, const int64_t & threshold);
 };
 
 
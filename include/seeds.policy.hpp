@@ -1,5 +1,6 @@
 #include <eosio/eosio.hpp>
 #include <contracts.hpp>
+#include <utils.hpp>
 
 using namespace eosio;
 using std::string;
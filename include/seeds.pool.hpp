@@ -1,6 +1,8 @@
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <eosio/transaction.hpp>
+#include <eosio/singleton.hpp>
+#include <eosio/binary_extension.hpp>
 #include <contracts.hpp>
 #include <utils.hpp>
 #include <tables/config_table.hpp>
@@ -18,6 +20,7 @@ CONTRACT pool : public contract {
       : contract(receiver, code, ds),
         balances(receiver, receiver.value),
         sizes(receiver, receiver.value),
+        payoutindex(receiver, receiver.value),
         config(contracts::settings, contracts::settings.value)
         {}
 
@@ -27,14 +30,18 @@ CONTRACT pool : public contract {
 
     ACTION payouts(asset quantity);
 
-    ACTION payout(asset quantity, uint64_t start, uint64_t chunksize, int64_t old_total_balance);
+    ACTION claim(name account);
 
 
   private:
 
     const name total_balance_size = "total.sz"_n;
+    const name stored_balance_size = "stored.sz"_n; // sum of the balance rows, what the pool holds
+    const name accounts_size = "accounts.sz"_n;
+    const name pending_size = "pending.sz"_n; // accounts that have not realized the last payout
 
     void send_transfer(const name & to, const asset & quantity, const string & memo);
+    void realize(const name & account);
 
     DEFINE_CONFIG_TABLE
     DEFINE_CONFIG_TABLE_MULTI_INDEX
@@ -46,17 +53,32 @@ CONTRACT pool : public contract {
     DEFINE_SIZE_CHANGE
     DEFINE_SIZE_SET
 
+    // balance is what the account held when it last realized its payouts
+    // the current balance is balance * payout_index.factor / factor, payouts of a past epoch left nothing
     TABLE balances_table {
       name account;
       asset balance;
+      eosio::binary_extension<double> factor;
+      eosio::binary_extension<uint64_t> epoch;
 
       uint64_t primary_key () const { return account.value; }
     };
 
     typedef eosio::multi_index<"balances"_n, balances_table> balances_tables;
 
+    // every payout of quantity out of a total balance scales factor by (total - quantity) / total
+    // paying out the whole pool starts a new epoch with factor 1
+    TABLE payout_index_table {
+      double factor = 1.0;
+      uint64_t epoch = 0;
+    };
+
+    typedef eosio::singleton<"payoutindex"_n, payout_index_table> payout_index_tables;
+    typedef eosio::multi_index<"payoutindex"_n, payout_index_table> dump_for_payout_index;
+
     balances_tables balances;
     size_tables sizes;
+    payout_index_tables payoutindex;
 
     // external tables
     config_tables config;
@@ -70,7 +92,7 @@ extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
       switch (action) {
         EOSIO_DISPATCH_HELPER(pool, 
           (reset)
-          (payouts)(payout)
+          (payouts)(claim)
         )
       }
   }
@@ -2,6 +2,7 @@
 #include <eosio/eosio.hpp>
 #include <eosio/transaction.hpp>
 #include <eosio/singleton.hpp>
+#include <eosio/binary_extension.hpp>
 #include <seeds.token.hpp>
 #include <contracts.hpp>
 #include <utils.hpp>
@@ -11,6 +12,7 @@
 #include <tables/ban_table.hpp>
 #include <tables/moon_phases_table.hpp>
 #include <vector>
+#include <map>
 #include <cmath>
 
 using namespace eosio;
@@ -64,9 +66,6 @@ CONTRACT proposals : public contract {
       ACTION neutral(name user, uint64_t id);
 
       ACTION revertvote(name user, uint64_t id);
-      ACTION mimicrevert(name delegatee, uint64_t delegator, name scope, uint64_t proposal_id, uint64_t chunksize);
-
-      ACTION voteonbehalf(name voter, uint64_t id, uint64_t amount, name option);
 
       ACTION erasepartpts(uint64_t active_proposals);
 
@@ -74,6 +73,8 @@ CONTRACT proposals : public contract {
 
       ACTION evalproposal(uint64_t proposal_id, uint64_t prop_cycle);
 
+      ACTION evalprops();
+
       ACTION updatevoices();
 
       ACTION updatevoice(uint64_t start);
@@ -86,8 +87,6 @@ CONTRACT proposals : public contract {
 
       ACTION decayvoices();
 
-      ACTION decayvoice(uint64_t start, uint64_t chunksize);
-
       ACTION testquorum(uint64_t total_proposals);
       ACTION testvn(uint64_t total_voice, uint64_t num_proposals);
 
@@ -100,16 +99,20 @@ CONTRACT proposals : public contract {
 
       ACTION delegate(name delegator, name delegatee, name scope);
 
-      ACTION mimicvote(name delegatee, name delegator, name scope, uint64_t proposal_id, double percentage_used, name option, uint64_t chunksize);
-
       ACTION undelegate(name delegator, name scope);
 
+      // moves delegations made before delegation pools existed into their delegatee's pool
+      ACTION pooldelegs(name scope, uint64_t start, uint64_t chunksize);
+
       ACTION questvote(name user, uint64_t amount, bool reduce, name scope);
 
       ACTION addcampaign(uint64_t proposal_id, uint64_t campaign_id);
 
       ACTION checkprop(uint64_t proposal_id, string message);
 
+      // prints the voice an account can vote with in a scope, decay and delegation pool spends applied
+      ACTION voiceof(name account, name scope);
+
       ACTION doneprop(uint64_t proposal_id);
 
 
@@ -193,8 +196,10 @@ CONTRACT proposals : public contract {
       void send_to_escrow(name fromfund, name recipient, asset quantity, string memo);
       void burn(asset quantity);
       void update_voice_table();
-      void vote_aux(name voter, uint64_t id, uint64_t amount, name option, bool is_new, bool is_delegated);
-      void revertvote_delegate(name voter, uint64_t id);
+      void vote_aux(name voter, uint64_t id, uint64_t amount, name option, bool is_new);
+      void add_participant(name voter, name option, double rep_multiplier, uint64_t count = 1);
+      void add_active(name voter);
+      uint64_t credit_pools(uint64_t batch_size);
 
       void change_rep(name beneficiary, bool passed);
       uint64_t get_size(name id);
@@ -207,19 +212,21 @@ CONTRACT proposals : public contract {
       uint64_t calculate_decay(uint64_t voice);
       name get_type (const name & fund);
       name get_scope(name fund);
-      bool has_delegates(name voter, name scope);
 
       double voice_change (name user, uint64_t amount, bool reduce, name scope);
       void set_voice (name user, uint64_t amount, name scope);
+      void decay_voice ();
       void erase_voice (name user);
       void check_percentages(std::vector<uint64_t> pay_percentages);
       asset get_payout_amount(std::vector<uint64_t> pay_percentages, uint64_t age, asset total_amount, asset current_payout);
       void check_voice_scope(name scope);
       bool is_trust_delegated(name account, name scope);
-      void send_mimic_delegatee_vote(name delegatee, name scope, uint64_t proposal_id, double percentage_used, name option);
       uint64_t active_cutoff_date();
       bool is_active(name account, uint64_t cutoff_date);
-      void send_vote_on_behalf(name voter, uint64_t id, uint64_t amount, name option);
+      void join_pool(name delegator, name delegatee, name scope);
+      void leave_pool(name delegator, name scope);
+      uint64_t spend_pool(name delegatee, name scope, uint64_t proposal_id, double percentage, name option);
+      void clear_pool_spends(name delegatee, name scope);
 
       void increase_voice_cast(uint64_t amount, name option, name prop_type);
       uint64_t calc_quorum_base(uint64_t propcycle);
@@ -229,7 +236,9 @@ CONTRACT proposals : public contract {
       void send_create_invite(name origin_account, name owner, asset max_amount_per_invite, asset planted, name reward_owner, asset reward, asset total_amount, uint64_t proposal_id);
       void send_return_funds_campaign(uint64_t campaign_id);
 
-      void send_eval_prop(uint64_t proposal_id, uint64_t prop_cycle);
+      void send_eval_props();
+      bool can_pay(const std::map<name, int64_t> & outflows);
+      void skip_eval(uint64_t proposal_id, uint64_t prop_cycle, string reason);
       void init_cycle_new_stats();
       void update_cycle_stats_from_proposal(uint64_t proposal_id, name type, name array);
       void send_punish(name account);
@@ -326,6 +335,7 @@ CONTRACT proposals : public contract {
           name account;
           uint64_t amount;
           bool favour;
+          eosio::binary_extension<uint64_t> delegated; // voice of the voter's delegation pools counted with this vote
           uint64_t primary_key()const { return account.value; }
       };
 
@@ -337,12 +347,28 @@ CONTRACT proposals : public contract {
         uint64_t primary_key()const { return account.value; }
       };
 
+      // balance is stored against the scope's decay factor at write time
+      // balance is not the voice an account has now, it is stored against the scope's decay factor at write time
+      // voice = floor(balance * voicedecay factor of the scope / decay_factor), rows without decay_factor were
+      // written at factor 1; a delegator's voice is further reduced by what its delegation pool spent, voiceof prints it
       TABLE voice_table {
         name account;
         uint64_t balance;
+        eosio::binary_extension<double> decay_factor;
         uint64_t primary_key()const { return account.value; }
       };
 
+      // cumulative voice decay of a scope, a decay period only multiplies this factor
+      TABLE voice_decay_table {
+        name scope;
+        double factor;
+        uint64_t primary_key()const { return scope.value; }
+      };
+
+      double voice_decay_factor (name scope);
+      uint64_t voice_balance (const voice_table & v, double factor);
+      void write_voice (voice_table & v, uint64_t amount, double factor);
+
       TABLE last_proposal_table {
         name account;
         uint64_t proposal_id;
@@ -355,6 +381,25 @@ CONTRACT proposals : public contract {
         uint64_t t_voicedecay; // last time voice was decayed
       };
 
+      // proposals onperiod left to evaluate, walked in batches through the bystageid index
+      TABLE eval_queue_table {
+        uint64_t prop_cycle; // cycle the proposals are evaluated for
+        name stage; // stage being walked, empty when there is nothing to evaluate
+        uint64_t next_id;
+        uint64_t end_id; // proposals created after onperiod wait for the next cycle
+        uint64_t active_proposals; // active proposals at onperiod, for participation rewards
+      };
+
+      // proposals an evaluation skipped, they stay in their stage and are evaluated again next cycle
+      TABLE eval_skip_table {
+        uint64_t proposal_id;
+        uint64_t prop_cycle;
+        string reason;
+        uint64_t timestamp;
+
+        uint64_t primary_key()const { return proposal_id; }
+      };
+
       TABLE active_table {
         name account;
         uint64_t timestamp;
@@ -367,12 +412,65 @@ CONTRACT proposals : public contract {
         name delegatee;
         double weight;
         uint64_t timestamp;
+        eosio::binary_extension<double> pool_factor; // delegatee's pool live factor when the delegator's voice was written
+        eosio::binary_extension<uint64_t> pool_epoch;
+        eosio::binary_extension<uint64_t> written; // when the voice was written into the pool
+        eosio::binary_extension<double> prior_units; // units before that write, for the votes the pool cast before it
+        eosio::binary_extension<uint64_t> prior_epoch;
 
         uint64_t primary_key()const { return delegator.value; }
         uint64_t by_delegatee()const { return delegatee.value; }
         uint128_t by_delegatee_delegator() const { return (uint128_t(delegatee.value) << 64) + delegator.value; }
       };
 
+      // scoped by proposal's category, voice of a delegatee's delegators
+      // a delegatee that delegates itself can not vote, its pool is linked into its delegatee's and counted there,
+      // so a vote only spends the voter's pool, by scaling its factor
+      // live factor = factor * parent's live factor / parent_factor, a linked pool keeps its factor until it is unlinked
+      // a fully spent pool moves to a new epoch, delegators and linked pools of older epochs have no voice left
+      TABLE delegation_pool_table {
+        name delegatee;
+        name parent; // who the delegatee delegates to
+        double units; // voice / (decay factor * live factor) at write time, of the delegators and the linked pools
+        double factor;
+        uint64_t epoch;
+        uint64_t delegators;
+        double parent_factor; // parent's live factor when linked
+        uint64_t parent_epoch;
+        uint64_t linked;
+        uint64_t votes; // votes cast with the pool this cycle, erasepartpts hands them down to the delegators
+        bool nonneutral;
+        name credit_from; // next delegator to hand the votes down to
+
+        uint64_t primary_key()const { return delegatee.value; }
+        uint64_t by_votes()const { return votes; }
+      };
+
+      // scoped by the voting pool's delegatee, what a vote spent from the pool while the proposal is active
+      // lets a delegator who leaves take its share of the vote with it
+      TABLE pool_spend_table {
+        uint64_t proposal_id;
+        uint64_t epoch; // pool epoch the vote spent
+        double spent_per_unit; // pool factor * decay factor * percentage used at vote time
+        uint64_t spent; // voice still counted in the voter's vote
+        uint64_t timestamp;
+
+        uint64_t primary_key()const { return proposal_id; }
+      };
+
+      // where a pool sits below the pool that votes for it, after refresh_pool
+      struct pool_link {
+        name root;
+        double live_factor;
+        double root_ratio; // units of the pool in units of the root pool
+        uint64_t linked; // latest time a pool of the chain was linked
+      };
+
+      double pool_units (uint64_t balance, double decay_factor, double pool_factor);
+      double pool_live_factor (const delegation_pool_table & pool, name scope);
+      uint64_t get_voice (const voice_table & v, name scope);
+      void store_voice (name user, name scope, uint64_t amount);
+
       DEFINE_MOON_PHASES_TABLE
       DEFINE_MOON_PHASES_TABLE_MULTI_INDEX
 
@@ -435,8 +533,11 @@ CONTRACT proposals : public contract {
     typedef eosio::multi_index<"participants"_n, participant_table> participant_tables;
     typedef eosio::multi_index<"users"_n, user_table> user_tables;
     typedef eosio::multi_index<"voice"_n, voice_table> voice_tables;
+    typedef eosio::multi_index<"voicedecay"_n, voice_decay_table> voice_decay_tables;
     typedef eosio::multi_index<"lastprops"_n, last_proposal_table> last_proposal_tables;
     typedef singleton<"cycle"_n, cycle_table> cycle_tables;
+    typedef singleton<"evalqueue"_n, eval_queue_table> eval_queue_tables;
+    typedef eosio::multi_index<"evalskips"_n, eval_skip_table> eval_skip_tables;
     typedef eosio::multi_index<"cycle"_n, cycle_table> dump_for_cycle;
     typedef eosio::multi_index<"minstake"_n, min_stake_table> min_stake_tables;
     typedef eosio::multi_index<"actives"_n, active_table> active_tables;
@@ -446,6 +547,19 @@ CONTRACT proposals : public contract {
       indexed_by<"byddelegator"_n,
       const_mem_fun<delegate_trust_table, uint128_t, &delegate_trust_table::by_delegatee_delegator>>
     > delegate_trust_tables;
+    typedef eosio::multi_index<"delpools"_n, delegation_pool_table,
+      indexed_by<"byvotes"_n,
+      const_mem_fun<delegation_pool_table, uint64_t, &delegation_pool_table::by_votes>>
+    > delegation_pool_tables;
+    typedef eosio::multi_index<"poolspends"_n, pool_spend_table> pool_spend_tables;
+
+    pool_link refresh_pool (delegation_pool_tables & pools, name delegatee);
+    void add_pool_units (delegation_pool_tables & pools, name delegatee, double units);
+    void link_pool (delegation_pool_tables & pools, name delegatee, name parent);
+    void unlink_pool (delegation_pool_tables & pools, name delegatee);
+    void write_pool_share (delegate_trust_table & item, double live_factor, uint64_t epoch, double prior_units, uint64_t prior_epoch);
+    void settle_pool_spends (delegation_pool_tables & pools, const delegate_trust_table & d, const pool_link & link, name scope);
+
     typedef eosio::multi_index<"cyclestats"_n, cycle_stats_table> cycle_stats_tables;
     typedef eosio::multi_index<"cycvotedprps"_n, voted_proposals_table> voted_proposals_tables;
 
@@ -464,6 +578,9 @@ CONTRACT proposals : public contract {
     active_tables actives;
     cycle_stats_tables cyclestats;
 
+    // funds evaluations of this action pay from, their inline transfers have not run yet
+    std::map<name, int64_t> eval_outflows;
+
 };
 
 extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
@@ -472,17 +589,17 @@ extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
   } else if (code == receiver) {
       switch (action) {
         EOSIO_DISPATCH_HELPER(proposals, (reset)(create)(createx)(createinvite)(update)(updatex)(addvoice)(changetrust)(favour)(against)
-        (neutral)(erasepartpts)(checkstake)(onperiod)(evalproposal)(decayvoice)(cancel)(updatevoices)(updatevoice)(decayvoices)
+        (neutral)(erasepartpts)(checkstake)(onperiod)(evalproposal)(evalprops)(cancel)(updatevoices)(updatevoice)(decayvoices)
         (addactive)(testvdecay)(initsz)(testquorum)(initnumprop)
         (questvote)
-        (testsetvoice)(delegate)(mimicvote)(undelegate)(voteonbehalf)
-        (calcvotepow)(addcampaign)(checkprop)(doneprop)
+        (testsetvoice)(delegate)(undelegate)(pooldelegs)
+        (calcvotepow)(addcampaign)(checkprop)(doneprop)(voiceof)
         (testperiod)(testevalprop)
         (cleanmig)(testpropquor)
         (reevalprop)
         (testalliance)(migalliances)
         (fixdesc)(applyfixprop)(backfixprop)
-        (revertvote)(mimicrevert)
+        (revertvote)
         (rewind)(fixcycstat)
         (testvn)
         (testisbanned)
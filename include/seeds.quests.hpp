@@ -11,6 +11,8 @@
 #include <vector>
 #include <utility>
 #include <cmath>
+#include <map>
+#include <optional>
 
 #include <graph_common.hpp>
 #include <document_graph/content.hpp>
@@ -36,6 +38,11 @@ CONTRACT quests : public contract {
       sizes(contracts::proposals, contracts::proposals.value)
       {}
 
+    // the cache counters of the action are added to cachestats once it ran
+    ~quests() {
+      save_cache_stats();
+    }
+
     DECLARE_DOCUMENT_GRAPH(quests)
 
     ACTION reset();
@@ -98,6 +105,8 @@ CONTRACT quests : public contract {
 
     ACTION ratequest(checksum256 quest_hash, name opinion);
 
+    ACTION reindexedges(uint64_t start, uint64_t chunksize);
+
 
   private:
 
@@ -181,6 +190,33 @@ CONTRACT quests : public contract {
 
     hypha::DocumentGraph m_documentGraph = hypha::DocumentGraph(get_self());
 
+    // action scoped cache, a contract instance lives for a single action
+    // documents are keyed by hash, edges by (from node, edge name) to the first to node
+    hypha::Document get_doc(const checksum256 & hash);
+    std::pair<bool, checksum256> find_edge_to(const checksum256 & from_node_hash, const name & edge_name);
+    hypha::Document update_doc(const checksum256 & old_hash, const hypha::ContentGroups & content_groups);
+    void erase_doc(const checksum256 & hash);
+    void erase_edge(const checksum256 & from_node_hash, const name & edge_name);
+    void erase_edge(hypha::Edge & edge);
+    void write_edge(const name & creator, const checksum256 & from_node_hash, const checksum256 & to_node_hash, const name & edge_name);
+    void forget_edge(const checksum256 & from_node_hash, const name & edge_name);
+    void save_cache_stats();
+
+    std::map<checksum256, hypha::Document> doc_cache;
+    std::map<std::pair<checksum256, uint64_t>, checksum256> edge_cache;
+    std::optional<checksum256> root_hash;
+    uint64_t cache_hits = 0;
+    uint64_t cache_misses = 0;
+
+    // hits and misses of the document and edge cache, summed over all actions
+    TABLE cache_stats_table {
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+    };
+
+    typedef eosio::singleton<"cachestats"_n, cache_stats_table> cache_stats_tables;
+    typedef eosio::multi_index<"cachestats"_n, cache_stats_table> dump_for_cache_stats;
+
 
     DEFINE_USER_TABLE
     DEFINE_USER_TABLE_MULTI_INDEX
@@ -219,6 +255,7 @@ extern "C" void apply(uint64_t receiver, uint64_t code, uint64_t action) {
           (expirequest)(expireappl)(cancelappl)(retractappl)(quitapplcnt)
           (evalprop)(favour)(against)
           (rateapplcnt)(ratequest)
+          (reindexedges)
         )
       }
   }
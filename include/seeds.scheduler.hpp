@@ -19,6 +19,7 @@ CONTRACT scheduler : public contract {
         moonphases(receiver, receiver.value),
         test(receiver, receiver.value),
         moonops(receiver, receiver.value),
+        dueops(receiver, receiver.value),
         config(contracts::settings, contracts::settings.value)
         {}
 
@@ -55,9 +56,15 @@ CONTRACT scheduler : public contract {
 
     private:
         void exec_op(name id, name contract, name action);
+        void send_op(name id, name contract, name action);
         void cancel_exec();
         void reset_aux(bool destructive);
         uint64_t next_valid_moon_phase(uint64_t moon_cycle_id, uint64_t quarter_moon_cycles);
+        void schedule_op(name id);
+        void schedule_moon_op(name id);
+        void set_due(name id, uint64_t due, bool moon);
+        void unschedule(name id);
+        void rebuild_due();
         bool should_preserve_op(name op_id) {
             return 
                 op_id == "exch.period"_n || 
@@ -92,6 +99,16 @@ CONTRACT scheduler : public contract {
             uint64_t by_last_cycle() const { return last_moon_cycle_id; }
         };
 
+        // one row per active (not paused) op of either table, ordered by the time it is next due
+        TABLE due_ops_table {
+            name id;
+            uint64_t due;
+            bool moon;
+
+            uint64_t primary_key() const { return id.value; }
+            uint64_t by_due() const { return due; }
+        };
+
         TABLE test_table {
             name param;
             uint64_t value;
@@ -113,16 +130,23 @@ CONTRACT scheduler : public contract {
             const_mem_fun<moon_ops_table, uint64_t, &moon_ops_table::by_last_cycle>>
         > moon_ops_tables;
 
+        typedef eosio::multi_index <"dueops"_n, due_ops_table,
+            indexed_by<"bydue"_n,
+            const_mem_fun<due_ops_table, uint64_t, &due_ops_table::by_due>>
+        > due_ops_tables;
+
         typedef eosio::multi_index <"test"_n, test_table> test_tables;
 
         name seconds_to_execute = "secndstoexec"_n;
+        name ops_per_tick = "sched.ops"_n;
 
         operations_tables operations;
         config_tables config;
         test_tables test;
         moon_phases_tables moonphases;
         moon_ops_tables moonops;
+        due_ops_tables dueops;
 
-        uint64_t is_ready_op(const name & operation, const uint64_t & timestamp);
-        uint64_t is_ready_moon_op(const name & operation, const uint64_t & timestamp);
+        uint64_t op_due(const operations_table & op);
+        uint64_t moon_op_due(const moon_ops_table & moonop);
 };
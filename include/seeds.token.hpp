@@ -11,6 +11,8 @@
 #include <tables.hpp>
 #include <tables/config_table.hpp>
 #include <eosio/singleton.hpp>
+#include <eosio/binary_extension.hpp>
+#include <utils.hpp>
 
 #include <string>
 
@@ -37,7 +39,8 @@ namespace eosio {
          using contract::contract;
          token(name receiver, name code, datastream<const char*> ds)
             :  contract(receiver, code, ds),
-               circulating(receiver, receiver.value)
+               circulating(receiver, receiver.value),
+               trxepoch(receiver, receiver.value)
                {}
          
          /**
@@ -175,9 +178,6 @@ namespace eosio {
          [[eosio::action]]
          void resetweekly();
 
-         [[eosio::action]]
-         void resetwhelper(uint64_t begin);
-
          ACTION updatecirc();
 
          ACTION minthrvst(const name& to, const asset& quantity, const string& memo);
@@ -217,6 +217,7 @@ namespace eosio {
             uint64_t total_transactions;
             uint64_t incoming_transactions;
             uint64_t outgoing_transactions;
+            eosio::binary_extension<uint64_t> epoch;
 
             uint64_t primary_key()const { return account.value; }
             uint64_t by_transaction_volume()const { return transactions_volume.amount; }
@@ -241,7 +242,8 @@ namespace eosio {
          void check_limit( const name& from );
          uint64_t balance_for( const name& owner );
          void check_limit_transactions(name from);
-         void reset_weekly_aux(uint64_t begin);
+         uint64_t current_trx_epoch();
+         void roll_trx_epoch(transaction_stats & stats, uint64_t epoch);
 
          TABLE circulating_supply_table {
             uint64_t id;
@@ -255,6 +257,17 @@ namespace eosio {
 
          circulating_supply_tables circulating;
 
+         // trxstat rows written in an older week count as zero, resetweekly only bumps the epoch
+         TABLE trx_epoch_table {
+            uint64_t epoch = 0;
+            uint64_t timestamp = 0;
+         };
+
+         typedef singleton<"trxepoch"_n, trx_epoch_table> trx_epoch_tables;
+         typedef eosio::multi_index<"trxepoch"_n, trx_epoch_table> dump_for_trx_epoch;
+
+         trx_epoch_tables trxepoch;
+
          typedef eosio::multi_index<"config"_n, config_table> config_tables;
          typedef eosio::multi_index<"balances"_n, tables::balance_table,
          indexed_by<"byplanted"_n,
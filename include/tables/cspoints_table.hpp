@@ -22,3 +22,13 @@ using eosio::name;
 
     
 
+
+// SCOPE same as cspoints - latest contribution points of accounts scored while a rankcs pass is in flight
+#define DEFINE_CS_DELTA_TABLE TABLE cs_delta_table { \
+      name account; \
+      uint32_t contribution_points; \
+\
+      uint64_t primary_key() const { return account.value; } \
+    }; \
+
+#define DEFINE_CS_DELTA_TABLE_MULTI_INDEX typedef eosio::multi_index<"csdelta"_n, cs_delta_table> cs_delta_tables;
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+using eosio::name;
+
+// Ranking ids - one rankbounds row per ranked table and scope
+namespace rankings {
+  inline constexpr name planted = "planted"_n;
+  inline constexpr name tx = "txpt"_n;
+  inline constexpr name org_tx = "txpt.org"_n;
+  inline constexpr name cs = "cs"_n;
+  inline constexpr name org_cs = "cs.org"_n;
+  inline constexpr name rgn_cs = "cs.rgn"_n;
+  inline constexpr name rep = "rep"_n;
+  inline constexpr name org_rep = "rep.org"_n;
+  inline constexpr name cbs = "cbs"_n;
+  inline constexpr name org_cbs = "cbs.org"_n;
+  inline constexpr name app_use = "appuse"_n;
+}
+
+// SCOPE by contract owning the ranked table
+// bounds[i] is the first index key of percentile bucket i, published when a ranking pass completes
+// lazy rankings do not maintain the rank field of their rows, readers resolve it from bounds
+#define DEFINE_RANK_BOUNDS_TABLE TABLE rank_bounds_table { \
+        name ranking; \
+        name curve; \
+        bool lazy; \
+        uint64_t total; \
+        std::vector<uint128_t> bounds; \
+        uint64_t timestamp; \
+\
+        uint64_t primary_key()const { return ranking.value; } \
+      };
+
+#define DEFINE_RANK_BOUNDS_TABLE_MULTI_INDEX typedef eosio::multi_index<"rankbounds"_n, rank_bounds_table> rank_bounds_tables;
+
+// boundaries collected by the ranking pass in flight, kept apart so readers never load them
+#define DEFINE_RANK_PASS_TABLE TABLE rank_pass_table { \
+        name ranking; \
+        std::vector<uint128_t> pending; \
+\
+        uint64_t primary_key()const { return ranking.value; } \
+      };
+
+#define DEFINE_RANK_PASS_TABLE_MULTI_INDEX typedef eosio::multi_index<"rankpasses"_n, rank_pass_table> rank_pass_tables;
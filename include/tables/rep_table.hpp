@@ -1,4 +1,5 @@
 #include <eosio/eosio.hpp>
+#include <eosio/singleton.hpp>
 
 using eosio::name;
 
@@ -17,3 +18,33 @@ using eosio::name;
           indexed_by<"byrep"_n, const_mem_fun<rep_table, uint64_t, &rep_table::by_rep>>, \
           indexed_by<"byrank"_n, const_mem_fun<rep_table, uint64_t, &rep_table::by_rank>> \
         > rep_tables;
+
+// SCOPE same as rep - reputation gained or lost while a rankrep pass is in flight
+#define DEFINE_REP_DELTA_TABLE TABLE rep_delta_table { \
+        name account; \
+        int64_t delta; \
+\
+        uint64_t primary_key() const { return account.value; } \
+      };
+
+#define DEFINE_REP_DELTA_TABLE_MULTI_INDEX typedef eosio::multi_index<"repdelta"_n, rep_delta_table> rep_delta_tables;
+
+// SCOPE same as rep - Fenwick tree counting rep rows by rep value, so the number of rows below a value takes a few reads
+// node i holds the rows whose value - 1 falls in (i - lowbit(i), i], missing nodes count 0
+#define DEFINE_REP_COUNT_TABLE TABLE rep_count_table { \
+        uint64_t node; \
+        uint64_t count; \
+\
+        uint64_t primary_key() const { return node; } \
+      };
+
+#define DEFINE_REP_COUNT_TABLE_MULTI_INDEX typedef eosio::multi_index<"repcounts"_n, rep_count_table> rep_count_tables;
+
+// SCOPE same as rep - rep rows with an account below cursor are counted, all of them once complete
+#define DEFINE_REP_COUNT_STATE_TABLE TABLE rep_count_state_table { \
+        uint64_t cursor = 0; \
+        bool complete = false; \
+      };
+
+#define DEFINE_REP_COUNT_STATE_SINGLETON typedef eosio::singleton<"repcountst"_n, rep_count_state_table> rep_count_state_tables; \
+typedef eosio::multi_index<"repcountst"_n, rep_count_state_table> dump_for_rep_count_state;
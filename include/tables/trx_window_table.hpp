@@ -0,0 +1,19 @@
+#pragma once
+
+#include <eosio/eosio.hpp>
+
+using eosio::name;
+
+// SCOPE history contract
+// points is the sum of the account's trxpoints rows from start on, last_day its latest day with points
+// rows before the trailing cutoff are subtracted once, when they drop out of the window
+#define DEFINE_TRX_WINDOW_TABLE TABLE trx_window_table { \
+        name account; \
+        uint64_t points; \
+        uint64_t start; \
+        uint64_t last_day; \
+\
+        uint64_t primary_key() const { return account.value; } \
+      };
+
+#define DEFINE_TRX_WINDOW_TABLE_MULTI_INDEX typedef eosio::multi_index<"trxwindow"_n, trx_window_table> trx_window_tables;
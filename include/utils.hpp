@@ -1,13 +1,18 @@
+#pragma once
+
 #include <eosio/eosio.hpp>
 #include <eosio/asset.hpp>
 #include <eosio/system.hpp>
 #include <eosio/transaction.hpp>
+#include <eosio/crypto.hpp>
+#include <algorithm>
+#include <cstring>
 #include <tables/rep_table.hpp>
 #include <tables/size_table.hpp>
 #include <tables/user_table.hpp>
 #include <tables/config_table.hpp>
 #include <tables/config_float_table.hpp>
-#include <tables/deferred_id_table.hpp>
+#include <tables/rank_bounds_table.hpp>
 
 using namespace eosio;
 using std::string;
@@ -21,34 +26,38 @@ namespace utils {
 
   symbol seeds_symbol = symbol("SEEDS", 4);
 
+  const uint64_t rank_buckets = 100;
+
+  const name linear_curve = "linear"_n;
+  const name spline_curve = "spline"_n;
+
+  // Chunked ranking jobs spend a budget per action: a row whose rank did not change
+  // only costs a read, a row that has to be rewritten costs a RAM write
+  const uint64_t rank_read_cost = 1;
+  const uint64_t rank_write_cost = 5;
+  const uint64_t rank_batch_budget = 1000;
+
+  // percentile bucket 0 - 99 of the row at position current
+  inline uint64_t rank_bucket(uint64_t current, uint64_t total) {
+    uint64_t b = (current * rank_buckets) / total;
+    if (b > rank_buckets - 1) return rank_buckets - 1;
+    return b;
+  }
+
   inline uint64_t linear_rank(uint64_t current, uint64_t total) { 
     /**
-     * TODO - Table Locks
-     * 
-     * rank can exceed 99 when we count accounts double. This can happen when an account receives reputation while we iterate
-     * and is moved to a new bucket.
-     * We then count it again in this new bucket - this means we end up counting more users than are in the reps table
-     * which skews the count.
-     * The reason this is not atomic is that we go over the table in chunks, so inbetween chunks anything can happen.
-     * 
-     * The correct way to solve this would be to wait until the ranking is finished, and to apply changes in reputation only once that has
-     * happened. Like a manually implemented table lock. (rep or any other number we are ranking)
-     * 
-     * For now that's too complex - a lock would have to be between changing reputation and ranking. Ranking could simply wait until there's no 
-     * lock but applying reputation we would have to store changes in a secondary table rep_delta, apply all changes there while rep ranking is happening
-     * and apply the delta back to the full table once rep ranking is finished.
+     * rank can exceed 99 when we count accounts double. This happens when an account's score changes while we
+     * iterate in chunks and the account is moved to a later bucket - we then count it again in the new bucket.
      * 
+     * rankcs and rankrep rank a frozen snapshot: while their pass is in flight score changes go to a delta table
+     * (csdelta, repdelta) and are merged once the pass is done, see rank_pass_in_flight.
      * 
-     * The count rebalances the next time we go over it, it's a dynamic system. 
-
-     * The cheap way to fix it is to limit rank to 99
+     * Other rankings are not locked, their count rebalances the next time we go over it. So we limit rank to 99.
     */
-    uint64_t r = (current * 100) / total; 
-    if (r > 99) return 99;
-    return r;
+    return rank_bucket(current, total);
   }
 
-  inline uint64_t spline_rank(uint64_t current, uint64_t total) {
+  inline uint64_t spline_rank_for_bucket(uint64_t bucket) {
     // Spline rank table coeficients
     const float rank_coefs[100] = { 0.00,
                             0.00,
@@ -151,12 +160,195 @@ namespace utils {
                             97.54,
                             99.00
     };
-    uint64_t calc = (current * 100) / total;
-    if (calc > 99) calc = 99;
+    return (uint64_t)rank_coefs[bucket];
+  }
+
+  inline uint64_t spline_rank(uint64_t current, uint64_t total) {
+    return spline_rank_for_bucket(rank_bucket(current, total));
+  }
+
+  inline uint64_t curve_rank(name curve, uint64_t bucket) {
+    return curve == spline_curve ? spline_rank_for_bucket(bucket) : bucket;
+  }
+
+  /**
+   * Transaction points of a trxwindow row at cutoff.
+   * Only the rows between the window start and the cutoff are read - the days that dropped out
+   * since the window was last written. count is increased by the number of rows read.
+   */
+  template <typename PointsTable, typename Window>
+  inline uint64_t trx_window_points(PointsTable & trxpoints_t, const Window & window, uint64_t cutoff, uint64_t & count) {
+    if (window.last_day < cutoff) return 0;
+    if (window.start >= cutoff) return window.points;
+
+    uint64_t points = window.points;
+    auto titr = trxpoints_t.lower_bound(window.start);
+    while (titr != trxpoints_t.end() && titr->timestamp < cutoff) {
+      points = points > titr->points ? points - titr->points : 0;
+      titr++;
+      count++;
+    }
+    return points;
+  }
+
+  /**
+   * Resumes a chunked walk over a secondary index at the row identified by the cursor (key, id),
+   * where id is the primary key of the row.
+   * Score keys are not unique - many accounts share a score and the low 32 bits of their names 
+   * don't always break the tie - so lower_bound(key) alone re-visits rows of the previous chunk.
+   * Rows with equal secondary keys are ordered by primary key, which makes the cursor exact.
+   */
+  template <typename Index, typename Key>
+  inline auto cursor_seek(Index & index, Key key, uint64_t id) {
+    auto itr = index.lower_bound(key);
+    auto end = index.upper_bound(key);
+    while (itr != end && itr->primary_key() < id) {
+      itr++;
+    }
+    return itr;
+  }
 
-    return (uint64_t)rank_coefs[calc];
+  /**
+   * Ranking engine shared by the ranking jobs in harvest, accounts and organization.
+   * 
+   * A pass walks a score ordered index once, possibly across several chained actions.
+   * For every row, next() derives the percentile bucket from the row's position and records
+   * the first index key of each bucket in the rankpasses row of the ranking. Once the pass
+   * reaches the end of the index the 100 boundaries are published in the rankbounds row, so
+   * a rank can be derived from a score without walking the index (see rank_resolver).
+   * 
+   * Callers only modify a row when should_write() says so: never for lazy rankings, and
+   * otherwise only when the rank actually changed - between two passes most ranks stay the
+   * same, so most rows only cost a read and chunks can be much larger.
+   */
+  template <typename BoundsTable, typename PassTable>
+  class rank_pass {
+    public:
+      rank_pass(BoundsTable & bounds_t, PassTable & passes_t, name payer, name ranking, name curve, bool lazy, uint64_t total, uint64_t current)
+        : bounds_t(bounds_t), passes_t(passes_t), payer(payer), ranking(ranking), curve(curve), lazy(lazy), total(total), current(current) {
+        auto pitr = passes_t.find(ranking.value);
+        if (pitr != passes_t.end() && current > 0) {
+          pending = pitr->pending;
+        }
+      }
+
+      // rank of the row at the current position, key is the row's index key
+      uint64_t next(uint128_t key) {
+        uint64_t bucket = rank_bucket(current, total);
+        // empty buckets (less than 100 rows) share the boundary of the next non empty one
+        while (pending.size() <= bucket) {
+          pending.push_back(key);
+        }
+        current++;
+        return curve_rank(curve, bucket);
+      }
+
+      bool should_write(uint64_t stored_rank, uint64_t rank) const {
+        return !lazy && stored_rank != rank;
+      }
+
+      uint64_t position() const { return current; }
+
+      void save(bool done) {
+        auto pitr = passes_t.find(ranking.value);
+
+        if (!done) {
+          if (pitr == passes_t.end()) {
+            passes_t.emplace(payer, [&](auto & item){
+              item.ranking = ranking;
+              item.pending = pending;
+            });
+          } else {
+            passes_t.modify(pitr, payer, [&](auto & item){
+              item.pending = pending;
+            });
+          }
+          return;
+        }
+
+        if (pitr != passes_t.end()) {
+          passes_t.erase(pitr);
+        }
+
+        // buckets after the last row can never be reached
+        while (pending.size() < rank_buckets) {
+          pending.push_back(~uint128_t(0));
+        }
+
+        auto bitr = bounds_t.find(ranking.value);
+        if (bitr == bounds_t.end()) {
+          bounds_t.emplace(payer, [&](auto & item){
+            item.ranking = ranking;
+            set_bounds(item);
+          });
+        } else {
+          bounds_t.modify(bitr, payer, [&](auto & item){
+            set_bounds(item);
+          });
+        }
+      }
+
+    private:
+      BoundsTable & bounds_t;
+      PassTable & passes_t;
+      name payer;
+      name ranking;
+      name curve;
+      bool lazy;
+      uint64_t total;
+      uint64_t current;
+      std::vector<uint128_t> pending;
+
+      template <typename Row>
+      void set_bounds(Row & item) {
+        item.curve = curve;
+        item.lazy = lazy;
+        item.total = total;
+        item.bounds = pending;
+        item.timestamp = eosio::current_time_point().sec_since_epoch();
+      }
+  };
+
+  // a pass is in flight between the chunks of a ranking - its rankpasses row only exists then
+  template <typename PassTable>
+  inline bool rank_pass_in_flight(PassTable & passes_t, name ranking) {
+    return passes_t.find(ranking.value) != passes_t.end();
   }
 
+  /**
+   * Reads the published boundaries of a ranking once, then resolves ranks of rows.
+   * For lazy rankings the rank stored in a row is not maintained, so the rank is found by
+   * binary search of the row's index key over the 100 boundaries. Otherwise the stored rank is used.
+   */
+  class rank_resolver {
+    public:
+      rank_resolver(name code, name ranking) {
+        DEFINE_RANK_BOUNDS_TABLE
+        DEFINE_RANK_BOUNDS_TABLE_MULTI_INDEX
+
+        rank_bounds_tables bounds_t(code, code.value);
+        auto bitr = bounds_t.find(ranking.value);
+        if (bitr != bounds_t.end() && bitr->lazy) {
+          lazy = true;
+          curve = bitr->curve;
+          bounds = bitr->bounds;
+        }
+      }
+
+      uint64_t rank(uint128_t key, uint64_t stored_rank) const {
+        if (!lazy) return stored_rank;
+        // last bucket whose first key is <= key
+        auto bitr = std::upper_bound(bounds.begin(), bounds.end(), key);
+        if (bitr == bounds.begin()) return 0;
+        return curve_rank(curve, uint64_t(bitr - bounds.begin()) - 1);
+      }
+
+    private:
+      bool lazy = false;
+      name curve;
+      std::vector<uint128_t> bounds;
+  };
+
   inline bool is_valid_majority(uint64_t favour, uint64_t against, uint64_t majority) {
     return favour >= (favour + against) * majority / 100;
   }
@@ -190,13 +382,16 @@ namespace utils {
     user_tables users(contracts::accounts, contracts::accounts.value);
     auto uitr = users.find(account.value);
     name scope;
+    name ranking;
 
     if (uitr == users.end()) { return 0; }
 
     if (uitr->type == "individual"_n) {
       scope = contracts::accounts;
+      ranking = rankings::rep;
     } else if (uitr->type == "organisation"_n) {
       scope = "org"_n;
+      ranking = rankings::org_rep;
     }
     
     rep_tables rep(contracts::accounts, scope.value);
@@ -207,7 +402,7 @@ namespace utils {
       return 0;
     }
 
-    return rep_multiplier_for_score(ritr->rank);
+    return rep_multiplier_for_score(rank_resolver(contracts::accounts, ranking).rank(ritr->by_rep(), ritr->rank));
 
   }
 
@@ -240,6 +435,51 @@ namespace utils {
 
   }
 
+  /**
+   * Sender id for a deferred transaction, without writing any table.
+   * Hashes the current transaction (what its id is derived from), the action data, the receiver,
+   * the packed job being scheduled and a counter of the ids handed out by this action - contract
+   * memory only lives for one action, so two sends from the same action get different ids.
+   * Two actions of one transaction only collide when the same receiver runs the same action data
+   * and schedules the same job, e.g. a notification delivered twice; jobs where that can happen
+   * keep a fixed sender id and replace the pending one instead.
+   */
+  inline uint64_t deferred_id(const std::vector<char> & job = std::vector<char>()) {
+    static uint64_t counter = 0;
+    counter++;
+
+    uint64_t receiver = eosio::current_receiver().value;
+    uint32_t trx_size = eosio::transaction_size();
+    uint32_t data_size = eosio::action_data_size();
+
+    std::vector<char> buffer(trx_size + data_size + sizeof(receiver) + sizeof(counter) + job.size());
+    char * pos = buffer.data();
+    eosio::read_transaction(pos, trx_size);
+    pos += trx_size;
+    eosio::read_action_data(pos, data_size);
+    pos += data_size;
+    std::memcpy(pos, &receiver, sizeof(receiver));
+    pos += sizeof(receiver);
+    std::memcpy(pos, &counter, sizeof(counter));
+    pos += sizeof(counter);
+    if (!job.empty()) {
+      std::memcpy(pos, job.data(), job.size());
+    }
+
+    auto hash = eosio::sha256(buffer.data(), buffer.size()).extract_as_byte_array();
+
+    uint64_t id = 0;
+    for (int i = 0; i < 8; i++) {
+      id = (id << 8) | hash[i];
+    }
+    return id;
+  }
+
+  // sender id for trx, its actions (account, name, data) are part of the hash
+  inline uint64_t deferred_id(const eosio::transaction & trx) {
+    return deferred_id(eosio::pack(trx.actions));
+  }
+
   template <typename... T>
   inline void send_deferred_transaction (
     const name & code,
@@ -248,16 +488,6 @@ namespace utils {
     const name & action,  
     const std::tuple<T...> & data) {
 
-    DEFINE_DEFERRED_ID_TABLE
-    DEFINE_DEFERRED_ID_SINGLETON
-
-    deferred_id_tables deferredids(code, code.value);
-    deferred_id_table d_s = deferredids.get_or_create(code, deferred_id_table());
-
-    d_s.id += 1;
-
-    deferredids.set(d_s, code);
-
     transaction trx{};
 
     trx.actions.emplace_back(
@@ -268,7 +498,7 @@ namespace utils {
     );
 
     trx.delay_sec = 1;
-    trx.send(d_s.id, code);
+    trx.send(deferred_id(trx), code);
 
   }
 
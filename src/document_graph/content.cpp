@@ -18,37 +18,59 @@ namespace hypha
 
     const std::string Content::toString() const
     {
-        if (isEmpty()) return "";
-        
-        std::string str = "{" + std::string(label) + "=";
+        std::string str;
+        appendTo(str);
+        return str;
+    }
+
+    void Content::appendTo(std::string &out) const
+    {
+        if (isEmpty()) return;
+
+        out.append("{").append(label).append("=");
         if (std::holds_alternative<std::int64_t>(value))
         {
-            str += "[int64," + std::to_string(std::get<std::int64_t>(value)) + "]";
+            out.append("[int64,").append(std::to_string(std::get<std::int64_t>(value))).append("]");
         }
         else if (std::holds_alternative<eosio::asset>(value))
         {
-            str += "[asset," + std::get<eosio::asset>(value).to_string() + "]";
+            out.append("[asset,").append(std::get<eosio::asset>(value).to_string()).append("]");
         }
         else if (std::holds_alternative<eosio::time_point>(value))
         {
-            str += "[time_point," + std::to_string(std::get<eosio::time_point>(value).sec_since_epoch()) + "]";
+            out.append("[time_point,").append(std::to_string(std::get<eosio::time_point>(value).sec_since_epoch())).append("]");
         }
         else if (std::holds_alternative<std::string>(value))
         {
-            str += "[string," + std::get<std::string>(value) + "]";
+            out.append("[string,").append(std::get<std::string>(value)).append("]");
         }
         else if (std::holds_alternative<eosio::checksum256>(value))
         {
             eosio::checksum256 cs_value = std::get<eosio::checksum256>(value);
             auto arr = cs_value.extract_as_byte_array();
-            std::string str_value = toHex((const char *)arr.data(), arr.size());
-            str += "[checksum256," + str_value + "]";
+            out.append("[checksum256,").append(toHex((const char *)arr.data(), arr.size())).append("]");
         }
         else
         {
-            str += "[name," + std::get<eosio::name>(value).to_string() + "]";
+            out.append("[name,").append(std::get<eosio::name>(value).to_string()).append("]");
         }
-        str += "}";
-        return str;
+        out.append("}");
+    }
+
+    // upper bound of the canonical length, only used to reserve the output buffer
+    const size_t Content::encodedSize() const
+    {
+        if (isEmpty()) return 0;
+
+        size_t size = label.size() + 40;
+        if (std::holds_alternative<std::string>(value))
+        {
+            size += std::get<std::string>(value).size();
+        }
+        else if (std::holds_alternative<eosio::checksum256>(value))
+        {
+            size += 64;
+        }
+        return size;
     }
 } // namespace hypha
\ No newline at end of file
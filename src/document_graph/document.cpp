@@ -151,14 +151,26 @@ namespace hypha
     const eosio::checksum256 Document::hashContents(const ContentGroups &contentGroups)
     {
         std::string string_data = toString(contentGroups);
-        return eosio::sha256(const_cast<char *>(string_data.c_str()), string_data.length());
+        return eosio::sha256(string_data.data(), string_data.length());
     }
 
     const std::string Document::toString(const ContentGroups &contentGroups)
     {
-        std::string results = "[";
-        bool is_first = true;
+        size_t size = 2;
+        for (const ContentGroup &contentGroup : contentGroups)
+        {
+            size += 3 + contentGroup.size();
+            for (const Content &content : contentGroup)
+            {
+                size += content.encodedSize();
+            }
+        }
+
+        std::string results;
+        results.reserve(size);
+        results.push_back('[');
 
+        bool is_first = true;
         for (const ContentGroup &contentGroup : contentGroups)
         {
             if (is_first)
@@ -167,18 +179,25 @@ namespace hypha
             }
             else
             {
-                results = results + ",";
+                results.push_back(',');
             }
-            results = results + toString(contentGroup);
+            appendTo(contentGroup, results);
         }
 
-        results = results + "]";
+        results.push_back(']');
         return results;
     }
 
     const std::string Document::toString(const ContentGroup &contentGroup)
     {
-        std::string results = "[";
+        std::string results;
+        appendTo(contentGroup, results);
+        return results;
+    }
+
+    void Document::appendTo(const ContentGroup &contentGroup, std::string &out)
+    {
+        out.push_back('[');
         bool is_first = true;
 
         for (const Content &content : contentGroup)
@@ -189,13 +208,12 @@ namespace hypha
             }
             else
             {
-                results = results + ",";
+                out.push_back(',');
             }
-            results = results + content.toString();
+            content.appendTo(out);
         }
 
-        results = results + "]";
-        return results;
+        out.push_back(']');
     }
 
     ContentGroups Document::rollup(ContentGroup contentGroup)
@@ -4,23 +4,43 @@
 
 namespace hypha
 {
-    std::vector<Edge> DocumentGraph::getEdges(const eosio::checksum256 &fromNode, const eosio::checksum256 &toNode)
+    EdgesBetween DocumentGraph::edgesBetween(const eosio::checksum256 &fromNode, const eosio::checksum256 &toNode)
     {
-        std::vector<Edge> edges;
-
         // this index uniquely identifies all edges that share this fromNode and toNode
-        uint64_t index = concatHash(fromNode, toNode);
-        Edge::edge_table e_t(m_contract, m_contract.value);
-        auto from_name_index = e_t.get_index<eosio::name("byfromto")>();
-        auto itr = from_name_index.find(index);
+        return EdgesBetween(m_contract, indexKey(fromNode, toNode), concatHash(fromNode, toNode));
+    }
+
+    EdgesFrom DocumentGraph::edgesFrom(const eosio::checksum256 &fromNode, const eosio::name &edgeName)
+    {
+        // this index uniquely identifies all edges that share this fromNode and edgeName
+        return EdgesFrom(m_contract, indexKey(fromNode, edgeName), concatHash(fromNode, edgeName));
+    }
+
+    EdgesTo DocumentGraph::edgesTo(const eosio::checksum256 &toNode, const eosio::name &edgeName)
+    {
+        // this index uniquely identifies all edges that share this toNode and edgeName
+        return EdgesTo(m_contract, indexKey(toNode, edgeName), concatHash(toNode, edgeName));
+    }
 
-        while (itr != from_name_index.end() && itr->by_from_node_to_node_index() == index)
+    bool DocumentGraph::hasEdgesFrom(const eosio::checksum256 &fromNode, const eosio::name &edgeName)
+    {
+        return edgesFrom(fromNode, edgeName).exists();
+    }
+
+    Edge DocumentGraph::getEdgeFromOrFail(const eosio::checksum256 &fromNode, const eosio::name &edgeName)
+    {
+        auto [exists, edge] = edgesFrom(fromNode, edgeName).first();
+        if (!exists)
         {
-            edges.push_back(*itr);
-            itr++;
+            eosio::check(false, "no edges exist: from " + readableHash(fromNode) + " with name " + edgeName.to_string());
         }
+        return edge;
+    }
 
-        return edges;
+    std::vector<Edge> DocumentGraph::getEdges(const eosio::checksum256 &fromNode, const eosio::checksum256 &toNode)
+    {
+        auto range = edgesBetween(fromNode, toNode);
+        return std::vector<Edge>(range.begin(), range.end());
     }
 
     std::vector<Edge> DocumentGraph::getEdgesOrFail(const eosio::checksum256 &fromNode, const eosio::checksum256 &toNode)
@@ -32,21 +52,8 @@ namespace hypha
 
     std::vector<Edge> DocumentGraph::getEdgesFrom(const eosio::checksum256 &fromNode, const eosio::name &edgeName)
     {
-        std::vector<Edge> edges;
-
-        // this index uniquely identifies all edges that share this fromNode and edgeName
-        uint64_t index = concatHash(fromNode, edgeName);
-        Edge::edge_table e_t(m_contract, m_contract.value);
-        auto from_name_index = e_t.get_index<eosio::name("byfromname")>();
-        auto itr = from_name_index.find(index);
-
-        while (itr != from_name_index.end() && itr->by_from_node_edge_name_index() == index)
-        {
-            edges.push_back(*itr);
-            itr++;
-        }
-
-        return edges;
+        auto range = edgesFrom(fromNode, edgeName);
+        return std::vector<Edge>(range.begin(), range.end());
     }
 
     std::vector<Edge> DocumentGraph::getEdgesFromOrFail(const eosio::checksum256 &fromNode, const eosio::name &edgeName)
@@ -58,21 +65,8 @@ namespace hypha
 
     std::vector<Edge> DocumentGraph::getEdgesTo(const eosio::checksum256 &toNode, const eosio::name &edgeName)
     {
-        std::vector<Edge> edges;
-
-        // this index uniquely identifies all edges that share this toNode and edgeName
-        uint64_t index = concatHash(toNode, edgeName);
-        Edge::edge_table e_t(m_contract, m_contract.value);
-        auto from_name_index = e_t.get_index<eosio::name("bytoname")>();
-        auto itr = from_name_index.find(index);
-
-        while (itr != from_name_index.end() && itr->by_to_node_edge_name_index() == index)
-        {
-            edges.push_back(*itr);
-            itr++;
-        }
-
-        return edges;
+        auto range = edgesTo(toNode, edgeName);
+        return std::vector<Edge>(range.begin(), range.end());
     }
 
     std::vector<Edge> DocumentGraph::getEdgesToOrFail(const eosio::checksum256 &toNode, const eosio::name &edgeName)
@@ -1,5 +1,6 @@
 #include <document_graph/document.hpp>
 #include <document_graph/edge.hpp>
+#include <document_graph/edge_range.hpp>
 #include <document_graph/util.hpp>
 
 namespace hypha
@@ -27,9 +28,9 @@ namespace hypha
         edge_table e_t(_contract, _contract.value);
         e_t.emplace(_contract, [&](auto &e) {
             e.id = concatHash(_from_node, _to_node, _edge_name);
-            e.from_node_edge_name_index = concatHash(_from_node, _edge_name);
-            e.from_node_to_node_index = concatHash(_from_node, _to_node);
-            e.to_node_edge_name_index = concatHash(_to_node, _edge_name);
+            e.from_node_edge_name_index = indexKey(_from_node, _edge_name);
+            e.from_node_to_node_index = indexKey(_from_node, _to_node);
+            e.to_node_edge_name_index = indexKey(_to_node, _edge_name);
             e.creator = _creator;
             e.contract = _contract;
             e.from_node = _from_node;
@@ -76,14 +77,12 @@ namespace hypha
                    const eosio::checksum256 &_from_node,
                    const eosio::name &_edge_name)
     {
-        edge_table e_t(_contract, _contract.value);
-        auto fromEdgeIndex = e_t.get_index<eosio::name("byfromname")>();
-        auto index = concatHash(_from_node, _edge_name);
-        auto itr = fromEdgeIndex.find(index);
+        // falls back to the legacy key until quests::reindexedges has completed
+        auto [exists, edge] = EdgesFrom(_contract, indexKey(_from_node, _edge_name), concatHash(_from_node, _edge_name)).first();
 
-        eosio::check(itr != fromEdgeIndex.end() && itr->from_node_edge_name_index == index, "edge does not exist: from " + readableHash(_from_node) + " with edge name of " + _edge_name.to_string());
+        eosio::check(exists, "edge does not exist: from " + readableHash(_from_node) + " with edge name of " + _edge_name.to_string());
 
-        return *itr;
+        return edge;
     }
 
     // static getter
@@ -91,11 +90,9 @@ namespace hypha
                       const eosio::checksum256 &_from_node,
                       const eosio::name &_edge_name)
     {
-        edge_table e_t(_contract, _contract.value);
-        auto fromEdgeIndex = e_t.get_index<eosio::name("byfromname")>();
-        auto index = concatHash(_from_node, _edge_name);
+        EdgesFrom range(_contract, indexKey(_from_node, _edge_name), concatHash(_from_node, _edge_name));
         std::vector<Edge> edges;
-        for (auto itr = fromEdgeIndex.find(index); itr != fromEdgeIndex.end(); ++itr) {
+        for (auto itr = range.begin(); itr != range.end(); ++itr) {
             edges.push_back(*itr);
         }
 
@@ -107,17 +104,7 @@ namespace hypha
                                             const eosio::checksum256 &_from_node,
                                             const eosio::name &_edge_name)
     {
-        edge_table e_t(_contract, _contract.value);
-        auto fromEdgeIndex = e_t.get_index<eosio::name("byfromname")>();
-        auto index = concatHash(_from_node, _edge_name);
-        auto itr = fromEdgeIndex.find(index);
-
-        if (itr != fromEdgeIndex.end() && itr->from_node_edge_name_index == index)
-        {
-            return std::pair<bool, Edge> (true, *itr);
-        }
-
-        return std::pair<bool, Edge>(false, Edge{});
+        return EdgesFrom(_contract, indexKey(_from_node, _edge_name), concatHash(_from_node, _edge_name)).first();
     }
 
     // static getter
@@ -137,9 +124,9 @@ namespace hypha
     {
         // update indexes prior to save
         id = concatHash(from_node, to_node, edge_name);
-        from_node_edge_name_index = concatHash(from_node, edge_name);
-        from_node_to_node_index = concatHash(from_node, to_node);
-        to_node_edge_name_index = concatHash(to_node, edge_name);
+        from_node_edge_name_index = indexKey(from_node, edge_name);
+        from_node_to_node_index = indexKey(from_node, to_node);
+        to_node_edge_name_index = indexKey(to_node, edge_name);
 
         edge_table e_t(getContract(), getContract().value);
         e_t.emplace(getContract(), [&](auto &e) {
@@ -148,6 +135,41 @@ namespace hypha
         });
     }
 
+    // static
+    std::pair<bool, uint64_t> Edge::reindex(const eosio::name &_contract, const uint64_t &_start, const uint64_t &_batch_size)
+    {
+        edge_table e_t(_contract, _contract.value);
+        auto itr = e_t.lower_bound(_start);
+        uint64_t count = 0;
+
+        while (itr != e_t.end() && count < _batch_size)
+        {
+            uint64_t from_name = indexKey(itr->from_node, itr->edge_name);
+            uint64_t from_to = indexKey(itr->from_node, itr->to_node);
+            uint64_t to_name = indexKey(itr->to_node, itr->edge_name);
+
+            if (itr->from_node_edge_name_index != from_name ||
+                itr->from_node_to_node_index != from_to ||
+                itr->to_node_edge_name_index != to_name)
+            {
+                e_t.modify(itr, _contract, [&](auto &e) {
+                    e.from_node_edge_name_index = from_name;
+                    e.from_node_to_node_index = from_to;
+                    e.to_node_edge_name_index = to_name;
+                });
+            }
+            itr++;
+            count++;
+        }
+
+        if (itr != e_t.end())
+        {
+            return std::pair<bool, uint64_t>(true, itr->id);
+        }
+
+        return std::pair<bool, uint64_t>(false, 0);
+    }
+
     void Edge::erase()
     {
         edge_table e_t(getContract(), getContract().value);
@@ -50,4 +50,32 @@ namespace hypha
         return toUint64(readableHash(sha) + label.to_string());
     }
 
+    // splitmix64 finalizer
+    const uint64_t mix64(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xbf58476d1ce4e5b9ULL;
+        x ^= x >> 27;
+        x *= 0x94d049bb133111ebULL;
+        x ^= x >> 31;
+        return x;
+    }
+
+    // the bytes of a checksum are already uniformly distributed, folding the words is enough
+    const uint64_t foldHash(const eosio::checksum256 &sha)
+    {
+        auto words = sha.get_array();
+        return (uint64_t)(words[0] >> 64) ^ (uint64_t)words[0] ^ (uint64_t)(words[1] >> 64) ^ (uint64_t)words[1];
+    }
+
+    const uint64_t indexKey(const eosio::checksum256 &sha1, const eosio::checksum256 &sha2)
+    {
+        return mix64(foldHash(sha1) ^ mix64(foldHash(sha2) + 0x9e3779b97f4a7c15ULL));
+    }
+
+    const uint64_t indexKey(const eosio::checksum256 &sha, const eosio::name &label)
+    {
+        return mix64(foldHash(sha) ^ mix64(label.value + 0x9e3779b97f4a7c15ULL));
+    }
+
 } // namespace hypha
\ No newline at end of file
@@ -49,62 +49,74 @@ asset sale::token_for_usd(asset usd_quantity, asset token) {
   update_price();
 
   soldtable s = sold.get_or_create(get_self(), soldtable());
+  price_table p = price.get();
  
   double usd_total = double(usd_quantity.amount) / asset_factor_d(usd_quantity);
   double usd_remaining = usd_total * asset_factor_d(token);
-  double token_amount = 0.0;
 
-  auto ritr = rounds.begin(); //rounds.find(p -> current_round);
+  print("token for usd_quantity "+usd_quantity.to_string());
 
-  uint64_t round_start_volume = 0;
+  auto ritr = rounds.require_find(p.current_round_id, "price table has invalid round id");
+  check(ritr->usd_total.has_value(), "rounds have no usd totals - run calcrounds");
 
-  print("token for usd_quantity "+usd_quantity.to_string());
+  double hypha_usd = double(ritr->hypha_usd.amount) / asset_factor_d(ritr->hypha_usd);
 
-  while(ritr != rounds.end() && usd_remaining > 0) {
-    uint64_t round_end_volume = ritr->max_sold;
+  // price of available tokens
+  double usd_available = (ritr->max_sold - s.total_sold) * hypha_usd;
 
-    if (s.total_sold < round_end_volume) {
+  if (usd_available >= usd_remaining) {
+    return asset(usd_remaining / hypha_usd, hypha_symbol);
+  }
 
-      // TODO fix
-      double hypha_usd = double(ritr->hypha_usd.amount) / asset_factor_d(ritr->hypha_usd);
-      print(" | "+std::to_string(ritr->id) + " | ");
+  // the purchase ends in the first round whose cumulative value covers it
+  double usd_target = ritr->usd_total.value() + (usd_remaining - usd_available);
 
-      print(" hypha_usd "+std::to_string(hypha_usd));
+  auto rounds_by_usd_total = rounds.get_index<"byusdtotal"_n>();
+  auto litr = rounds_by_usd_total.lower_bound(usd_target);
 
-      // num available
-      double available_in_round = round_end_volume - std::max(round_start_volume, s.total_sold);
+  if (litr == rounds_by_usd_total.end()) {
+    auto lastitr = rounds.rbegin();
+    double usd_left = usd_available + lastitr->usd_total.value() - ritr->usd_total.value();
+    check(false, "sale: not enough funds available. requested USD value: "+std::to_string(usd_total) + 
+    " available USD value: "+std::to_string(usd_left / asset_factor_d(token)) + " max vol: " + std::to_string(lastitr->max_sold));
+  }
 
-      print(" available_in_round "+std::to_string(available_in_round));
+  auto previtr = rounds.require_find(litr->id - 1, "rounds must be continuous");
 
-      // price of available tokens
-      double usd_available = available_in_round * hypha_usd;
+  double last_hypha_usd = double(litr->hypha_usd.amount) / asset_factor_d(litr->hypha_usd);
+  double usd_in_round = usd_target - previtr->usd_total.value();
+  double token_amount = (previtr->max_sold - s.total_sold) + usd_in_round / last_hypha_usd;
 
-      print(" usd_available "+std::to_string(usd_available));
-      print(" usd_remaining "+std::to_string(usd_remaining));
+  print(" done token_amount "+std::to_string(token_amount));
 
-      // if < usd amount remaining -> calculate, add, and exit
-      if (usd_available >= usd_remaining) {
-        token_amount += usd_remaining / hypha_usd;
-        print(" done token_amount "+std::to_string(token_amount));
-        usd_remaining = 0;
-        break;
-      } else {
-        usd_remaining -= usd_available;
-        token_amount += available_in_round;
-      }
-    }
-    
-    round_start_volume = round_end_volume;
-    ritr++;
+  return asset(token_amount, hypha_symbol);
+}
 
-    double asset_factor = asset_factor_d(token);
+double sale::round_usd(uint64_t volume, asset hypha_usd) {
+  return volume * (double(hypha_usd.amount) / asset_factor_d(hypha_usd));
+}
 
-    check(ritr != rounds.end(), "sale: not enough funds available. requested USD value: "+std::to_string(usd_total) + 
-    " available USD value: "+std::to_string( (usd_total * asset_factor - usd_remaining) / asset_factor) + " max vol: " + std::to_string(round_end_volume));
+// recomputes the cumulative usd value of round_id and all rounds after it
+void sale::update_round_totals(uint64_t round_id) {
+  uint64_t prev_vol = 0;
+  double usd_total = 0.0;
 
+  auto previtr = rounds.find(round_id - 1);
+  if (previtr != rounds.end()) {
+    prev_vol = previtr -> max_sold;
+    usd_total = previtr -> usd_total.value_or(0);
   }
 
-  return asset(token_amount, hypha_symbol);
+  auto ritr = rounds.find(round_id);
+
+  while(ritr != rounds.end()) {
+    usd_total += round_usd(ritr->max_sold - prev_vol, ritr->hypha_usd);
+    rounds.modify(ritr, _self, [&](auto& item) {
+      item.usd_total.emplace(usd_total);
+    });
+    prev_vol = ritr->max_sold;
+    ritr++;
+  }
 }
 
 void sale::purchase_usd(name buyer, asset usd_quantity, string paymentSymbol, string memo) {
@@ -129,8 +141,10 @@ void sale::purchase_usd(name buyer, asset usd_quantity, string paymentSymbol, st
 
   asset token_quantity = asset(token_amount, token_symbol);
   
+  uint64_t day = current_day();
+
   auto sitr = dailystats.find(buyer.value);
-  if (sitr != dailystats.end()) {
+  if (sitr != dailystats.end() && sitr->day.value_or(0) == day) {
     tokens_purchased = sitr->tokens_purchased;
   }
   
@@ -149,10 +163,12 @@ void sale::purchase_usd(name buyer, asset usd_quantity, string paymentSymbol, st
     dailystats.emplace(get_self(), [&](auto& s) {
       s.buyer_account = buyer;
       s.tokens_purchased = token_amount;
+      s.day.emplace(day);
     });
   } else {
     dailystats.modify(sitr, get_self(), [&](auto& s) {
-      s.tokens_purchased += token_amount;
+      s.tokens_purchased = tokens_purchased + token_amount;
+      s.day.emplace(day);
     }); 
   }
   
@@ -290,13 +306,15 @@ void sale::newpayment(name recipientAccount, string paymentSymbol, string paymen
 void sale::onperiod() {
   require_auth(get_self());
   
-  auto sitr = dailystats.begin();
-  
-  while (sitr != dailystats.end()) {
-    sitr = dailystats.erase(sitr);
-  }
+  day_epoch_table d = dayepoch.get_or_create(get_self(), day_epoch_table());
+  d.day += 1;
+  d.timestamp = current_time_point().sec_since_epoch();
+  dayepoch.set(d, get_self());
 
+}
 
+uint64_t sale::current_day() {
+  return dayepoch.get_or_create(get_self(), day_epoch_table()).day;
 }
 
 void sale::updatelimit(asset citizen_limit, asset resident_limit, asset visitor_limit) {
@@ -334,29 +352,22 @@ void sale::update_price() {
 
   configtable c = config.get_or_create(get_self(), configtable());
 
-  auto ritr = rounds.begin();
-
-  while(true) {
-    
-    check(ritr != rounds.end(), "No more rounds - sold out");
-
-    if (total_sold < ritr -> max_sold) {
-      p.current_round_id = ritr -> id;
-      p.hypha_usd = ritr -> hypha_usd;
-      p.remaining = ritr->max_sold - total_sold;
+  // the current round is the first one not sold out
+  auto rounds_by_max_sold = rounds.get_index<"bymaxsold"_n>();
+  auto ritr = rounds_by_max_sold.upper_bound(total_sold);
 
-      price.set(p, get_self());
+  check(ritr != rounds_by_max_sold.end(), "No more rounds - sold out");
 
-      c.hypha_usd = ritr -> hypha_usd;
-      c.timestamp = current_time_point().sec_since_epoch();
+  p.current_round_id = ritr -> id;
+  p.hypha_usd = ritr -> hypha_usd;
+  p.remaining = ritr->max_sold - total_sold;
 
-      config.set(c, get_self());
+  price.set(p, get_self());
 
-      break;
-    }
+  c.hypha_usd = ritr -> hypha_usd;
+  c.timestamp = current_time_point().sec_since_epoch();
 
-    ritr++;
-  }
+  config.set(c, get_self());
 
   price_history_update();
 
@@ -371,12 +382,15 @@ ACTION sale::addround(uint64_t volume, asset hypha_usd) {
   check(hypha_usd.symbol.precision() == 2, "expected precision 2 for HYPHA sale");
 
   uint64_t prev_vol = 0;
+  double prev_usd_total = 0.0;
 
-  auto rounds_number = std::distance(rounds.begin(), rounds.end());
+  auto rounds_number = rounds.begin() == rounds.end() ? 0 : rounds.rbegin()->id + 1;
 
   auto previtr = rounds.find(rounds_number - 1);
   if (previtr != rounds.end()) {
+    check(previtr -> usd_total.has_value(), "rounds have no usd totals - run calcrounds");
     prev_vol = previtr -> max_sold;
+    prev_usd_total = previtr -> usd_total.value();
   } else {
     check(rounds_number == 0, "invalid round id - must be continuous");
   }
@@ -385,6 +399,7 @@ ACTION sale::addround(uint64_t volume, asset hypha_usd) {
     item.id = rounds_number;
     item.hypha_usd = hypha_usd;
     item.max_sold = prev_vol + volume; 
+    item.usd_total.emplace(prev_usd_total + round_usd(volume, hypha_usd));
   });
 }
 
@@ -414,6 +429,35 @@ ACTION sale::updatevol(uint64_t round_id, uint64_t volume) {
     ritr++;
   }
 
+  update_round_totals(round_id);
+
+}
+
+// rewrites the rounds with their usd totals - rows written before the rounds indexes existed have no index entries
+ACTION sale::calcrounds() {
+  require_auth(get_self());
+
+  std::vector<round_table> all_rounds;
+  auto ritr = rounds.begin();
+  while(ritr != rounds.end()) {
+    all_rounds.push_back(*ritr);
+    ritr = rounds.erase(ritr);
+  }
+
+  uint64_t prev_vol = 0;
+  double usd_total = 0.0;
+
+  for (auto & r : all_rounds) {
+    usd_total += round_usd(r.max_sold - prev_vol, r.hypha_usd);
+    prev_vol = r.max_sold;
+    rounds.emplace(_self, [&](auto& item) {
+      item.id = r.id;
+      item.max_sold = r.max_sold;
+      item.hypha_usd = r.hypha_usd;
+      item.usd_total.emplace(usd_total);
+    });
+  }
+
 }
 
 ACTION sale::initsale() {
@@ -469,6 +513,7 @@ ACTION sale::incprice() {
     ritr++;
   }
 
+  update_round_totals(p.current_round_id);
   update_price();
 }
 
@@ -14,6 +14,7 @@ ACTION dao::updatevoice (const uint64_t & start, const name & scope) {
   
   uint64_t cutoff_date = active_cutoff_date();
   cs_points_tables cspoints_t(contracts::harvest, contracts::harvest.value);
+  utils::rank_resolver cs_rank(contracts::harvest, rankings::cs);
   voice_tables voices_t(get_self(), campaign_scope.value);
   auto vitr = start == 0 ? voices_t.begin() : voices_t.find(start);
   if (start == 0) {
@@ -28,7 +29,7 @@ ACTION dao::updatevoice (const uint64_t & start, const name & scope) {
       auto csitr = cspoints_t.find(vitr->account.value);
       uint64_t points = 0;
       if (csitr != cspoints_t.end()) {
-        points = csitr->rank;
+        points = cs_rank.rank(csitr->by_cs_points(), csitr->rank);
       }
       print("account: ", vitr->account, ", points: ", points, scope);
       set_voice(vitr->account, points, scope);
@@ -100,6 +101,7 @@ ACTION dao::addvoice(const uint64_t & start, const name & scope) {
   check(existing_scope, "scope must exist");
 
   cs_points_tables cspoints_t(contracts::harvest, contracts::harvest.value);
+  utils::rank_resolver cs_rank(contracts::harvest, rankings::cs);
 
   voice_tables voices_t(get_self(), campaign_scope.value);
   auto vitr = start == 0 ? voices_t.begin() : voices_t.find(start);
@@ -112,7 +114,7 @@ ACTION dao::addvoice(const uint64_t & start, const name & scope) {
     uint64_t voice_amount = 0;
 
     if (csitr != cspoints_t.end()) {
-      voice_amount = calculate_decay(csitr->rank);
+      voice_amount = calculate_decay(cs_rank.rank(csitr->by_cs_points(), csitr->rank));
     }
 
     print("account: ", vitr->account, ", points: ", voice_amount, scope);
@@ -151,62 +153,126 @@ ACTION dao::decayvoices () {
   ) {
     c.t_voicedecay = now;
     cycle_t.set(c, get_self());
-    uint64_t batch_size = config_get(name("batchsize"));
-    decayvoice(0, batch_size);
+    decay_voice();
   }
 }
 
-ACTION dao::decayvoice (const uint64_t & start, const uint64_t & chunksize) {
-  require_auth(get_self());
-
-  voice_tables voices(get_self(), campaign_scope.value);
-
-  print("decaying voices!\n", "chunksize:", chunksize, "\n");
+void dao::decay_voice () {
 
   uint64_t percentage_decay = config_get(name("vdecayprntge"));
   check(percentage_decay <= 100, "Voice decay parameter can not be more than 100%.");
-  
-  auto vitr = voices.lower_bound(start);
-  uint64_t count = 0;
 
   double multiplier = (100.0 - (double)percentage_decay) / 100.0;
 
-  while (vitr != voices.end() && count < chunksize) {
+  voice_decay_tables voicedecay_t(get_self(), get_self().value);
 
-    print("account:", vitr->account, "\n");
+  for (auto & s : scopes) {
+    auto vditr = voicedecay_t.find(s.value);
+    if (vditr != voicedecay_t.end()) {
+      voicedecay_t.modify(vditr, _self, [&](auto & item){
+        item.factor *= multiplier;
+      });
+    } else {
+      voicedecay_t.emplace(_self, [&](auto & item){
+        item.scope = s;
+        item.factor = multiplier;
+      });
+    }
+  }
+}
 
-    for (auto & s : scopes) {
-      voice_tables voice_t(get_self(), s.value);
-      auto voice_itr = voice_t.find(vitr->account.value);
+double dao::voice_decay_factor (const name & scope) {
+  voice_decay_tables voicedecay_t(get_self(), get_self().value);
+  auto vditr = voicedecay_t.find(scope.value);
+  return vditr != voicedecay_t.end() ? vditr->factor : 1.0;
+}
 
-      if (voice_itr != voice_t.end()) {
-        voice_t.modify(voice_itr, _self, [&](auto & v){
-          v.balance *= multiplier;
-        });
-      }
-    }
+uint64_t dao::voice_balance (const voice_table & v, const double & factor) {
+  double written = v.decay_factor.value_or(1.0);
+  if (written == factor) {
+    return v.balance;
+  }
+  return v.balance * (factor / written);
+}
 
-    vitr++;
-    count += 2;
+void dao::write_voice (voice_table & v, const uint64_t & amount, const double & factor) {
+  v.balance = amount;
+  v.decay_factor.emplace(factor);
+}
+
+double dao::pool_units (const uint64_t & balance, const double & decay_factor, const double & pool_factor) {
+  double scale = decay_factor * pool_factor;
+  return scale > 0 ? balance / scale : 0.0;
+}
+
+uint64_t dao::get_voice (const voice_table & v, const name & scope) {
+  double factor = voice_decay_factor(scope);
+
+  delegate_trust_tables deltrust_t(get_self(), scope.value);
+  auto ditr = deltrust_t.find(v.account.value);
+  if (ditr == deltrust_t.end() || !ditr->pool_factor.has_value()) {
+    return voice_balance(v, factor);
   }
 
-  if (vitr != voices.end()) {
-    send_deferred_transaction(
-      permission_level(get_self(), "active"_n),
-      get_self(),
-      "decayvoice"_n,
-      std::make_tuple(vitr->account.value, chunksize)
-    );
+  delegation_pool_tables pools_t(get_self(), scope.value);
+  auto pitr = pools_t.find(ditr->delegatee.value);
+  if (pitr == pools_t.end() || pitr->epoch != ditr->pool_epoch.value_or(0)) {
+    return 0;
+  }
+
+  uint64_t balance = voice_balance(v, factor);
+  double written = ditr->pool_factor.value();
+  double live = pool_live_factor(*pitr, scope);
+  if (written == live) {
+    return balance;
+  }
+  if (!(written > 0)) {
+    return 0;
   }
+  // what the pool spent is rounded down, as a delegator's own vote was
+  return balance - uint64_t(balance * (1.0 - live / written));
 }
 
+// writes a voice balance, keeping the delegation pool of a delegator in sync
+void dao::store_voice (const name & user, const name & scope, const uint64_t & amount) {
+  voice_tables voice_t(get_self(), scope.value);
+  auto vitr = voice_t.find(user.value);
+  double factor = voice_decay_factor(scope);
 
+  delegate_trust_tables deltrust_t(get_self(), scope.value);
+  auto ditr = deltrust_t.find(user.value);
 
-ACTION dao::voteonbehalf (const name & voter, const uint64_t & proposal_id, const uint64_t & amount, const name & option) {
-  require_auth(get_self());
-  vote_aux(voter, proposal_id, amount, option, true);
+  if (ditr != deltrust_t.end() && ditr->pool_factor.has_value()) {
+    delegation_pool_tables pools_t(get_self(), scope.value);
+    pool_link link = refresh_pool(pools_t, ditr->delegatee);
+    auto pitr = pools_t.find(ditr->delegatee.value);
+
+    // the units written before are kept for the votes the pool cast before this write
+    double written_units = 0.0;
+    if (vitr != voice_t.end()) {
+      written_units = pool_units(vitr->balance, vitr->decay_factor.value_or(1.0), ditr->pool_factor.value());
+    }
+    double old_units = ditr->pool_epoch.value_or(0) == pitr->epoch ? written_units : 0.0;
+
+    add_pool_units(pools_t, ditr->delegatee, pool_units(amount, factor, link.live_factor) - old_units);
+    deltrust_t.modify(ditr, _self, [&](auto & item){
+      write_pool_share(item, link.live_factor, pitr->epoch, written_units, item.pool_epoch.value_or(0));
+    });
+  }
+
+  if (vitr == voice_t.end()) {
+    voice_t.emplace(_self, [&](auto & voice){
+      voice.account = user;
+      write_voice(voice, amount, factor);
+    });
+  } else {
+    voice_t.modify(vitr, _self, [&](auto & voice){
+      write_voice(voice, amount, factor);
+    });
+  }
 }
 
+
 ACTION dao::changetrust (const name & user, const bool & trust) {
   require_auth(get_self());
 
@@ -250,6 +316,14 @@ ACTION dao::delegate (const name & delegator, const name & delegatee, const name
 
   check(no_cycles, "can not add delegatee, cycles are not allowed");
 
+  if (scope != dhos_scope) {
+    if (ditr != deltrust_t.end()) {
+      leave_pool(delegator, scope);
+    }
+    join_pool(delegator, delegatee, scope);
+    return;
+  }
+
   if (ditr != deltrust_t.end()) {
     deltrust_t.modify(ditr, _self, [&](auto & item){
       item.delegatee = delegatee;
@@ -279,107 +353,517 @@ ACTION dao::undelegate (const name & delegator, const name & scope) {
     require_auth(ditr->delegatee);
   }
 
-  deltrust_t.erase(ditr);
+  leave_pool(delegator, scope);
 }
 
-ACTION dao::mimicvote (
-  const name & delegatee, 
-  const name & delegator, 
-  const name & scope, 
-  const uint64_t & proposal_id, 
-  const double & percentage_used, 
-  const name & option, 
-  const uint64_t chunksize) {
-
+ACTION dao::pooldelegs (const name & scope, const uint64_t & start, const uint64_t & chunksize) {
   require_auth(get_self());
+  check(scope != dhos_scope, "dho delegations are not pooled");
 
+  voice_tables voice_t(get_self(), scope.value);
   delegate_trust_tables deltrust_t(get_self(), scope.value);
-  auto deltrusts_by_delegatee_delegator = deltrust_t.get_index<"byddelegator"_n>();
+  auto ditr = deltrust_t.lower_bound(start);
+  uint64_t count = 0;
 
-  voice_tables voices(get_self(), scope.value);
+  while (ditr != deltrust_t.end() && count < chunksize) {
+    name delegator = ditr->delegator;
+    name delegatee = ditr->delegatee;
+    bool pooled = ditr->pool_factor.has_value();
+    ditr++;
 
-  uint128_t id = (uint128_t(delegatee.value) << 64) + delegator.value;
+    if (!pooled && voice_t.find(delegator.value) != voice_t.end()) {
+      join_pool(delegator, delegatee, scope);
+    }
+    count++;
+  }
 
-  auto ditr = deltrusts_by_delegatee_delegator.lower_bound(id);
-  uint64_t count = 0;
+  if (ditr != deltrust_t.end()) {
+    send_deferred_transaction(
+      permission_level(get_self(), "active"_n),
+      get_self(),
+      "pooldelegs"_n,
+      std::make_tuple(scope, ditr->delegator.value, chunksize)
+    );
+  }
+}
 
-  while (ditr != deltrusts_by_delegatee_delegator.end() && ditr->delegatee == delegatee && count < chunksize) {
+void dao::join_pool (const name & delegator, const name & delegatee, const name & scope) {
+  voice_tables voice_t(get_self(), scope.value);
+  auto vitr = voice_t.require_find(delegator.value, "delegator does not have voice");
 
-    name voter = ditr->delegator;
+  double factor = voice_decay_factor(scope);
+  uint64_t current = voice_balance(*vitr, factor);
+  uint64_t now = eosio::current_time_point().sec_since_epoch();
 
-    auto vitr = voices.find(voter.value);
-    if (vitr != voices.end()) {
+  delegate_trust_tables deltrust_t(get_self(), scope.value);
+  delegation_pool_tables pools_t(get_self(), scope.value);
+
+  if (pools_t.find(delegatee.value) == pools_t.end()) {
+    pools_t.emplace(_self, [&](auto & pool){
+      pool.delegatee = delegatee;
+      pool.parent = name();
+      pool.units = 0.0;
+      pool.factor = 1.0;
+      pool.epoch = 0;
+      pool.delegators = 0;
+      pool.parent_factor = 1.0;
+      pool.parent_epoch = 0;
+      pool.linked = now;
+      pool.votes = 0;
+      pool.nonneutral = false;
+      pool.credit_from = name();
+    });
 
-      send_deferred_transaction(
-        permission_level(get_self(), "active"_n),
-        get_self(),
-        "voteonbehalf"_n,
-        std::make_tuple(voter, proposal_id, uint64_t(vitr->balance * percentage_used), option)
-      );
+    // a delegatee that delegates itself is spent by the votes of its own delegatee
+    auto parent_itr = deltrust_t.find(delegatee.value);
+    if (parent_itr != deltrust_t.end() && parent_itr->pool_factor.has_value()) {
+      link_pool(pools_t, delegatee, parent_itr->delegatee);
     }
+  }
 
-    ditr++;
-    count++;
+  pool_link link = refresh_pool(pools_t, delegatee);
+  auto pitr = pools_t.find(delegatee.value);
+
+  add_pool_units(pools_t, delegatee, pool_units(current, factor, link.live_factor));
+  pools_t.modify(pitr, _self, [&](auto & pool){
+    pool.delegators += 1;
+  });
+
+  voice_t.modify(vitr, _self, [&](auto & voice){
+    write_voice(voice, current, factor);
+  });
+
+  auto ditr = deltrust_t.find(delegator.value);
+  if (ditr != deltrust_t.end()) {
+    deltrust_t.modify(ditr, _self, [&](auto & item){
+      item.delegatee = delegatee;
+      write_pool_share(item, link.live_factor, pitr->epoch, 0.0, pitr->epoch);
+    });
+  } else {
+    deltrust_t.emplace(_self, [&](auto & item){
+      item.delegator = delegator;
+      item.delegatee = delegatee;
+      item.weight = 1.0;
+      item.timestamp = now;
+      write_pool_share(item, link.live_factor, pitr->epoch, 0.0, pitr->epoch);
+    });
   }
 
-  if (ditr != deltrusts_by_delegatee_delegator.end() && ditr->delegatee == delegatee) {
-    send_deferred_transaction(
-      permission_level{get_self(), "active"_n},
-      get_self(),
-      "mimicvote"_n,
-      std::make_tuple(delegatee, ditr->delegator, scope, proposal_id, percentage_used, option, chunksize)
-    );
+  // the delegator's own pool is counted and spent in the delegatee's from now on
+  link_pool(pools_t, delegator, delegatee);
+}
+
+void dao::leave_pool (const name & delegator, const name & scope) {
+  delegate_trust_tables deltrust_t(get_self(), scope.value);
+  auto ditr = deltrust_t.require_find(delegator.value, "delegator not found");
+
+  voice_tables voice_t(get_self(), scope.value);
+  auto vitr = voice_t.find(delegator.value);
+
+  double factor = voice_decay_factor(scope);
+  delegation_pool_tables pools_t(get_self(), scope.value);
+  auto pitr = pools_t.find(ditr->delegatee.value);
+
+  if (ditr->pool_factor.has_value() && pitr != pools_t.end()) {
+    pool_link link = refresh_pool(pools_t, ditr->delegatee);
+
+    settle_pool_spends(pools_t, *ditr, link, scope);
+
+    if (vitr != voice_t.end() && ditr->pool_epoch.value_or(0) == pitr->epoch) {
+      add_pool_units(pools_t, ditr->delegatee, -pool_units(vitr->balance, vitr->decay_factor.value_or(1.0), ditr->pool_factor.value()));
+    }
   }
 
+  uint64_t current = vitr != voice_t.end() ? get_voice(*vitr, scope) : 0;
+
+  unlink_pool(pools_t, delegator);
+
+  if (ditr->pool_factor.has_value() && pitr != pools_t.end()) {
+    if (pitr->delegators <= 1) {
+      // what is left are rounding residues, they leave the pools above with it
+      add_pool_units(pools_t, pitr->delegatee, -pitr->units);
+      clear_pool_spends(pitr->delegatee, scope);
+      pools_t.erase(pitr);
+    } else {
+      pools_t.modify(pitr, _self, [&](auto & pool){
+        pool.delegators -= 1;
+      });
+    }
+  }
+
+  deltrust_t.erase(ditr);
+
+  if (vitr != voice_t.end()) {
+    voice_t.modify(vitr, _self, [&](auto & voice){
+      write_voice(voice, current, factor);
+    });
+  }
 }
 
-ACTION dao::mimicrevert (const name & delegatee, const uint64_t & delegator, const name & scope, const uint64_t & proposal_id, const uint64_t & chunksize) {
+// the share of a pool's written voice the votes of the pools above it have not spent, 0 if one of them was fully spent
+double dao::pool_live_factor (const delegation_pool_table & pool, const name & scope) {
+  delegation_pool_tables pools_t(get_self(), scope.value);
 
-  require_auth(get_self());
+  double live = pool.factor;
+  name parent = pool.parent;
+  uint64_t parent_epoch = pool.parent_epoch;
+  double parent_factor = pool.parent_factor;
 
-  proposal_tables proposals_t(get_self(), get_self().value);
-  auto pitr = proposals_t.require_find(proposal_id, "proposal not found");
-  check(pitr->stage == ProposalsCommon::stage_active, "proposal stage is not active");
+  while (parent != name()) {
+    auto pitr = pools_t.find(parent.value);
+    if (pitr == pools_t.end()) {
+      break;
+    }
+    if (pitr->epoch != parent_epoch) {
+      return 0.0;
+    }
+    live *= pitr->factor / parent_factor;
+    parent = pitr->parent;
+    parent_epoch = pitr->parent_epoch;
+    parent_factor = pitr->parent_factor;
+  }
 
-  votes_tables votes_t(get_self(), proposal_id);
+  return live;
+}
 
-  delegate_trust_tables deltrust_t(get_self(), scope.value);
-  auto deltrusts_by_delegatee_delegator = deltrust_t.get_index<"byddelegator"_n>();
+// walks up to the pool that votes for this one, pools linked below a fully spent pool move to a new epoch on the way down
+dao::pool_link dao::refresh_pool (delegation_pool_tables & pools_t, const name & delegatee) {
+  std::vector<name> chain;
+  name current = delegatee;
+  while (current != name()) {
+    auto pitr = pools_t.find(current.value);
+    if (pitr == pools_t.end()) {
+      break;
+    }
+    chain.push_back(current);
+    current = pitr->parent;
+  }
+  check(!chain.empty(), "delegation pool not found");
+
+  auto ritr = pools_t.find(chain.back().value);
+
+  pool_link link;
+  link.root = chain.back();
+  link.live_factor = ritr->factor;
+  link.root_ratio = 1.0;
+  link.linked = 0;
+
+  for (int64_t i = int64_t(chain.size()) - 2; i >= 0; i--) {
+    auto parent_itr = pools_t.find(chain[i + 1].value);
+    auto pitr = pools_t.find(chain[i].value);
+
+    if (pitr->parent_epoch != parent_itr->epoch) {
+      pools_t.modify(pitr, _self, [&](auto & pool){
+        pool.units = 0.0;
+        pool.factor = 1.0;
+        pool.epoch += 1;
+        pool.parent_factor = link.live_factor;
+        pool.parent_epoch = parent_itr->epoch;
+        pool.linked = eosio::current_time_point().sec_since_epoch();
+      });
+    }
 
-  uint128_t id = (uint128_t(delegatee.value) << 64) + delegator;
+    link.root_ratio *= pitr->factor / pitr->parent_factor;
+    link.live_factor *= pitr->factor / pitr->parent_factor;
+    link.linked = std::max(link.linked, pitr->linked);
+  }
 
-  auto ditr = delegator == 0 ? deltrusts_by_delegatee_delegator.lower_bound(id) : deltrusts_by_delegatee_delegator.find(id);
+  return link;
+}
 
-  uint64_t count = 0;
+// adds units to a pool and, converted, to every pool it is linked into
+void dao::add_pool_units (delegation_pool_tables & pools_t, const name & delegatee, const double & units) {
+  double added = units;
+  auto pitr = pools_t.find(delegatee.value);
 
-  while (ditr != deltrusts_by_delegatee_delegator.end() && ditr->delegatee == delegatee && count < chunksize) {
+  while (pitr != pools_t.end()) {
+    pools_t.modify(pitr, _self, [&](auto & pool){
+      pool.units = std::max(0.0, pool.units + added);
+    });
 
-    auto vitr = votes_t.find(ditr->delegator.value);
+    if (pitr->parent == name()) {
+      break;
+    }
+    auto parent_itr = pools_t.find(pitr->parent.value);
+    if (parent_itr == pools_t.end() || parent_itr->epoch != pitr->parent_epoch) {
+      break;
+    }
+    added *= pitr->factor / pitr->parent_factor;
+    pitr = parent_itr;
+  }
+}
+
+// counts a delegator's own pool in its delegatee's, its factor is kept and follows the delegatee's live factor
+void dao::link_pool (delegation_pool_tables & pools_t, const name & delegatee, const name & parent) {
+  auto pitr = pools_t.find(delegatee.value);
+  if (pitr == pools_t.end() || pools_t.find(parent.value) == pools_t.end()) {
+    return;
+  }
+
+  pool_link link = refresh_pool(pools_t, parent);
+  auto parent_itr = pools_t.find(parent.value);
 
-    if (vitr != votes_t.end()) {
+  pools_t.modify(pitr, _self, [&](auto & pool){
+    pool.parent = parent;
+    pool.parent_factor = link.live_factor;
+    pool.parent_epoch = parent_itr->epoch;
+    pool.linked = eosio::current_time_point().sec_since_epoch();
+  });
+
+  add_pool_units(pools_t, parent, pitr->units * pitr->factor / link.live_factor);
+}
 
-      send_deferred_transaction(
-        permission_level(get_self(), "active"_n),
-        get_self(),
-        "revertvote"_n,
-        std::make_tuple(ditr->delegator, proposal_id)
-      );
-      
+// the pool votes by itself again, it keeps what the pools above it spent
+void dao::unlink_pool (delegation_pool_tables & pools_t, const name & delegatee) {
+  auto pitr = pools_t.find(delegatee.value);
+  if (pitr == pools_t.end() || pitr->parent == name()) {
+    return;
+  }
+
+  pool_link link = refresh_pool(pools_t, delegatee);
+
+  if (pools_t.find(pitr->parent.value) != pools_t.end()) {
+    add_pool_units(pools_t, pitr->parent, -pitr->units * pitr->factor / pitr->parent_factor);
+  }
+
+  pools_t.modify(pitr, _self, [&](auto & pool){
+    pool.factor = link.live_factor;
+    if (pool.factor < 1e-12) {
+      pool.factor = 1.0;
+      pool.units = 0.0;
+      pool.epoch += 1;
     }
+    pool.parent = name();
+    pool.parent_factor = 1.0;
+    pool.parent_epoch = 0;
+    pool.linked = eosio::current_time_point().sec_since_epoch();
+  });
+}
 
-    ditr++;
-    count++;
+void dao::write_pool_share (delegate_trust_table & item, const double & live_factor, const uint64_t & epoch, const double & prior_units, const uint64_t & prior_epoch) {
+  item.pool_factor.emplace(live_factor);
+  item.pool_epoch.emplace(epoch);
+  item.written.emplace(eosio::current_time_point().sec_since_epoch());
+  item.prior_units.emplace(prior_units);
+  item.prior_epoch.emplace(prior_epoch);
+}
+
+// spends percentage of the voter's pool, the pools linked into it included, returns the voice spent
+// the vote is counted on the pool, erasepartpts hands it down to the delegators as participation
+uint64_t dao::spend_pool (const name & delegatee, const name & scope, const uint64_t & proposal_id, const double & percentage, const name & option) {
+  delegation_pool_tables pools_t(get_self(), scope.value);
+  auto pitr = pools_t.find(delegatee.value);
+  if (pitr == pools_t.end()) {
+    return 0;
   }
 
-  if (ditr != deltrusts_by_delegatee_delegator.end() && ditr->delegatee == delegatee) {
-    send_deferred_transaction(
-      permission_level(get_self(), "active"_n),
-      get_self(),
-      "mimicrevert"_n,
-      std::make_tuple(delegatee, ditr->delegator.value, scope, proposal_id, chunksize)
-    );
+  pools_t.modify(pitr, _self, [&](auto & pool){
+    pool.nonneutral = (pool.votes == 0 || pool.nonneutral) && option != ProposalsCommon::neutral;
+    pool.votes += 1;
+  });
+
+  if (option == ProposalsCommon::neutral || !(percentage > 0)) {
+    return 0;
+  }
+  double used = std::min(percentage, 1.0);
+
+  double spent_per_unit = pitr->factor * voice_decay_factor(scope) * used;
+  uint64_t spent = pitr->units * spent_per_unit;
+
+  pool_spend_tables spends_t(get_self(), delegatee.value);
+  auto sitr = spends_t.find(proposal_id);
+  if (sitr == spends_t.end()) {
+    spends_t.emplace(_self, [&](auto & item){
+      item.proposal_id = proposal_id;
+      item.epoch = pitr->epoch;
+      item.spent_per_unit = spent_per_unit;
+      item.spent = spent;
+      item.timestamp = eosio::current_time_point().sec_since_epoch();
+    });
+  } else {
+    spends_t.modify(sitr, _self, [&](auto & item){
+      item.epoch = pitr->epoch;
+      item.spent_per_unit = spent_per_unit;
+      item.spent = spent;
+      item.timestamp = eosio::current_time_point().sec_since_epoch();
+    });
+  }
+
+  pools_t.modify(pitr, _self, [&](auto & pool){
+    pool.factor *= 1.0 - used;
+    if (pool.factor < 1e-12) {
+      // fully spent, delegators and linked pools of older epochs have no voice left
+      pool.factor = 1.0;
+      pool.units = 0.0;
+      pool.epoch += 1;
+    }
+  });
+
+  return spent;
+}
+
+// moves what a leaving delegator and the pool linked below it spent through the votes of the root pool on active
+// proposals into a vote of its own, so reverting the root's vote leaves it out
+void dao::settle_pool_spends (delegation_pool_tables & pools_t, const delegate_trust_table & d, const pool_link & link, const name & scope) {
+  voice_tables voice_t(get_self(), scope.value);
+  auto vitr = voice_t.find(d.delegator.value);
+
+  auto pitr = pools_t.find(d.delegatee.value);
+  auto owned_itr = pools_t.find(d.delegator.value);
+  bool direct = link.root == d.delegatee;
+
+  double units = vitr != voice_t.end() ? pool_units(vitr->balance, vitr->decay_factor.value_or(1.0), d.pool_factor.value()) : 0.0;
+  uint64_t written = d.written.value_or(d.timestamp);
+
+  pool_spend_tables spends_t(get_self(), link.root.value);
+  auto sitr = spends_t.begin();
+
+  while (sitr != spends_t.end()) {
+    name proposal_scope = active_proposal_scope(sitr->proposal_id);
+    if (proposal_scope == name()) {
+      sitr = spends_t.erase(sitr);
+      continue;
+    }
+    if (proposal_scope != scope || sitr->timestamp < d.timestamp || sitr->timestamp < link.linked) {
+      sitr++;
+      continue;
+    }
+
+    // a pool linked below the root moved to a new epoch when the root was fully spent, after the vote
+    uint64_t spent_epoch = direct ? sitr->epoch : pitr->epoch;
+
+    bool before_write = sitr->timestamp < written;
+    double vote_units = before_write ? d.prior_units.value_or(0.0) : units;
+    uint64_t vote_epoch = before_write ? d.prior_epoch.value_or(0) : d.pool_epoch.value_or(0);
+    uint64_t own = vote_epoch == spent_epoch ? uint64_t(vote_units * link.root_ratio * sitr->spent_per_unit) : 0;
+
+    uint64_t below = 0;
+    if (owned_itr != pools_t.end() && owned_itr->parent == d.delegatee && owned_itr->parent_epoch == spent_epoch && sitr->timestamp >= owned_itr->linked) {
+      below = uint64_t(owned_itr->units * owned_itr->factor / owned_itr->parent_factor * link.root_ratio * sitr->spent_per_unit);
+    }
+
+    votes_tables votes_t(get_self(), sitr->proposal_id);
+    auto hitr = votes_t.find(link.root.value);
+
+    if (own + below > 0 && hitr != votes_t.end()) {
+      uint64_t available = std::min(hitr->delegated.value_or(0), sitr->spent);
+      own = std::min(own, available);
+      below = std::min(below, available - own);
+
+      votes_t.modify(hitr, _self, [&](auto & item){
+        item.delegated.emplace(item.delegated.value_or(0) - own - below);
+      });
+
+      auto vtitr = votes_t.find(d.delegator.value);
+      if (vtitr == votes_t.end()) {
+        votes_t.emplace(_self, [&](auto & item){
+          item.proposal_id = sitr->proposal_id;
+          item.account = d.delegator;
+          item.amount = own;
+          item.favour = hitr->favour;
+          item.delegated.emplace(below);
+        });
+      } else {
+        votes_t.modify(vtitr, _self, [&](auto & item){
+          item.amount += own;
+          item.delegated.emplace(item.delegated.value_or(0) + below);
+        });
+      }
+
+      spends_t.modify(sitr, _self, [&](auto & item){
+        item.spent -= own + below;
+      });
+    }
+
+    sitr++;
   }
+}
+
+void dao::clear_pool_spends (const name & delegatee, const name & scope) {
+  pool_spend_tables spends_t(get_self(), delegatee.value);
+  auto sitr = spends_t.begin();
+  while (sitr != spends_t.end()) {
+    name proposal_scope = active_proposal_scope(sitr->proposal_id);
+    if (proposal_scope == name() || proposal_scope == scope) {
+      sitr = spends_t.erase(sitr);
+    } else {
+      sitr++;
+    }
+  }
+}
+
+// hands the votes pools cast this cycle down to their delegators as participation, and on to the pools linked
+// below them, returns the number of delegators credited
+uint64_t dao::credit_pools (const uint64_t & batch_size) {
+  double rep_multiplier = config_get(name("votedel.mul")) / 100.0;
+  uint64_t count = 0;
+
+  for (auto & s : scopes) {
+    if (s == dhos_scope) {
+      continue;
+    }
+
+    voice_tables voice_t(get_self(), s.value);
+    delegate_trust_tables deltrust_t(get_self(), s.value);
+    auto deltrusts_by_delegatee_delegator = deltrust_t.get_index<"byddelegator"_n>();
+    delegation_pool_tables pools_t(get_self(), s.value);
+    auto pools_by_votes = pools_t.get_index<"byvotes"_n>();
+
+    auto pvitr = pools_by_votes.lower_bound(1);
+    while (pvitr != pools_by_votes.end() && count < batch_size) {
+      auto pitr = pools_t.find(pvitr->delegatee.value);
+      name delegatee = pitr->delegatee;
+      name option = pitr->nonneutral ? ProposalsCommon::trust : ProposalsCommon::neutral;
+
+      auto ditr = deltrusts_by_delegatee_delegator.lower_bound((uint128_t(delegatee.value) << 64) + pitr->credit_from.value);
+      while (ditr != deltrusts_by_delegatee_delegator.end() && ditr->delegatee == delegatee && count < batch_size) {
+        name voter = ditr->delegator;
+
+        if (voice_t.find(voter.value) != voice_t.end()) {
+          add_participant(voter, option, rep_multiplier, pitr->votes);
+          add_active(voter);
+        }
 
+        auto owned_itr = pools_t.find(voter.value);
+        if (owned_itr != pools_t.end()) {
+          pools_t.modify(owned_itr, _self, [&](auto & pool){
+            pool.nonneutral = (pool.votes == 0 || pool.nonneutral) && pitr->nonneutral;
+            pool.votes += pitr->votes;
+          });
+        }
+
+        ditr++;
+        count++;
+      }
+
+      if (ditr != deltrusts_by_delegatee_delegator.end() && ditr->delegatee == delegatee) {
+        pools_t.modify(pitr, _self, [&](auto & pool){
+          pool.credit_from = ditr->delegator;
+        });
+      } else {
+        pools_t.modify(pitr, _self, [&](auto & pool){
+          pool.votes = 0;
+          pool.nonneutral = false;
+          pool.credit_from = name();
+        });
+      }
+
+      pvitr = pools_by_votes.lower_bound(1);
+    }
+  }
+
+  return count;
+}
+
+// voice scope of a proposal that can still be voted on, empty otherwise
+name dao::active_proposal_scope (const uint64_t & proposal_id) {
+  proposal_tables proposals_t(get_self(), get_self().value);
+  auto pitr = proposals_t.find(proposal_id);
+  if (pitr == proposals_t.end() || pitr->stage != ProposalsCommon::stage_active) {
+    return name();
+  }
+  std::unique_ptr<Proposal> prop = std::unique_ptr<Proposal>(ProposalsFactory::Factory(*this, pitr->type));
+  return prop->get_scope();
 }
 
 ACTION dao::dhomimicvote (const name & delegatee, const uint64_t & start, std::vector<DhoVote> votes, const uint64_t & chunksize) {
@@ -422,6 +906,14 @@ ACTION dao::testsetvoice (const name & account, const uint64_t & amount) {
 }
 
 
+ACTION dao::voiceof (const name & account, const name & scope) {
+  voice_tables voice_t(get_self(), scope.value);
+  auto vitr = voice_t.find(account.value);
+  uint64_t balance = vitr == voice_t.end() ? 0 : get_voice(*vitr, scope);
+  print("{\"account\":\"", account, "\",\"scope\":\"", scope, "\",\"voice\":", balance, "}");
+}
+
+
 void dao::set_voice (const name & user, const uint64_t & amount, const name & scope) {
   if (scope == "all"_n) {
 
@@ -429,20 +921,10 @@ void dao::set_voice (const name & user, const uint64_t & amount, const name & sc
 
     for (auto & s : scopes) {
       voice_tables voice_t(get_self(), s.value);
-      auto vitr = voice_t.find(user.value);
-
-      if (vitr == voice_t.end()) {
-        voice_t.emplace(_self, [&](auto & voice){
-          voice.account = user;
-          voice.balance = amount;
-        });
-      }
-      else {
+      if (voice_t.find(user.value) != voice_t.end()) {
         increase_size = false;
-        voice_t.modify(vitr, _self, [&](auto & voice){
-          voice.balance = amount;
-        });
       }
+      store_voice(user, s, amount);
     }
 
     if (increase_size) {
@@ -450,19 +932,7 @@ void dao::set_voice (const name & user, const uint64_t & amount, const name & sc
     }
 
   } else {
-    voice_tables voice_t(get_self(), scope.value);
-    auto vitr = voice_t.find(user.value);
-
-    if (vitr == voice_t.end()) {
-      voice_t.emplace(_self, [&](auto & voice){
-        voice.account = user;
-        voice.balance = amount;
-      });
-    } else {
-      voice_t.modify(vitr, _self, [&](auto & voice){
-        voice.balance = amount;
-      });
-    }
+    store_voice(user, scope, amount);
   }
 }
 
@@ -476,16 +946,11 @@ double dao::voice_change (const name & user, const uint64_t & amount, const bool
       auto vitr = voice_t.find(user.value);
 
       if (vitr != voice_t.end()) {
+        uint64_t current = get_voice(*vitr, s);
         if (reduce) {
-          check(amount <= vitr->balance, s.to_string() + " voice balance exceeded");
+          check(amount <= current, s.to_string() + " voice balance exceeded");
         }
-        voice_t.modify(vitr, _self, [&](auto & voice){
-          if (reduce) {
-            voice.balance -= amount;
-          } else {
-            voice.balance += amount;
-          }
-        });
+        store_voice(user, s, reduce ? current - amount : current + amount);
       }
     }
 
@@ -493,17 +958,13 @@ double dao::voice_change (const name & user, const uint64_t & amount, const bool
     voice_tables voice_t(get_self(), scope.value);
     auto vitr = voice_t.require_find(user.value, "user does not have voice");
 
+    uint64_t current = get_voice(*vitr, scope);
+
     if (reduce) {
-      check(amount <= vitr->balance, "voice balance exceeded");
-      percentage_used = amount / double(vitr -> balance);
+      check(amount <= current, "voice balance exceeded");
+      percentage_used = amount / double(current);
     }
-    voice_t.modify(vitr, _self, [&](auto & voice){
-      if (reduce) {
-        voice.balance -= amount;
-      } else {
-        voice.balance += amount;
-      }
-    });
+    store_voice(user, scope, reduce ? current - amount : current + amount);
   }
 
   return percentage_used;
@@ -515,6 +976,21 @@ void dao::erase_voice (const name & user) {
   for (auto & s : scopes) {
     voice_tables voice_t(get_self(), s.value);
     auto vitr = voice_t.find(user.value);
+
+    // the delegation is kept, only the voice leaves the delegatee's pool
+    delegate_trust_tables deltrust_t(get_self(), s.value);
+    auto ditr = deltrust_t.find(user.value);
+    if (vitr != voice_t.end() && ditr != deltrust_t.end() && ditr->pool_factor.has_value()) {
+      delegation_pool_tables pools_t(get_self(), s.value);
+      auto pitr = pools_t.find(ditr->delegatee.value);
+      if (pitr != pools_t.end()) {
+        refresh_pool(pools_t, ditr->delegatee);
+        if (ditr->pool_epoch.value_or(0) == pitr->epoch) {
+          add_pool_units(pools_t, ditr->delegatee, -pool_units(vitr->balance, vitr->decay_factor.value_or(1.0), ditr->pool_factor.value()));
+        }
+      }
+    }
+
     voice_t.erase(vitr);
   }
   
@@ -535,12 +1011,13 @@ void dao::recover_voice (const name & account) {
   DEFINE_CS_POINTS_TABLE_MULTI_INDEX
   
   cs_points_tables cspoints_t(contracts::harvest, contracts::harvest.value);
+  utils::rank_resolver cs_rank(contracts::harvest, rankings::cs);
 
   auto csitr = cspoints_t.find(account.value);
   uint64_t voice_amount = 0;
 
   if (csitr != cspoints_t.end()) {
-    voice_amount = calculate_decay(csitr->rank);
+    voice_amount = calculate_decay(cs_rank.rank(csitr->by_cs_points(), csitr->rank));
   }
 
   set_voice(account, voice_amount, "all"_n);
@@ -567,16 +1044,20 @@ uint64_t dao::calculate_decay (const uint64_t & voice_amount) {
 
 }
 
-bool dao::has_delegates (const name & voter, const name & scope) {
-  delegate_trust_tables deltrust_t(get_self(), scope.value);
-  auto deltrusts_by_delegatee = deltrust_t.get_index<"bydelegatee"_n>();
-  auto ditr = deltrusts_by_delegatee.find(voter.value);
-  return ditr != deltrusts_by_delegatee.end();
-}
-
 bool dao::is_active (const name & account, const uint64_t & cutoff_date) {
   active_tables actives_t(get_self(), get_self().value);
   auto aitr = actives_t.find(account.value);
-  return aitr != actives_t.end() && aitr->timestamp > cutoff_date;
+  if (aitr != actives_t.end() && aitr->timestamp > cutoff_date) {
+    return true;
+  }
+
+  // delegators vote through their delegatee's pool
+  delegate_trust_tables deltrust_t(get_self(), campaign_scope.value);
+  auto ditr = deltrust_t.find(account.value);
+  if (ditr == deltrust_t.end()) {
+    return false;
+  }
+  auto daitr = actives_t.find(ditr->delegatee.value);
+  return daitr != actives_t.end() && daitr->timestamp > cutoff_date;
 }
 
@@ -4,6 +4,7 @@
 #include <eosio/transaction.hpp>
 #include <harvest_table.hpp>
 #include <math.h>
+#include <map>
 
 void accounts::reset() {
   require_auth(_self);
@@ -34,6 +35,19 @@ void accounts::reset() {
 
   utils::delete_table<size_tables>(contracts::accounts, contracts::accounts.value);
 
+  utils::delete_table<rep_delta_tables>(contracts::accounts, contracts::accounts.value);
+  utils::delete_table<rep_delta_tables>(contracts::accounts, organization_scope.value);
+
+  // the rep tables are empty now, so their counts are complete
+  for (name scope : { individual_scope, organization_scope }) {
+    utils::delete_table<rep_count_tables>(contracts::accounts, scope.value);
+    rep_count_state_tables count_state(contracts::accounts, scope.value);
+    count_state.set(rep_count_state_table{ 0, true }, _self);
+  }
+
+  utils::delete_table<rank_bounds_tables>(contracts::accounts, contracts::accounts.value);
+  utils::delete_table<rank_pass_tables>(contracts::accounts, contracts::accounts.value);
+
   utils::delete_table<ban_tables>(contracts::accounts, contracts::accounts.value);
 
   utils::delete_table<delegators_tables>(contracts::accounts, contracts::accounts.value);
@@ -185,7 +199,7 @@ void accounts::pnishvouched (name sponsor, uint64_t start_account) {
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(sponsor.value, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
@@ -463,19 +477,7 @@ void accounts::addrep(name user, uint64_t amount)
     user.reputation += amount;
   });
 
-  name scope = get_scope(uitr->type);
-
-  rep_tables rep_t(get_self(), scope.value);
-
-  auto ritr = rep_t.find(user.value);
-  if (ritr == rep_t.end()) {
-    add_rep_item(user, amount, scope);
-  } else {
-    rep_t.modify(ritr, _self, [&](auto& item) {
-      item.rep += amount;
-    });
-  }
-
+  change_rep(user, int64_t(amount), get_scope(uitr->type));
 }
 
 void accounts::subrep(name user, uint64_t amount)
@@ -496,26 +498,63 @@ void accounts::subrep(name user, uint64_t amount)
     }
   });
 
-  name scope = get_scope(uitr->type);
+  change_rep(user, -int64_t(amount), get_scope(uitr->type));
+}
+
+void accounts::change_rep(name account, int64_t delta, name scope) {
+  // while rankrep is in flight the rep table stays frozen, the change is merged after the pass
+  if (utils::rank_pass_in_flight(rankpasses, scope == organization_scope ? rankings::org_rep : rankings::rep)) {
+    rep_delta_tables deltas(get_self(), scope.value);
+    auto ditr = deltas.find(account.value);
+    if (ditr == deltas.end()) {
+      deltas.emplace(_self, [&](auto& item) {
+        item.account = account;
+        item.delta = delta;
+      });
+    } else {
+      deltas.modify(ditr, _self, [&](auto& item) {
+        item.delta += delta;
+      });
+    }
+    return;
+  }
+
+  apply_rep_delta(account, delta, scope);
+}
 
+void accounts::apply_rep_delta(name account, int64_t delta, name scope) {
   rep_tables rep_t(get_self(), scope.value);
 
-  auto ritr = rep_t.find(user.value);
-  if (ritr != rep_t.end()) {
+  auto ritr = rep_t.find(account.value);
+  if (delta > 0) {
+    if (ritr == rep_t.end()) {
+      add_rep_item(account, uint64_t(delta), scope);
+    } else {
+      int64_t old_rep = ritr->rep;
+      rep_t.modify(ritr, _self, [&](auto& item) {
+        item.rep += delta;
+      });
+      count_rep(account, old_rep, ritr->rep, scope);
+    }
+  } else if (delta < 0 && ritr != rep_t.end()) {
+    uint64_t amount = uint64_t(-delta);
+    int64_t old_rep = ritr->rep;
     if (ritr->rep > amount) {
       rep_t.modify(ritr, _self, [&](auto& item) {
         item.rep -= amount;
       });
+      count_rep(account, old_rep, ritr->rep, scope);
     } else {
       rep_t.erase(ritr);
+      count_rep(account, old_rep, -1, scope);
       if (scope == individual_scope) {
         size_change("rep.sz"_n, -1);
       } else if (scope == organization_scope) {
         size_change("rep.org.sz"_n, -1);
       }
+      send_mark_dirty({ account });
     }
   }
-
 }
 
 name accounts::get_scope (name type) {
@@ -793,14 +832,14 @@ uint32_t accounts::num_transactions(name account, uint32_t limit) {
 }
 
 void accounts::rankreps() {
-  rankrep(0, 0, 200, individual_scope);
+  rankrep(0, 0, 0, utils::rank_batch_budget, individual_scope);
 }
 
 void accounts::rankorgreps() {
-  rankrep(0, 0, 200, organization_scope);
+  rankrep(0, 0, 0, utils::rank_batch_budget, organization_scope);
 }
 
-void accounts::rankrep(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name scope) {
+void accounts::rankrep(uint64_t start_val, uint64_t start_id, uint64_t current, uint64_t chunksize, name scope) {
   require_auth(_self);
 
   uint64_t total = 0;
@@ -812,27 +851,51 @@ void accounts::rankrep(uint64_t start_val, uint64_t chunk, uint64_t chunksize, n
   if (total == 0) return;
 
   rep_tables rep_t(get_self(), scope.value);
+  name ranking = scope == organization_scope ? rankings::org_rep : rankings::rep;
+  bool lazy = config_get("rank.lazy"_n) > 0;
+  utils::rank_pass<rank_bounds_tables, rank_pass_tables> pass(rankbounds, rankpasses, _self, ranking, utils::spline_curve, lazy, total, current);
 
-  uint64_t current = chunk * chunksize;
   auto rep_by_rep = rep_t.get_index<"byrep"_n>();
-  auto ritr = start_val == 0 ? rep_by_rep.begin() : rep_by_rep.lower_bound(start_val);
+  auto ritr = utils::cursor_seek(rep_by_rep, start_val, start_id);
   uint64_t count = 0;
+  std::vector<name> dirty;
 
   while (ritr != rep_by_rep.end() && count < chunksize) {
 
-    uint64_t rank = utils::spline_rank(current, total);
+    uint64_t rank = pass.next(ritr->by_rep());
 
-    rep_by_rep.modify(ritr, _self, [&](auto& item) {
-      item.rank = rank;
-    });
+    if (pass.should_write(ritr->rank, rank)) {
+      rep_by_rep.modify(ritr, _self, [&](auto& item) {
+        item.rank = rank;
+      });
+      dirty.push_back(ritr->account);
+      count += utils::rank_write_cost;
+    } else {
+      count += utils::rank_read_cost;
+    }
 
-    current++;
-    count++;
     ritr++;
   }
 
+  send_mark_dirty(dirty);
+  pass.save(ritr == rep_by_rep.end());
+
   if (ritr == rep_by_rep.end()) {
     // Done.
+    rep_delta_tables deltas(get_self(), scope.value);
+    if (deltas.begin() != deltas.end()) {
+      action merge_action(
+        permission_level{get_self(), "active"_n},
+        get_self(),
+        "mergerepdlt"_n,
+        std::make_tuple(scope)
+      );
+
+      transaction tx;
+      tx.actions.emplace_back(merge_action);
+      tx.delay_sec = 1;
+      tx.send(ranking.value, _self);
+    }
   } else {
     // recursive call
     uint64_t next_value = ritr->by_rep();
@@ -840,27 +903,59 @@ void accounts::rankrep(uint64_t start_val, uint64_t chunk, uint64_t chunksize, n
         permission_level{get_self(), "active"_n},
         get_self(),
         "rankrep"_n,
-        std::make_tuple(next_value, chunk + 1, chunksize, scope)
+        std::make_tuple(next_value, ritr->account.value, pass.position(), chunksize, scope)
     );
 
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value + 1, _self);
+    tx.send(utils::deferred_id(tx), _self);
     
   }
 
 }
 
+void accounts::mergerepdlt(name scope) {
+  require_auth(get_self());
+
+  // a new pass started, it merges the deltas when it is done
+  if (utils::rank_pass_in_flight(rankpasses, scope == organization_scope ? rankings::org_rep : rankings::rep)) return;
+
+  rep_delta_tables deltas(get_self(), scope.value);
+  uint64_t batch_size = config_get("batchsize"_n);
+  uint64_t count = 0;
+
+  auto ditr = deltas.begin();
+  while (ditr != deltas.end() && count < batch_size) {
+    apply_rep_delta(ditr->account, ditr->delta, scope);
+    ditr = deltas.erase(ditr);
+    count++;
+  }
+
+  if (ditr != deltas.end()) {
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "mergerepdlt"_n,
+      std::make_tuple(scope)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(utils::deferred_id(tx), _self);
+  }
+}
+
 void accounts::rankcbss() {
-  rankcbs(0, 0, 200, individual_scope);
+  rankcbs(0, 0, 0, utils::rank_batch_budget, individual_scope);
 }
 
 void accounts::rankorgcbss() {
-  rankcbs(0, 0, 200, organization_scope);
+  rankcbs(0, 0, 0, utils::rank_batch_budget, organization_scope);
 }
 
-void accounts::rankcbs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name scope) {
+void accounts::rankcbs(uint64_t start_val, uint64_t start_id, uint64_t current, uint64_t chunksize, name scope) {
   require_auth(_self);
 
   uint64_t total = 0;
@@ -873,25 +968,35 @@ void accounts::rankcbs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, n
   if (total == 0) return;
 
   cbs_tables cbs_t(get_self(), scope.value);
+  name ranking = scope == organization_scope ? rankings::org_cbs : rankings::cbs;
+  bool lazy = config_get("rank.lazy"_n) > 0;
+  utils::rank_pass<rank_bounds_tables, rank_pass_tables> pass(rankbounds, rankpasses, _self, ranking, utils::spline_curve, lazy, total, current);
 
-  uint64_t current = chunk * chunksize;
   auto cbs_by_cbs = cbs_t.get_index<"bycbs"_n>();
-  auto citr = start_val == 0 ? cbs_by_cbs.begin() : cbs_by_cbs.lower_bound(start_val);
+  auto citr = utils::cursor_seek(cbs_by_cbs, start_val, start_id);
   uint64_t count = 0;
+  std::vector<name> dirty;
 
   while (citr != cbs_by_cbs.end() && count < chunksize) {
 
-    uint64_t rank = utils::spline_rank(current, total);
+    uint64_t rank = pass.next(citr->by_cbs());
 
-    cbs_by_cbs.modify(citr, _self, [&](auto& item) {
-      item.rank = rank;
-    });
+    if (pass.should_write(citr->rank, rank)) {
+      cbs_by_cbs.modify(citr, _self, [&](auto& item) {
+        item.rank = rank;
+      });
+      dirty.push_back(citr->account);
+      count += utils::rank_write_cost;
+    } else {
+      count += utils::rank_read_cost;
+    }
 
-    current++;
-    count++;
     citr++;
   }
 
+  send_mark_dirty(dirty);
+  pass.save(citr == cbs_by_cbs.end());
+
   if (citr == cbs_by_cbs.end()) {
     // Done.
   } else {
@@ -901,13 +1006,13 @@ void accounts::rankcbs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, n
         permission_level{get_self(), "active"_n},
         get_self(),
         "rankcbs"_n,
-        std::make_tuple(next_value, chunk + 1, chunksize, scope)
+        std::make_tuple(next_value, citr->account.value, pass.position(), chunksize, scope)
     );
 
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value + 1, _self);
+    tx.send(utils::deferred_id(tx), _self);
     
   }
 
@@ -918,10 +1023,11 @@ void accounts::add_rep_item(name account, uint64_t reputation, name scope) {
 
   rep_tables rep_t(get_self(), scope.value);
 
-  rep_t.emplace(_self, [&](auto& item) {
+  auto ritr = rep_t.emplace(_self, [&](auto& item) {
     item.account = account;
     item.rep = reputation;
   });
+  count_rep(account, -1, ritr->rep, scope);
 
   if (scope == individual_scope) {
     size_change("rep.sz"_n, 1);
@@ -930,6 +1036,122 @@ void accounts::add_rep_item(name account, uint64_t reputation, name scope) {
   }
 }
 
+// moves an account between rep values in the count tree, -1 stands for no rep row
+void accounts::count_rep(name account, int64_t old_rep, int64_t new_rep, name scope) {
+  rep_count_state_tables count_state(get_self(), scope.value);
+  rep_count_state_table state = count_state.get_or_default();
+
+  // rows ahead of a running countreps are counted when it reaches them
+  if (!state.complete && account.value >= state.cursor) return;
+
+  // both paths end at the root, the shared part cancels out
+  std::map<uint64_t, int64_t> changes;
+  if (old_rep >= 0) {
+    for (uint64_t i = std::min(uint64_t(old_rep), rep_count_nodes - 1) + 1; i <= rep_count_nodes; i += i & (~i + 1)) {
+      changes[i] -= 1;
+    }
+  }
+  if (new_rep >= 0) {
+    for (uint64_t i = std::min(uint64_t(new_rep), rep_count_nodes - 1) + 1; i <= rep_count_nodes; i += i & (~i + 1)) {
+      changes[i] += 1;
+    }
+  }
+
+  rep_count_tables counts(get_self(), scope.value);
+  for (auto & [node, delta] : changes) {
+    if (delta == 0) continue;
+
+    auto citr = counts.find(node);
+    if (citr == counts.end()) {
+      check(delta > 0, "rep count underflow");
+      counts.emplace(_self, [&](auto& item) {
+        item.node = node;
+        item.count = uint64_t(delta);
+      });
+    } else if (int64_t(citr->count) + delta <= 0) {
+      counts.erase(citr);
+    } else {
+      counts.modify(citr, _self, [&](auto& item) {
+        item.count = uint64_t(int64_t(item.count) + delta);
+      });
+    }
+  }
+}
+
+bool accounts::rep_counted(name scope) {
+  rep_count_state_tables count_state(get_self(), scope.value);
+  return count_state.get_or_default().complete;
+}
+
+// number of rows before the account in byrep order, read from the count tree
+// only rows sharing the account's (capped) rep value are walked
+uint64_t accounts::rep_position(name account, name scope) {
+  rep_tables rep_t(get_self(), scope.value);
+  auto ritr = rep_t.require_find(account.value, "no rep for account");
+
+  uint64_t value = std::min(uint64_t(ritr->rep), rep_count_nodes - 1);
+  uint64_t position = 0;
+
+  rep_count_tables counts(get_self(), scope.value);
+  for (uint64_t i = value; i > 0; i -= i & (~i + 1)) {
+    auto citr = counts.find(i);
+    if (citr != counts.end()) {
+      position += citr->count;
+    }
+  }
+
+  auto rep_by_rep = rep_t.get_index<"byrep"_n>();
+  auto titr = rep_by_rep.lower_bound(value << 32);
+  while (titr != rep_by_rep.end() && titr->account != account) {
+    position++;
+    titr++;
+  }
+
+  return position;
+}
+
+void accounts::countreps(name scope, uint64_t start, uint64_t chunksize) {
+  require_auth(get_self());
+  check(scope == individual_scope || scope == organization_scope, "invalid scope");
+
+  rep_count_state_tables count_state(get_self(), scope.value);
+  rep_tables rep_t(get_self(), scope.value);
+
+  if (start == 0) {
+    utils::delete_table<rep_count_tables>(get_self(), scope.value);
+    count_state.set(rep_count_state_table{ 0, false }, _self);
+  }
+
+  auto ritr = rep_t.lower_bound(start);
+  uint64_t count = 0;
+
+  while (ritr != rep_t.end() && count < chunksize) {
+    name account = ritr->account;
+    int64_t value = ritr->rep;
+    ritr++;
+
+    count_state.set(rep_count_state_table{ account.value + 1, false }, _self);
+    count_rep(account, -1, value, scope);
+    count++;
+  }
+
+  if (ritr == rep_t.end()) {
+    count_state.set(rep_count_state_table{ 0, true }, _self);
+  } else {
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "countreps"_n,
+      std::make_tuple(scope, ritr->account.value, chunksize)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(utils::deferred_id(tx), _self);
+  }
+}
+
 void accounts::changesize(name id, int64_t delta) {
   require_auth(get_self());
   size_change(id, delta);
@@ -1025,9 +1247,11 @@ void accounts::testsetrep(name user, uint64_t amount) {
   if (ritr == rep_t.end()) {
     add_rep_item(user, amount, scope);
   } else {
+    int64_t old_rep = ritr->rep;
     rep_t.modify(ritr, _self, [&](auto& item) {
       item.rep = amount;
     });
+    count_rep(user, old_rep, ritr->rep, scope);
   }
 }
 
@@ -1045,10 +1269,11 @@ void accounts::testsetrs(name user, uint64_t amount) {
 
   auto ritr = rep_t.find(user.value);
   if (ritr == rep_t.end()) {
-    rep_t.emplace(_self, [&](auto& item) {
+    ritr = rep_t.emplace(_self, [&](auto& item) {
       item.account = user;
       item.rank = amount;
     });
+    count_rep(user, -1, ritr->rep, scope);
     if (scope == individual_scope) {
       size_change("rep.sz"_n, 1);
     } else if (scope == organization_scope) {
@@ -1059,6 +1284,8 @@ void accounts::testsetrs(name user, uint64_t amount) {
       item.rank = amount;
     });
   }
+
+  send_mark_dirty({ user });
 }
 
 void accounts::send_add_cbs_org (name user, uint64_t amount) {
@@ -1070,6 +1297,18 @@ void accounts::send_add_cbs_org (name user, uint64_t amount) {
   ).send();
 }
 
+// harvest recalculates the contribution points of accounts whose rank changed
+void accounts::send_mark_dirty (std::vector<name> accounts) {
+  if (accounts.empty()) { return; }
+
+  action(
+    permission_level(get_self(), "active"_n),
+    contracts::harvest,
+    "markdirty"_n,
+    std::make_tuple(accounts)
+  ).send();
+}
+
 
 void accounts::testsetcbs(name user, uint64_t amount) {
   require_auth(get_self());
@@ -1144,7 +1383,7 @@ void accounts::send_bantree(name account) {
   transaction tx;
   tx.actions.emplace_back(send_ban);
   tx.delay_sec = 1;
-  tx.send(account.value, _self);
+  tx.send(utils::deferred_id(tx), _self);
 
 }
 
@@ -1207,13 +1446,18 @@ ACTION accounts::unban(name account)
 uint64_t accounts::rep_score(name user) 
 {
 
-    auto ritr = rep.find(user.value);
+    auto uitr = users.find(user.value);
+    name scope = uitr != users.end() && uitr->type == "organisation"_n ? organization_scope : individual_scope;
+
+    rep_tables rep_t(get_self(), scope.value);
+    auto ritr = rep_t.find(user.value);
 
-    if (ritr == rep.end()) {
+    if (ritr == rep_t.end()) {
       return 0;
     }
 
-    return ritr->rank;
+    name ranking = scope == organization_scope ? rankings::org_rep : rankings::rep;
+    return utils::rank_resolver(get_self(), ranking).rank(ritr->by_rep(), ritr->rank);
 }
 
 void accounts::send_punish (name account, uint64_t points) {
@@ -1271,7 +1515,7 @@ void accounts::pnshvouchers (name account, uint64_t points, uint64_t start) {
     transaction tx;
     tx.actions.emplace_back(next_execution);
     // tx.delay_sec = 1;
-    tx.send(next_value, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
@@ -1307,7 +1551,8 @@ void accounts::flag (name from, name to) {
 
   auto ritr = rep.get(from.value, (from.to_string() + " needs reputation to flag others").c_str());
   
-  points = base_points * utils::rep_multiplier_for_score(ritr.rank);
+  uint64_t rep_rank = utils::rank_resolver(get_self(), rankings::rep).rank(ritr.by_rep(), ritr.rank);
+  points = base_points * utils::rep_multiplier_for_score(rep_rank);
 
   flag_points.emplace(_self, [&](auto & item){
     item.account = from;
@@ -1432,7 +1677,7 @@ void accounts::send_eval_demote (name to) {
   transaction tx;
   tx.actions.emplace_back(next_execution);
   tx.delay_sec = 1;
-  tx.send(to.value + 1, _self);
+  tx.send(utils::deferred_id(tx), _self);
 
 }
 
@@ -1448,6 +1693,12 @@ void accounts::evaldemote (name to, uint64_t start_val, uint64_t chunk, uint64_t
   uint64_t total = get_size("rep.sz"_n);
   if (total == 0) return;
 
+  // the count tree answers in one action, the scan below is only needed until countreps has run
+  if (rep_counted(individual_scope)) {
+    demote_to_rank(to, utils::spline_rank(rep_position(to, individual_scope), total));
+    return;
+  }
+
   uint64_t current = chunk * chunksize;
   auto rep_by_rep = rep.get_index<"byrep"_n>();
   auto ritr = start_val == 0 ? rep_by_rep.begin() : rep_by_rep.lower_bound(start_val);
@@ -1457,34 +1708,7 @@ void accounts::evaldemote (name to, uint64_t start_val, uint64_t chunk, uint64_t
   while (ritr != rep_by_rep.end() && count < chunksize) {
 
     if (ritr->account == to) {
-      uint64_t rank = utils::spline_rank(current, total);
-
-      rep_by_rep.modify(ritr, _self, [&](auto& item) {
-        item.rank = rank;
-      });
-
-      auto uitr = users.find(ritr->account.value);
-
-      uint64_t min_rep_score_citizen = config_get("cit.rep.sc"_n);
-      uint64_t min_rep_score_resident = config_get("res.rep.pt"_n);
-
-      name current_rank = uitr->status;
-
-      if (rank < min_rep_score_resident) {
-        current_rank = visitor;
-      } else if (rank < min_rep_score_citizen) {
-        current_rank = resident;
-      } else {
-        current_rank = citizen;
-      }
-
-      if (uitr->status == citizen && current_rank != citizen) {
-        updatestatus(uitr->account, current_rank);
-      }
-      else if (uitr->status == resident && current_rank == visitor) {
-        updatestatus(uitr->account, visitor);
-      }
-
+      demote_to_rank(to, utils::spline_rank(current, total));
       evaluated = true;
       break;
     }
@@ -1506,11 +1730,44 @@ void accounts::evaldemote (name to, uint64_t start_val, uint64_t chunk, uint64_t
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value + 1, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 
 }
 
+void accounts::demote_to_rank (name to, uint64_t rank) {
+  auto ritr = rep.find(to.value);
+
+  if (ritr->rank != rank) {
+    rep.modify(ritr, _self, [&](auto& item) {
+      item.rank = rank;
+    });
+    send_mark_dirty({ to });
+  }
+
+  auto uitr = users.find(to.value);
+
+  uint64_t min_rep_score_citizen = config_get("cit.rep.sc"_n);
+  uint64_t min_rep_score_resident = config_get("res.rep.pt"_n);
+
+  name current_rank = uitr->status;
+
+  if (rank < min_rep_score_resident) {
+    current_rank = visitor;
+  } else if (rank < min_rep_score_citizen) {
+    current_rank = resident;
+  } else {
+    current_rank = citizen;
+  }
+
+  if (uitr->status == citizen && current_rank != citizen) {
+    updatestatus(uitr->account, current_rank);
+  }
+  else if (uitr->status == resident && current_rank == visitor) {
+    updatestatus(uitr->account, visitor);
+  }
+}
+
 
 void accounts::testmvouch (name sponsor, name account, uint64_t reps) {
   require_auth(get_self());
@@ -46,6 +46,23 @@ ACTION dao::reset () {
     while (ditr != delegate_t.end()) {
       ditr = delegate_t.erase(ditr);
     }
+
+    delegation_pool_tables pools_t(get_self(), s.value);
+    auto poitr = pools_t.begin();
+    while (poitr != pools_t.end()) {
+      pool_spend_tables spends_t(get_self(), poitr->delegatee.value);
+      auto spitr = spends_t.begin();
+      while (spitr != spends_t.end()) {
+        spitr = spends_t.erase(spitr);
+      }
+      poitr = pools_t.erase(poitr);
+    }
+  }
+
+  voice_decay_tables voicedecay_t(get_self(), get_self().value);
+  auto vditr = voicedecay_t.begin();
+  while (vditr != voicedecay_t.end()) {
+    vditr = voicedecay_t.erase(vditr);
   }
 
   for (auto & fund_type : fund_types) {
@@ -358,10 +375,11 @@ ACTION dao::erasepartpts (const uint64_t & active_proposals) {
   uint64_t batch_size = config_get(name("batchsize"));
   uint64_t reward_points = config_get(name("voterep1.ind"));
 
-  uint64_t counter = 0;
+  // delegators take part through the votes of their delegatees' pools, they are added before the rewards
+  uint64_t counter = credit_pools(batch_size);
 
   participant_tables participants_t(get_self(), get_self().value);
-  auto pitr = participants_t.begin();
+  auto pitr = counter < batch_size ? participants_t.begin() : participants_t.end();
 
   while (pitr != participants_t.end() && counter < batch_size) {
     if (pitr->count == active_proposals && pitr->nonneutral) {
@@ -378,7 +396,7 @@ ACTION dao::erasepartpts (const uint64_t & active_proposals) {
     pitr = participants_t.erase(pitr);
   }
 
-  if (pitr != participants_t.end()) {
+  if (counter >= batch_size) {
     send_deferred_transaction(
       permission_level(get_self(), "active"_n),
       get_self(),
@@ -390,17 +408,17 @@ ACTION dao::erasepartpts (const uint64_t & active_proposals) {
 
 ACTION dao::favour (const name & voter, const uint64_t & proposal_id, const uint64_t & amount) {
   require_auth(voter);
-  vote_aux(voter, proposal_id, amount, ProposalsCommon::trust, false);
+  vote_aux(voter, proposal_id, amount, ProposalsCommon::trust);
 }
 
 ACTION dao::against (const name & voter, const uint64_t & proposal_id, const uint64_t & amount) {
   require_auth(voter);
-  vote_aux(voter, proposal_id, amount, ProposalsCommon::distrust, false);
+  vote_aux(voter, proposal_id, amount, ProposalsCommon::distrust);
 }
 
 ACTION dao::neutral (const name & voter, const uint64_t & proposal_id) {
   require_auth(voter);
-  vote_aux(voter, proposal_id, uint64_t(0), ProposalsCommon::neutral, false);
+  vote_aux(voter, proposal_id, uint64_t(0), ProposalsCommon::neutral);
 }
 
 ACTION dao::revertvote (const name & voter, const uint64_t & proposal_id) {
@@ -413,7 +431,8 @@ ACTION dao::revertvote (const name & voter, const uint64_t & proposal_id) {
   votes_tables votes_t(get_self(), proposal_id);
   auto vitr = votes_t.require_find(voter.value, "voter has not voted on this proposal, can't revert");
 
-  uint64_t amount = vitr->amount;
+  // delegated voice follows the delegatee's vote
+  uint64_t amount = vitr->amount + vitr->delegated.value_or(0);
 
   check(pitr->stage == ProposalsCommon::stage_active, "proposal is not in stage active");
   check(vitr->favour == true && amount > 0, "only trust votes can be changed");
@@ -427,18 +446,6 @@ ACTION dao::revertvote (const name & voter, const uint64_t & proposal_id) {
     item.favour -= amount;
   });
 
-  std::unique_ptr<Proposal> prop = std::unique_ptr<Proposal>(ProposalsFactory::Factory(*this, pitr->type));
-  name scope = prop->get_scope();
-
-  if (has_delegates(voter, scope)) {
-    send_inline_action(
-      permission_level(get_self(), "active"_n),
-      get_self(), 
-      "mimicrevert"_n,
-      std::make_tuple(voter, (uint64_t)0, scope, proposal_id, (uint64_t)30)
-    );
-  }
-
 }
 
 ACTION dao::createdho (const name & organization) {
@@ -575,7 +582,7 @@ ACTION dao::votedhos (const name & account, std::vector<DhoVote> votes) {
   auto csitr = cs_t.require_find(account.value, "contribution score not found");
 
   // using the rank so the percentages don't get canceled due to low percentage and low rep multiplier
-  uint64_t multiplier = csitr->rank;
+  uint64_t multiplier = utils::rank_resolver(contracts::harvest, rankings::cs).rank(csitr->by_cs_points(), csitr->rank);
 
   for (auto & vote : votes) {
 
@@ -722,7 +729,7 @@ ACTION dao::dhocalcdists () {
 
 }
 
-void dao::vote_aux (const name & voter, const uint64_t & proposal_id, const uint64_t & amount, const name & option, const bool & is_delegated) {
+void dao::vote_aux (const name & voter, const uint64_t & proposal_id, const uint64_t & amount, const name & option) {
 
   proposal_tables proposals_t(get_self(), get_self().value);
   auto pitr = proposals_t.require_find(proposal_id, "proposal not found");
@@ -734,11 +741,21 @@ void dao::vote_aux (const name & voter, const uint64_t & proposal_id, const uint
   std::unique_ptr<Proposal> prop = std::unique_ptr<Proposal>(ProposalsFactory::Factory(*this, pitr->type));
   prop->check_can_vote(pitr->status, pitr->stage);
 
+  // reduce voice
+  name scope = prop->get_scope();
+  check(!is_trust_delegated(voter, scope), "voice is delegated, user can not vote by itself");
+
+  double percenetage_used = voice_change(voter, amount, true, scope);
+
+  // delegators vote with the same share of their voice as their delegatee
+  uint64_t delegated = spend_pool(voter, scope, proposal_id, percenetage_used, option);
+  uint64_t total = amount + delegated;
+
   proposals_t.modify(pitr, _self, [&](auto & item){
     if (option == ProposalsCommon::trust) {
-      item.favour += amount;  
+      item.favour += total;  
     } else if (option == ProposalsCommon::distrust) {
-      item.against += amount;
+      item.against += total;
     }
   });
 
@@ -747,6 +764,7 @@ void dao::vote_aux (const name & voter, const uint64_t & proposal_id, const uint
     item.account = voter;
     item.amount = amount;
     item.favour = option == ProposalsCommon::trust;
+    item.delegated.emplace(delegated);
   });
 
   // storing the number of voters per proposal in a separate scope
@@ -764,18 +782,19 @@ void dao::vote_aux (const name & voter, const uint64_t & proposal_id, const uint
     });
   }
 
-  // reduce voice
-  name scope = prop->get_scope();
-  double percenetage_used = voice_change(voter, amount, true, scope);
+  add_participant(voter, option, 1.0);
+  add_active(voter);
 
-  if (!is_delegated) {
-    check(!is_trust_delegated(voter, scope), "voice is delegated, user can not vote by itself");
-  }
+  add_voted_proposal(proposal_id);
 
-  send_mimic_delegatee_vote(voter, scope, proposal_id, percenetage_used, option);
+  // this one, maybe it should be called as a callback in the proposal's implementation?
+  // because not all proposals increase the voice cast, currently only the ones that are funded
+  // have an entry in the support table
+  increase_voice_cast(total, option, prop->get_fund_type());
+}
 
+void dao::add_participant (const name & voter, const name & option, const double & rep_multiplier, const uint64_t & count) {
   auto rep = config_get(name("voterep2.ind"));
-  double rep_multiplier = is_delegated ? config_get(name("votedel.mul")) / 100.0 : 1.0;
 
   participant_tables participants_t(get_self(), get_self().value);
   auto paitr = participants_t.find(voter.value);
@@ -795,15 +814,17 @@ void dao::vote_aux (const name & voter, const uint64_t & proposal_id, const uint
     participants_t.emplace(_self, [&](auto & participant){
       participant.account = voter;
       participant.nonneutral = option != ProposalsCommon::neutral;
-      participant.count = 1;
+      participant.count = count;
     });
   } else {
     participants_t.modify(paitr, _self, [&](auto & participant){
-      participant.count += 1;
+      participant.count += count;
       participant.nonneutral = option != ProposalsCommon::neutral && participant.nonneutral;
     });
   }
+}
 
+void dao::add_active (const name & voter) {
   active_tables actives_t(get_self(), get_self().value);
   auto aitr = actives_t.find(voter.value);
   if (aitr == actives_t.end()) {
@@ -817,13 +838,6 @@ void dao::vote_aux (const name & voter, const uint64_t & proposal_id, const uint
       item.timestamp = current_time_point().sec_since_epoch();
     });
   }
-
-  add_voted_proposal(proposal_id);
-
-  // this one, maybe it should be called as a callback in the proposal's implementation?
-  // because not all proposals increase the voice cast, currently only the ones that are funded
-  // have an entry in the support table
-  increase_voice_cast(amount, option, prop->get_fund_type());
 }
 
 void dao::increase_voice_cast (const uint64_t & amount, const name & option, const name & prop_type) {
@@ -911,7 +925,7 @@ bool dao::revert_vote (const name & voter, const uint64_t & proposal_id) {
     check(vitr->favour == true && vitr->amount > 0, "only trust votes can be changed");
 
     proposals_t.modify(ritr, _self, [&](auto & item){
-      item.favour -= vitr->amount;
+      item.favour -= vitr->amount + vitr->delegated.value_or(0);
     });
 
     votes_t.erase(vitr);
@@ -929,27 +943,6 @@ bool dao::is_trust_delegated (const name & account, const name & scope) {
   return ditr != deltrust_t.end();
 }
 
-void dao::send_mimic_delegatee_vote (const name & delegatee, const name & scope, const uint64_t & proposal_id, const double & percentage_used, const name & option) {
-
-  uint64_t batch_size = config_get("batchsize"_n);
-
-  delegate_trust_tables deltrust_t(get_self(), scope.value);
-  auto deltrust_by_delegatee_delegator = deltrust_t.get_index<"byddelegator"_n>();
-
-  uint128_t id = uint128_t(delegatee.value) << 64;
-  auto ditr = deltrust_by_delegatee_delegator.lower_bound(id);
-
-  if (ditr != deltrust_by_delegatee_delegator.end() && ditr->delegatee == delegatee) {
-    send_deferred_transaction(
-      permission_level(get_self(), "active"_n),
-      get_self(),
-      "mimicvote"_n,
-      std::make_tuple(delegatee, ditr->delegator, scope, proposal_id, percentage_used, option, batch_size)
-    );
-  }
-
-}
-
 uint64_t dao::get_new_moon (uint64_t timestamp) {
 
   moon_phases_tables moonphases_t(contracts::scheduler, contracts::scheduler.value);
@@ -1148,13 +1141,6 @@ void dao::send_deferred_transaction (
   const name & action,  
   const std::tuple<T...> & data) {
 
-  deferred_id_tables deferredids(get_self(), get_self().value);
-  deferred_id_table d_s = deferredids.get_or_create(get_self(), deferred_id_table());
-
-  d_s.id += 1;
-
-  deferredids.set(d_s, get_self());
-
   transaction trx{};
 
   trx.actions.emplace_back(
@@ -1165,7 +1151,7 @@ void dao::send_deferred_transaction (
   );
 
   trx.delay_sec = 1;
-  trx.send(d_s.id, _self);
+  trx.send(utils::deferred_id(trx), _self);
 
 }
 
@@ -52,7 +52,7 @@ void escrow::sendtopool (uint64_t start, uint64_t chunksize) {
             transaction tx;
             tx.actions.emplace_back(a);
             tx.delay_sec = 1;
-            tx.send(litr->id, _self);
+            tx.send(utils::deferred_id(tx), _self);
         }
         litr++;
         current += 3;
@@ -69,7 +69,7 @@ void escrow::sendtopool (uint64_t start, uint64_t chunksize) {
         transaction tx;
         tx.actions.emplace_back(next_execution);
         tx.delay_sec = 1;
-        tx.send(litr->id, _self);
+        tx.send(utils::deferred_id(tx), _self);
     }
 }
 
@@ -48,47 +48,67 @@ asset exchange::seeds_for_usd(asset usd_quantity) {
   update_price();
 
   soldtable s = sold.get_or_create(get_self(), soldtable());
- 
+  price_table p = price.get();
+
   double usd_total = double(usd_quantity.amount);
-  double usd_remaining = usd_total;
-  double seeds_amount = 0.0;
 
-  auto ritr = rounds.begin(); //rounds.find(p -> current_round);
+  auto ritr = rounds.require_find(p.current_round_id, "price table has invalid round id");
+  check(ritr->usd_total.has_value(), "rounds have no usd totals - run calcrounds");
 
-  uint64_t round_start_volume = 0;
+  double usd_per_seeds = 10000.0 / double(ritr->seeds_per_usd.amount);
+  double usd_available = (ritr->max_sold - s.total_sold) * usd_per_seeds;
 
-  while(ritr != rounds.end() && usd_remaining > 0) {
-    uint64_t round_end_volume = ritr->max_sold;
+  if (usd_available >= usd_total) {
+    return asset((usd_total * ritr->seeds_per_usd.amount) / 10000, seeds_symbol);
+  }
 
-    if (s.total_sold < round_end_volume) {
-      double usd_per_seeds = 10000.0 / double(ritr->seeds_per_usd.amount);
+  // the purchase ends in the first round whose cumulative value covers it
+  double usd_target = ritr->usd_total.value() + (usd_total - usd_available);
 
-      // num available
-      double available_in_round = round_end_volume - std::max(round_start_volume, s.total_sold);
+  auto rounds_by_usd_total = rounds.get_index<"byusdtotal"_n>();
+  auto litr = rounds_by_usd_total.lower_bound(usd_target);
 
-      // price of available seeds
-      double usd_available = available_in_round * usd_per_seeds;
+  if (litr == rounds_by_usd_total.end()) {
+    auto lastitr = rounds.rbegin();
+    double usd_left = usd_available + lastitr->usd_total.value() - ritr->usd_total.value();
+    check(false, "not enough funds available. requested USD value: "+std::to_string(usd_total/10000.0) + 
+    " available USD value: "+std::to_string(usd_left / 10000.0) + " max vol: " + std::to_string(lastitr->max_sold));
+  }
 
-      // if < usd amount remaining -> calculate, add, and exit
-      if (usd_available >= usd_remaining) {
-        seeds_amount += (usd_remaining * ritr->seeds_per_usd.amount) / 10000;
-        usd_remaining = 0;
-        break;
-      } else {
-        usd_remaining -= usd_available;
-        seeds_amount += available_in_round;
-      }
-    }
-    
-    round_start_volume = round_end_volume;
-    ritr++;
+  auto previtr = rounds.require_find(litr->id - 1, "rounds must be continuous");
+
+  double usd_in_round = usd_target - previtr->usd_total.value();
+  double seeds_amount = (previtr->max_sold - s.total_sold) + (usd_in_round * litr->seeds_per_usd.amount) / 10000;
 
-    check(ritr != rounds.end(), "not enough funds available. requested USD value: "+std::to_string(usd_total/10000.0) + 
-    " available USD value: "+std::to_string( (usd_total - usd_remaining) / 10000.0) + " max vol: " + std::to_string(round_end_volume));
+  return asset(seeds_amount, seeds_symbol);
+}
+
+double exchange::round_usd(uint64_t volume, asset seeds_per_usd) {
+  double usd_per_seeds = 10000.0 / double(seeds_per_usd.amount);
+  return volume * usd_per_seeds;
+}
+
+// recomputes the cumulative usd value of round_id and all rounds after it
+void exchange::update_round_totals(uint64_t round_id) {
+  uint64_t prev_vol = 0;
+  double usd_total = 0.0;
 
+  auto previtr = rounds.find(round_id - 1);
+  if (previtr != rounds.end()) {
+    prev_vol = previtr -> max_sold;
+    usd_total = previtr -> usd_total.value_or(0);
   }
 
-  return asset(seeds_amount, seeds_symbol);
+  auto ritr = rounds.find(round_id);
+
+  while(ritr != rounds.end()) {
+    usd_total += round_usd(ritr->max_sold - prev_vol, ritr->seeds_per_usd);
+    rounds.modify(ritr, _self, [&](auto& item) {
+      item.usd_total.emplace(usd_total);
+    });
+    prev_vol = ritr->max_sold;
+    ritr++;
+  }
 }
 
 void exchange::purchase_usd(name buyer, asset usd_quantity, string paymentSymbol, string memo) {
@@ -123,8 +143,10 @@ void exchange::purchase_usd(name buyer, asset usd_quantity, string paymentSymbol
   uint64_t seeds_amount = seeds_for_usd(usd_quantity).amount;
   asset seeds_quantity = asset(seeds_amount, seeds_symbol);
   
+  uint64_t day = current_day();
+
   auto sitr = dailystats.find(buyer.value);
-  if (sitr != dailystats.end()) {
+  if (sitr != dailystats.end() && sitr->day.value_or(0) == day) {
     seeds_purchased = sitr->seeds_purchased;
   }
   
@@ -143,10 +165,12 @@ void exchange::purchase_usd(name buyer, asset usd_quantity, string paymentSymbol
     dailystats.emplace(get_self(), [&](auto& s) {
       s.buyer_account = buyer;
       s.seeds_purchased = seeds_amount;
+      s.day.emplace(day);
     });
   } else {
     dailystats.modify(sitr, get_self(), [&](auto& s) {
-      s.seeds_purchased += seeds_amount;
+      s.seeds_purchased = seeds_purchased + seeds_amount;
+      s.day.emplace(day);
     }); 
   }
   
@@ -278,13 +302,15 @@ void exchange::newpayment(name recipientAccount, string paymentSymbol, string pa
 void exchange::onperiod() {
   require_auth(get_self());
   
-  auto sitr = dailystats.begin();
-  
-  while (sitr != dailystats.end()) {
-    sitr = dailystats.erase(sitr);
-  }
+  day_epoch_table d = dayepoch.get_or_create(get_self(), day_epoch_table());
+  d.day += 1;
+  d.timestamp = current_time_point().sec_since_epoch();
+  dayepoch.set(d, get_self());
 
+}
 
+uint64_t exchange::current_day() {
+  return dayepoch.get_or_create(get_self(), day_epoch_table()).day;
 }
 
 void exchange::updatelimit(asset citizen_limit, asset resident_limit, asset visitor_limit) {
@@ -331,29 +357,22 @@ void exchange::update_price() {
 
   configtable c = config.get_or_create(get_self(), configtable());
 
-  auto ritr = rounds.begin();
-
-  while(true) {
-    
-    check(ritr != rounds.end(), "No more rounds - sold out");
+  // the current round is the first one not sold out
+  auto rounds_by_max_sold = rounds.get_index<"bymaxsold"_n>();
+  auto ritr = rounds_by_max_sold.upper_bound(total_sold);
 
-    if (total_sold < ritr -> max_sold) {
-      p.current_round_id = ritr -> id;
-      p.current_seeds_per_usd = ritr -> seeds_per_usd;
-      p.remaining = ritr->max_sold - total_sold;
+  check(ritr != rounds_by_max_sold.end(), "No more rounds - sold out");
 
-      price.set(p, get_self());
+  p.current_round_id = ritr -> id;
+  p.current_seeds_per_usd = ritr -> seeds_per_usd;
+  p.remaining = ritr->max_sold - total_sold;
 
-      c.seeds_per_usd = ritr -> seeds_per_usd;
-      c.timestamp = current_time_point().sec_since_epoch();
-
-      config.set(c, get_self());
+  price.set(p, get_self());
 
-      break;
-    }
+  c.seeds_per_usd = ritr -> seeds_per_usd;
+  c.timestamp = current_time_point().sec_since_epoch();
 
-    ritr++;
-  }
+  config.set(c, get_self());
 
   price_history_update();
 
@@ -366,12 +385,15 @@ ACTION exchange::addround(uint64_t volume, asset seeds_per_usd) {
   check(volume > 0, "volume must be > 0");
 
   uint64_t prev_vol = 0;
+  double prev_usd_total = 0.0;
 
-  auto rounds_number = std::distance(rounds.begin(), rounds.end());
+  auto rounds_number = rounds.begin() == rounds.end() ? 0 : rounds.rbegin()->id + 1;
 
   auto previtr = rounds.find(rounds_number - 1);
   if (previtr != rounds.end()) {
+    check(previtr -> usd_total.has_value(), "rounds have no usd totals - run calcrounds");
     prev_vol = previtr -> max_sold;
+    prev_usd_total = previtr -> usd_total.value();
   } else {
     check(rounds_number == 0, "invalid round id - must be continuous");
   }
@@ -380,6 +402,7 @@ ACTION exchange::addround(uint64_t volume, asset seeds_per_usd) {
     item.id = rounds_number;
     item.seeds_per_usd = seeds_per_usd;
     item.max_sold = prev_vol + volume; 
+    item.usd_total.emplace(prev_usd_total + round_usd(volume, seeds_per_usd));
   });
 }
 
@@ -409,6 +432,35 @@ ACTION exchange::updatevol(uint64_t round_id, uint64_t volume) {
     ritr++;
   }
 
+  update_round_totals(round_id);
+
+}
+
+// rewrites the rounds with their usd totals - rows written before the rounds indexes existed have no index entries
+ACTION exchange::calcrounds() {
+  require_auth(get_self());
+
+  std::vector<round_table> all_rounds;
+  auto ritr = rounds.begin();
+  while(ritr != rounds.end()) {
+    all_rounds.push_back(*ritr);
+    ritr = rounds.erase(ritr);
+  }
+
+  uint64_t prev_vol = 0;
+  double usd_total = 0.0;
+
+  for (auto & r : all_rounds) {
+    usd_total += round_usd(r.max_sold - prev_vol, r.seeds_per_usd);
+    prev_vol = r.max_sold;
+    rounds.emplace(_self, [&](auto& item) {
+      item.id = r.id;
+      item.max_sold = r.max_sold;
+      item.seeds_per_usd = r.seeds_per_usd;
+      item.usd_total.emplace(usd_total);
+    });
+  }
+
 }
 
 ACTION exchange::initsale() {
@@ -466,6 +518,7 @@ ACTION exchange::incprice() {
     ritr++;
   }
 
+  update_round_totals(p.current_round_id);
   update_price();
 }
 
@@ -618,6 +671,7 @@ ACTION exchange::migrate() {
     dailystats.emplace(get_self(), [&](auto& item) {
       item.buyer_account = siter->buyer_account;
       item.seeds_purchased = siter->seeds_purchased;
+      item.day.emplace(current_day());
     });
     siter++;
   }
@@ -625,11 +679,16 @@ ACTION exchange::migrate() {
   // typedef multi_index<"rounds"_n, round_table> round_tables;
   round_tables other_rounds(old, old.value);
   auto riter = other_rounds.begin();
+  uint64_t prev_vol = 0;
+  double usd_total = 0.0;
   while (riter != other_rounds.end()) {
+    usd_total += round_usd(riter->max_sold - prev_vol, riter->seeds_per_usd);
+    prev_vol = riter->max_sold;
     rounds.emplace(get_self(), [&](auto& item) {
       item.id = riter->id;
       item.max_sold = riter->max_sold;
       item.seeds_per_usd = riter->seeds_per_usd;
+      item.usd_total.emplace(usd_total);
     });
     riter++;
   }
@@ -523,7 +523,7 @@ ACTION forum::deleteactive(uint64_t chunksize) {
         transaction tx;
         tx.actions.emplace_back(next_execution);
         tx.delay_sec = 1;
-        tx.send(next_value.value, _self);
+        tx.send(utils::deferred_id(tx), _self);
     }
 }
 
@@ -14,6 +14,12 @@ ACTION gratitude::reset () {
     actr = acks.erase(actr);
   }
 
+  auto atitr = acktotals.begin();
+  while (atitr != acktotals.end()) {
+    clear_ack_counts(atitr->donor);
+    atitr = acktotals.erase(atitr);
+  }
+
   auto sitr = sizes.begin();
   while (sitr != sizes.end()) {
     sitr = sizes.erase(sitr);
@@ -38,6 +44,8 @@ ACTION gratitude::reset () {
     item.round_pot = asset(0, seeds_symbol);
   });
 
+  set_round_status("idle"_n, 0, 0);
+
 }
 
 ACTION gratitude::migratestats() {
@@ -58,6 +66,23 @@ ACTION gratitude::migratestats() {
   }
 }
 
+ACTION gratitude::migrateacks() {
+  require_auth(get_self());
+
+  auto actr = acks.begin();
+  while (actr != acks.end()) {
+    std::map<name, uint64_t> unique_recs;
+    for (std::size_t i = 0; i < actr->receivers.size(); i++) {
+      unique_recs[actr->receivers[i]]++;
+    }
+    for (auto & [receiver, count] : unique_recs) {
+      add_acks(actr->donor, receiver, count);
+    }
+    // Remove old one
+    actr = acks.erase(actr);
+  }
+}
+
 ACTION gratitude::give (name from, name to, asset quantity, string memo) {
   require_auth(from);
 
@@ -88,27 +113,12 @@ ACTION gratitude::acknowledge (name from, name to, string memo) {
   init_balances(to);
   init_balances(from);
 
-  auto actr = acks.find(from.value);
-  if (actr == acks.end()) {
-    acks.emplace(_self, [&](auto& item) {
-      item.donor = from;
-      item.receivers = vector{to};
-    });
-  } else {
-    acks.modify(actr, get_self(), [&](auto &item) {
-        item.receivers.push_back(to);
-    });
-  }
-
-  // Updates ack stats
-  auto stitr = stats2.rbegin();
-  auto round_id = stitr->round_id;
+  add_acks(from, to, 1);
 
-  // Have to use find to get a modifiable operator
-  auto stitr2 = stats2.find(round_id);
-  auto oldacks = stitr2->num_acks;
-  stats2.modify(stitr2, _self, [&](auto& item) {
-      item.num_acks = oldacks + 1;
+  // Updates ack stats on the current round, the last one
+  auto stitr = std::prev(stats2.end());
+  stats2.modify(stitr, _self, [&](auto& item) {
+      item.num_acks += 1;
   });
 }
 
@@ -116,37 +126,62 @@ ACTION gratitude::acknowledge (name from, name to, string memo) {
 ACTION gratitude::testacks() {
   require_auth(get_self());
 
-  auto actr = acks.begin();
+  ack_settlement settlement;
+  auto atitr = acktotals.begin();
+  uint64_t budget = std::numeric_limits<uint64_t>::max();
 
-  while (actr != acks.end()) {
-    _calc_acks(actr->donor);
-    actr = acks.erase(actr);
+  while (atitr != acktotals.end()) {
+    uint64_t share = 0;
+    _calc_acks(atitr->donor, atitr->total, 0, share, budget, settlement);
+    atitr = acktotals.erase(atitr);
   }
+
+  flush_acks(settlement);
 }
 
 ACTION gratitude::calcacks(uint64_t start) {
   require_auth(get_self());
 
-  auto actr = start == 0 ? acks.begin() : acks.find(start);
-
-  if (actr != acks.end()) {
-    _calc_acks(actr->donor);
-    actr = acks.erase(actr);
+  auto atitr = start == 0 ? acktotals.begin() : acktotals.lower_bound(start);
+  uint64_t current = 0;
+  uint64_t budget = config_get("batchsize"_n);
+
+  auto status = roundstatus.get_or_default();
+  bool resuming = status.stage == "calcacks"_n && atitr != acktotals.end() && status.cursor == atitr->donor.value;
+  uint64_t receiver = resuming ? status.receiver.value_or(0) : 0;
+  uint64_t share = resuming ? status.share.value_or(0) : 0;
+
+  // the batch size bounds ack counts, a donor with more receivers is split across batches
+  ack_settlement settlement;
+  while (atitr != acktotals.end() && budget > 0) {
+    receiver = _calc_acks(atitr->donor, atitr->total, receiver, share, budget, settlement);
+    if (receiver != 0) { break; }
+    atitr = acktotals.erase(atitr);
+    current++;
   }
+
+  flush_acks(settlement);
+
+  uint64_t processed = (status.stage == "calcacks"_n ? status.processed : 0) + current;
+
   // If there is still more, do recursion call
-  if (actr != acks.end()) {
+  if (atitr != acktotals.end()) {
+    set_round_status("calcacks"_n, atitr->donor.value, processed, receiver, share);
+
     action next_execution(
       permission_level{get_self(), "active"_n},
       get_self(),
       "calcacks"_n,
-      std::make_tuple(actr->donor.value)
+      std::make_tuple(atitr->donor.value)
     );
 
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(actr->donor.value, _self);
+    tx.send(utils::deferred_id(tx), _self);
   } else {
+    set_round_status("payround"_n, 0, 0);
+
     // Otherwise, starts recursive payout
     auto contract_balance = eosio::token::get_balance(contracts::token, get_self(), seeds_symbol.code());
     float potkeep = config_get(gratz_potkp) / (float)100;
@@ -185,6 +220,9 @@ ACTION gratitude::payround(uint64_t start, uint64_t usable_bal) {
 
   // if there's more
   if (bitr != balances.end()) {
+    auto status = roundstatus.get_or_default();
+    set_round_status("payround"_n, bitr->account.value, status.processed + current);
+
     action next_execution(
       permission_level{get_self(), "active"_n},
       get_self(),
@@ -195,7 +233,7 @@ ACTION gratitude::payround(uint64_t start, uint64_t usable_bal) {
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(bitr->account.value, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
   // Else, after all payouts are complete
   else {
@@ -213,12 +251,16 @@ ACTION gratitude::payround(uint64_t start, uint64_t usable_bal) {
       item.volume = asset(0, gratitude_symbol);
       item.round_pot = asset(newpot, seeds_symbol);
     });
+
+    set_round_status("idle"_n, 0, 0);
   }
 }
 
 ACTION gratitude::newround() {
   require_auth(get_self());
 
+  set_round_status("calcacks"_n, 0, 0);
+
   action(
     permission_level{get_self(), "active"_n},
     get_self(),
@@ -238,15 +280,10 @@ ACTION gratitude::deposit (name from, name to, asset quantity, string memo) {
 
     utils::check_asset(quantity);
 
-    // Updates stats
-    auto stitr = stats2.rbegin();
-    auto round_id = stitr->round_id;
-
-    // Have to use find to get a modifiable operator
-    auto stitr2 = stats2.find(round_id);
-    auto oldpot = stitr2->round_pot.amount;
-    stats2.modify(stitr2, _self, [&](auto& item) {
-        item.round_pot = asset(oldpot + quantity.amount, seeds_symbol);
+    // Updates stats on the current round, the last one
+    auto stitr = std::prev(stats2.end());
+    stats2.modify(stitr, _self, [&](auto& item) {
+        item.round_pot += quantity;
     });
   }
 
@@ -259,38 +296,116 @@ void gratitude::check_user (name account) {
   check(uitr != users.end(), "gratitude: user not found");
 }
 
-void gratitude::_calc_acks (name donor) {
-  auto bitr = balances.find(donor.value);
-  if (bitr == balances.end()) {
-    init_balances(donor);
-    bitr = balances.find(donor.value);
+// Settles and clears the donor's ack counts from receiver `from` on, one budget unit per receiver
+// returns the receiver to resume from when the budget ran out, 0 once the donor is settled
+// the first part fixes the per-ack share and charges the donor for all its acks,
+// the parts after it credit the receivers with the same share
+uint64_t gratitude::_calc_acks (name donor, uint64_t num_acks, uint64_t from, uint64_t & share, uint64_t & budget, ack_settlement & settlement) {
+  if (from == 0) {
+    auto bitr = balances.find(donor.value);
+    if (bitr == balances.end()) {
+      init_balances(donor);
+      bitr = balances.find(donor.value);
+    }
+
+    uint64_t remaining = bitr->remaining.amount;
+
+    uint64_t min_acks = config_get(gratz_acks);
+    uint64_t divisor = num_acks < min_acks ? min_acks : num_acks;
+
+    share = remaining / divisor;
+    settlement.deltas[donor].remaining -= share * num_acks;
   }
 
-  uint64_t remaining = bitr->remaining.amount;
+  ack_count_tables ackcounts(get_self(), donor.value);
+  auto acitr = ackcounts.lower_bound(from);
+  while (acitr != ackcounts.end() && budget > 0) {
+    uint64_t received = share * acitr->count;
 
-  auto min_acks = config_get(gratz_acks);
+    settlement.deltas[acitr->receiver].received += received;
+    settlement.num_transfers++;
+    settlement.volume += received;
 
-  auto actr = acks.find(donor.value);
-  if (actr != acks.end()) {
-    std::map<name, uint64_t> unique_recs;
-    for (std::size_t i = 0; i < actr->receivers.size(); i++) {
-      unique_recs[actr->receivers[i]]++;
-    }
-    auto uritr = unique_recs.begin();
-    while (uritr != unique_recs.end()) {
-      uint64_t received = 0;
-      if (actr->receivers.size() < min_acks) {
-        received = (remaining / min_acks) * uritr->second;
-      } else {
-        received = (remaining / actr->receivers.size()) * uritr->second;
-      }
+    acitr = ackcounts.erase(acitr);
+    budget--;
+  }
 
-      sub_gratitude(donor, asset(received, gratitude_symbol));
-      add_gratitude(uritr->first, asset(received, gratitude_symbol));
-      update_stats(donor, uritr->first, asset(received, gratitude_symbol));
-      uritr++;
+  if (acitr != ackcounts.end()) {
+    return acitr->receiver.value;
+  }
+
+  return 0;
+}
+
+void gratitude::add_acks (name donor, name receiver, uint64_t count) {
+  ack_count_tables ackcounts(get_self(), donor.value);
+  auto acitr = ackcounts.find(receiver.value);
+  if (acitr == ackcounts.end()) {
+    ackcounts.emplace(_self, [&](auto& item) {
+      item.receiver = receiver;
+      item.count = count;
+    });
+  } else {
+    ackcounts.modify(acitr, _self, [&](auto& item) {
+      item.count += count;
+    });
+  }
+
+  auto atitr = acktotals.find(donor.value);
+  if (atitr == acktotals.end()) {
+    acktotals.emplace(_self, [&](auto& item) {
+      item.donor = donor;
+      item.total = count;
+    });
+  } else {
+    acktotals.modify(atitr, _self, [&](auto& item) {
+      item.total += count;
+    });
+  }
+}
+
+void gratitude::clear_ack_counts (name donor) {
+  ack_count_tables ackcounts(get_self(), donor.value);
+  auto acitr = ackcounts.begin();
+  while (acitr != ackcounts.end()) {
+    acitr = ackcounts.erase(acitr);
+  }
+}
+
+void gratitude::flush_acks (const ack_settlement & settlement) {
+  for (auto & [account, delta] : settlement.deltas) {
+    auto bitr = balances.find(account.value);
+    if (bitr == balances.end()) {
+      init_balances(account);
+      bitr = balances.find(account.value);
     }
+
+    check(bitr -> remaining.amount + delta.remaining >= 0, "gratitude: not enough gratitude to give");
+
+    balances.modify(bitr, _self, [&](auto & item){
+      item.remaining.amount += delta.remaining;
+      item.received.amount += delta.received;
+    });
   }
+
+  if (settlement.num_transfers > 0) {
+    add_round_volume(settlement.num_transfers, settlement.volume);
+  }
+}
+
+void gratitude::set_round_status (name stage, uint64_t cursor, uint64_t processed, uint64_t receiver, uint64_t share) {
+  auto status = roundstatus.get_or_default();
+  auto stitr = stats2.rbegin();
+
+  status.round_id = stitr == stats2.rend() ? 0 : stitr->round_id;
+  status.stage = stage;
+  status.cursor = cursor;
+  status.processed = processed;
+  status.receiver.emplace(receiver);
+  status.share.emplace(share);
+  status.timestamp = eosio::current_time_point().sec_since_epoch();
+
+  roundstatus.set(status, _self);
 }
 
 uint64_t gratitude::get_current_volume() {
@@ -300,16 +415,15 @@ uint64_t gratitude::get_current_volume() {
 }
 
 void gratitude::update_stats(name from, name to, asset quantity) {
-  // Updating the last stats item
-  auto itr = stats2.rbegin();
-  auto round_id = itr->round_id;
+  add_round_volume(1, quantity.amount);
+}
 
-  auto stitr = stats2.find(round_id);
-  auto oldvolume = stitr->volume.amount;
-  auto oldtransfers = stitr->num_transfers;
+void gratitude::add_round_volume(uint64_t num_transfers, uint64_t volume) {
+  // Updating the last stats item
+  auto stitr = std::prev(stats2.end());
   stats2.modify(stitr, _self, [&](auto& item) {
-    item.volume = asset(oldvolume + quantity.amount, gratitude_symbol);
-    item.num_transfers = oldtransfers + 1;
+    item.volume.amount += volume;
+    item.num_transfers += num_transfers;
   });
 }
 
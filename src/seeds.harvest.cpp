@@ -68,6 +68,28 @@ void harvest::reset() {
     bcsitr = regioncstemp.erase(bcsitr);
   }
 
+  auto ditr = csdirty.begin();
+  while (ditr != csdirty.end()) {
+    ditr = csdirty.erase(ditr);
+  }
+
+  utils::delete_table<cs_delta_tables>(get_self(), individual_scope_harvest.value);
+  utils::delete_table<cs_delta_tables>(get_self(), organization_scope.value);
+
+  utils::delete_table<claim_pool_tables>(get_self(), get_self().value);
+  utils::delete_table<harvest_claim_tables>(get_self(), individual_scope_harvest.value);
+  utils::delete_table<harvest_claim_tables>(get_self(), organization_scope.value);
+
+  auto rbitr = rankbounds.begin();
+  while (rbitr != rankbounds.end()) {
+    rbitr = rankbounds.erase(rbitr);
+  }
+
+  auto rpitr = rankpasses.begin();
+  while (rpitr != rankpasses.end()) {
+    rpitr = rankpasses.erase(rpitr);
+  }
+
   total.remove();
 
   init_balance(_self);
@@ -100,6 +122,10 @@ void harvest::plant(name from, name to, asset quantity, string memo) {
     add_planted(target, quantity);
 
     _deposit(quantity);
+
+    if (config_get("hrvst.autocl"_n) > 0) {
+      pay_claim(target);
+    }
   }
 }
 
@@ -281,6 +307,10 @@ void harvest::unplant(name from, asset quantity) {
 
   sub_planted(from, quantity);
 
+  if (config_get("hrvst.autocl"_n) > 0) {
+    pay_claim(from);
+  }
+
 }
 
 ACTION harvest::updatetxpt(name account) {
@@ -326,7 +356,7 @@ ACTION harvest::calctotal(uint64_t startval) {
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value, _self);
+    tx.send(utils::deferred_id(tx), _self);
 
   } 
 }
@@ -338,17 +368,24 @@ uint32_t harvest::calc_transaction_points(name account, name type) {
   uint64_t cutoffdate = now - (utils::moon_cycle * config_float_get("cyctrx.trail"_n));
 
   transaction_points_tables transactions(contracts::history, account.value);
+  trx_window_tables windows(contracts::history, contracts::history.value);
 
   uint64_t count = 0;
   uint64_t total_points = 0;
 
-  auto titr = transactions.rbegin();
-  while (titr != transactions.rend() && titr -> timestamp >= cutoffdate) {
+  auto witr = windows.find(account.value);
+  if (witr != windows.end()) {
+    total_points = utils::trx_window_points(transactions, *witr, cutoffdate, count);
+  } else {
+    // no points saved since the window was introduced
+    auto titr = transactions.rbegin();
+    while (titr != transactions.rend() && titr -> timestamp >= cutoffdate) {
 
-    total_points += titr -> points;
+      total_points += titr -> points;
 
-    titr++;
-    count++;
+      titr++;
+      count++;
+    }
   }
 
   if (type == name("organisation")) {
@@ -372,6 +409,7 @@ uint32_t harvest::calc_transaction_points(name account, name type) {
       } else {
         txpoints.erase(tx_points_itr);
         size_change(tx_points_size, -1);
+        mark_dirty(account);
       }
     }
   }
@@ -412,19 +450,19 @@ void harvest::calctrxpt(uint64_t start_val, uint64_t chunk, uint64_t chunksize)
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
 void harvest::rankorgtxs() {
-  ranktx(0, 0, 200, "org"_n);
+  ranktx(0, 0, 0, utils::rank_batch_budget, "org"_n);
 }
 
 void harvest::ranktxs() {
-  ranktx(0, 0, 200, contracts::harvest);
+  ranktx(0, 0, 0, utils::rank_batch_budget, contracts::harvest);
 }
 
-void harvest::ranktx(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name table) {
+void harvest::ranktx(uint64_t start_val, uint64_t start_id, uint64_t current, uint64_t chunksize, name table) {
   require_auth(_self);
 
   auto s = table == "org"_n ? org_tx_points_size : tx_points_size;
@@ -432,25 +470,33 @@ void harvest::ranktx(uint64_t start_val, uint64_t chunk, uint64_t chunksize, nam
   if (total == 0) return;
 
   tx_points_tables txpoints_table(get_self(), table.value);
+  name ranking = table == "org"_n ? rankings::org_tx : rankings::tx;
+  bool lazy = config_get("rank.lazy"_n) > 0;
+  utils::rank_pass<rank_bounds_tables, rank_pass_tables> pass(rankbounds, rankpasses, _self, ranking, utils::spline_curve, lazy, total, current);
 
-  uint64_t current = chunk * chunksize;
   auto txpt_by_points = txpoints_table.get_index<"bypoints"_n>();
-  auto titr = start_val == 0 ? txpt_by_points.begin() : txpt_by_points.lower_bound(start_val);
+  auto titr = utils::cursor_seek(txpt_by_points, start_val, start_id);
   uint64_t count = 0;
 
   while (titr != txpt_by_points.end() && count < chunksize) {
 
-    uint64_t rank = utils::spline_rank(current, total);
+    uint64_t rank = pass.next(titr->by_points());
 
-    txpt_by_points.modify(titr, _self, [&](auto& item) {
-      item.rank = rank;
-    });
+    if (pass.should_write(titr->rank, rank)) {
+      txpt_by_points.modify(titr, _self, [&](auto& item) {
+        item.rank = rank;
+      });
+      mark_dirty(titr->account);
+      count += utils::rank_write_cost;
+    } else {
+      count += utils::rank_read_cost;
+    }
 
-    current++;
-    count++;
     titr++;
   }
 
+  pass.save(titr == txpt_by_points.end());
+
   if (titr == txpt_by_points.end()) {
     // Done.
   } else {
@@ -460,46 +506,54 @@ void harvest::ranktx(uint64_t start_val, uint64_t chunk, uint64_t chunksize, nam
         permission_level{get_self(), "active"_n},
         get_self(),
         "ranktx"_n,
-        std::make_tuple(next_value, chunk + 1, chunksize, table)
+        std::make_tuple(next_value, titr->account.value, pass.position(), chunksize, table)
     );
 
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value, _self);
+    tx.send(utils::deferred_id(tx), _self);
     
   }
 
 }
 
 void harvest::rankplanteds() {
-  rankplanted(0, 0, 200);
+  rankplanted(0, 0, utils::rank_batch_budget);
 }
 
-void harvest::rankplanted(uint128_t start_val, uint64_t chunk, uint64_t chunksize) {
+void harvest::rankplanted(uint128_t start_val, uint64_t current, uint64_t chunksize) {
   require_auth(_self);
 
   uint64_t total = get_size(planted_size);
   if (total == 0) return;
 
-  uint64_t current = chunk * chunksize;
+  bool lazy = config_get("rank.lazy"_n) > 0;
+  utils::rank_pass<rank_bounds_tables, rank_pass_tables> pass(rankbounds, rankpasses, _self, rankings::planted, utils::spline_curve, lazy, total, current);
+
   auto planted_by_planted = planted.get_index<"byplanted"_n>();
   auto pitr = start_val == 0 ? planted_by_planted.begin() : planted_by_planted.lower_bound(start_val);
   uint64_t count = 0;
 
   while (pitr != planted_by_planted.end() && count < chunksize) {
 
-    uint64_t rank = utils::spline_rank(current, total);
+    uint64_t rank = pass.next(pitr->by_planted());
 
-    planted_by_planted.modify(pitr, _self, [&](auto& item) {
-      item.rank = rank;
-    });
+    if (pass.should_write(pitr->rank, rank)) {
+      planted_by_planted.modify(pitr, _self, [&](auto& item) {
+        item.rank = rank;
+      });
+      mark_dirty(pitr->account);
+      count += utils::rank_write_cost;
+    } else {
+      count += utils::rank_read_cost;
+    }
 
-    current++;
-    count++;
     pitr++;
   }
 
+  pass.save(pitr == planted_by_planted.end());
+
   if (pitr == planted_by_planted.end()) {
     // Done.
   } else {
@@ -509,20 +563,25 @@ void harvest::rankplanted(uint128_t start_val, uint64_t chunk, uint64_t chunksiz
         permission_level{get_self(), "active"_n},
         get_self(),
         "rankplanted"_n,
-        std::make_tuple(next_value, chunk + 1, chunksize)
+        std::make_tuple(next_value, pass.position(), chunksize)
     );
 
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(pitr->account.value, _self);
+    tx.send(utils::deferred_id(tx), _self);
     
   }
 
 }
 
 void harvest::calccss() {
-  calccs(0, 0, 200);
+  // lazy ranks move whenever new boundaries are published, so every account has to be recalculated
+  if (config_get("rank.lazy"_n) > 0) {
+    calccs(0, 0, 200);
+  } else {
+    calcdirtycs(200);
+  }
 }
 
 void harvest::calccs(uint64_t start_val, uint64_t chunk, uint64_t chunksize) {
@@ -554,7 +613,39 @@ void harvest::calccs(uint64_t start_val, uint64_t chunk, uint64_t chunksize) {
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value, _self);
+    tx.send(utils::deferred_id(tx), _self);
+  }
+}
+
+void harvest::calcdirtycs(uint64_t chunksize) {
+  require_auth(_self);
+
+  check(chunksize > 0, "chunk size must be > 0");
+
+  auto ditr = csdirty.begin();
+  uint64_t count = 0;
+
+  while (ditr != csdirty.end() && count < chunksize) {
+    auto uitr = users.find(ditr->account.value);
+    if (uitr != users.end()) {
+      calc_contribution_score(uitr->account, uitr->type);
+    }
+    ditr = csdirty.erase(ditr);
+    count++;
+  }
+
+  if (ditr != csdirty.end()) {
+    action next_execution(
+        permission_level{get_self(), "active"_n},
+        get_self(),
+        "calcdirtycs"_n,
+        std::make_tuple(chunksize)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
@@ -566,40 +657,41 @@ void harvest::calc_contribution_score(name account, name type) {
   uint64_t reputation_score = 0;
 
   auto pitr = planted.find(account.value);
-  if (pitr != planted.end()) planted_score = pitr->rank;
+  if (pitr != planted.end()) planted_score = resolve_rank(get_self(), rankings::planted, pitr->by_planted(), pitr->rank);
 
   // CS scrore for org needs to be calculated differently
   // Page 71 constitution
 
   name scope;
   name cs_scope;
-  name cs_sz;
 
   if (type == "organisation"_n) {
     scope = organization_scope;
     cs_scope = scope;
-    cs_sz = cs_org_size;
     
     tx_points_tables orgtxpoints(get_self(), "org"_n.value);
     auto titr = orgtxpoints.find(account.value);
-    if (titr != orgtxpoints.end()) transactions_score = titr->rank;
+    if (titr != orgtxpoints.end()) transactions_score = resolve_rank(get_self(), rankings::org_tx, titr->by_points(), titr->rank);
 
   } else {
     scope = individual_scope_accounts;
     cs_scope = individual_scope_harvest;
-    cs_sz = cs_size;
 
     auto titr = txpoints.find(account.value);
-    if (titr != txpoints.end()) transactions_score = titr->rank;
+    if (titr != txpoints.end()) transactions_score = resolve_rank(get_self(), rankings::tx, titr->by_points(), titr->rank);
   }
 
   rep_tables rep_t(contracts::accounts, scope.value);
   auto ritr = rep_t.find(account.value);
-  if (ritr != rep_t.end()) reputation_score = ritr->rank;
+  if (ritr != rep_t.end()) {
+    reputation_score = resolve_rank(contracts::accounts, scope == organization_scope ? rankings::org_rep : rankings::rep, ritr->by_rep(), ritr->rank);
+  }
 
   cbs_tables cbs_t(contracts::accounts, scope.value);
   auto citr = cbs_t.find(account.value);
-  if (citr != cbs_t.end()) community_building_score = citr->rank;
+  if (citr != cbs_t.end()) {
+    community_building_score = resolve_rank(contracts::accounts, scope == organization_scope ? rankings::org_cbs : rankings::cbs, citr->by_cbs(), citr->rank);
+  }
 
   // TODO verify this as correct for the constitution pp 71
   // Orgs need to have different scope for rep
@@ -610,6 +702,32 @@ void harvest::calc_contribution_score(name account, name type) {
 
   uint64_t contribution_points = ( (planted_score + transactions_score + community_building_score) * reputation_score * 2) / 100;
 
+  // while rankcs is in flight the cspoints table stays frozen, the new score is merged after the pass
+  cs_delta_tables deltas(get_self(), cs_scope.value);
+  auto ditr = deltas.find(account.value);
+  if (utils::rank_pass_in_flight(rankpasses, scope == organization_scope ? rankings::org_cs : rankings::cs)) {
+    if (ditr == deltas.end()) {
+      deltas.emplace(_self, [&](auto& item) {
+        item.account = account;
+        item.contribution_points = contribution_points;
+      });
+    } else {
+      deltas.modify(ditr, _self, [&](auto& item) {
+        item.contribution_points = contribution_points;
+      });
+    }
+  } else {
+    // a score not merged yet is stale now
+    if (ditr != deltas.end()) {
+      deltas.erase(ditr);
+    }
+    set_contribution_points(account, cs_scope, contribution_points);
+  }
+}
+
+void harvest::set_contribution_points(name account, name cs_scope, uint64_t contribution_points) {
+  name cs_sz = cs_scope == organization_scope ? cs_org_size : cs_size;
+
   cs_points_tables cspoints_t(get_self(), cs_scope.value);
 
   auto csitr = cspoints_t.find(account.value);
@@ -629,67 +747,86 @@ void harvest::calc_contribution_score(name account, name type) {
     } else {
       cspoints_t.erase(csitr);
       size_change(cs_sz, -1);
+      settle_claim(account, cs_scope, 0);
     }
   }
+}
 
-  if (type != "organisation"_n) {
-    add_cs_to_region(account, uint32_t(contribution_points));
+uint64_t harvest::resolve_rank(name code, name ranking, uint128_t key, uint64_t stored_rank) {
+  auto ritr = rank_resolvers.find(ranking);
+  if (ritr == rank_resolvers.end()) {
+    ritr = rank_resolvers.emplace(ranking, utils::rank_resolver(code, ranking)).first;
   }
+  return ritr->second.rank(key, stored_rank);
 }
 
-void harvest::add_cs_to_region(name account, uint32_t points) {
-  auto bitr = members.find(account.value);
-  if (bitr == members.end()) { return; }
+void harvest::add_cs_to_region(name region, uint32_t points) {
+  if (points == 0) { return; }
 
-  auto csitr = regioncstemp.find(bitr -> region.value);
+  auto csitr = regioncstemp.find(region.value);
   if (csitr == regioncstemp.end()) {
-    if (points > 0) {
-      regioncstemp.emplace(_self, [&](auto & item){
-        item.region = bitr -> region;
-        item.points = points;
-      });
-      size_change(cs_rgn_size, 1);
-    }
+    regioncstemp.emplace(_self, [&](auto & item){
+      item.region = region;
+      item.points = points;
+    });
+    size_change(cs_rgn_size, 1);
   } else {
-    if (points > 0) {
-      regioncstemp.modify(csitr, _self, [&](auto & item){
-        item.points += points;
-      });
-    } else {
-      regioncstemp.erase(csitr);
-    }
+    regioncstemp.modify(csitr, _self, [&](auto & item){
+      item.points += points;
+    });
+  }
+}
+
+void harvest::mark_dirty(name account) {
+  if (csdirty.find(account.value) == csdirty.end()) {
+    csdirty.emplace(_self, [&](auto & item){
+      item.account = account;
+    });
+  }
+}
+
+// sent inline by accounts whenever a rank input of an account changes
+void harvest::markdirty(std::vector<name> accounts) {
+  require_auth(has_auth(contracts::accounts) ? contracts::accounts : get_self());
+
+  for (name account : accounts) {
+    mark_dirty(account);
   }
 }
 
 void harvest::rankcss() {
   size_set(sum_rank_users, 0);
-  rankcs(0, 0, 200, individual_scope_harvest);
+  rankcs(0, 0, 0, utils::rank_batch_budget, individual_scope_harvest);
 }
 
 void harvest::rankorgcss() {
   size_set(sum_rank_orgs, 0);
-  rankcs(0, 0, 200, organization_scope);
+  rankcs(0, 0, 0, utils::rank_batch_budget, organization_scope);
 }
 
-void harvest::rankcs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, name cs_scope) {
+void harvest::rankcs(uint64_t start_val, uint64_t start_id, uint64_t current, uint64_t chunksize, name cs_scope) {
   require_auth(_self);
 
   uint64_t total = 0;
   name sum_rank_name;
+  name ranking;
   if (cs_scope == individual_scope_harvest) {
     total = get_size(cs_size);
     sum_rank_name = sum_rank_users;
+    ranking = rankings::cs;
   } else if (cs_scope == organization_scope) {
     total = get_size(cs_org_size);
     sum_rank_name = sum_rank_orgs;
+    ranking = rankings::org_cs;
   }
   if (total == 0) return;
 
   cs_points_tables cspoints_t(get_self(), cs_scope.value);
+  bool lazy = config_get("rank.lazy"_n) > 0;
+  utils::rank_pass<rank_bounds_tables, rank_pass_tables> pass(rankbounds, rankpasses, _self, ranking, utils::linear_curve, lazy, total, current);
 
-  uint64_t current = chunk * chunksize;
   auto cs_by_points = cspoints_t.get_index<"bycspoints"_n>();
-  auto citr = start_val == 0 ? cs_by_points.begin() : cs_by_points.lower_bound(start_val);
+  auto citr = utils::cursor_seek(cs_by_points, start_val, start_id);
   uint64_t count = 0;
   uint64_t sum_rank = 0;
 
@@ -697,30 +834,52 @@ void harvest::rankcs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, nam
 
   while (citr != cs_by_points.end() && count < chunksize) {
 
-    uint64_t rank = utils::linear_rank(current, total);
+    uint64_t rank = pass.next(citr->by_cs_points());
 
-    cs_by_points.modify(citr, _self, [&](auto& item) {
-      item.rank = rank;
-    });
+    if (pass.should_write(citr->rank, rank)) {
+      cs_by_points.modify(citr, _self, [&](auto& item) {
+        item.rank = rank;
+      });
+      count += utils::rank_write_cost;
+    } else {
+      count += utils::rank_read_cost;
+    }
 
+    uint64_t eligible_rank = rank;
     if (cs_scope == organization_scope) {
       auto org = organizations.find(citr -> account.value);
-      if (org -> status >= min_eligible) {
-        sum_rank += rank;    
-      }   
-    } else {
-      sum_rank += rank;    
+      if (org -> status < min_eligible) {
+        eligible_rank = 0;
+      }
+    }
+    sum_rank += eligible_rank;
+
+    if (settle_claim(citr->account, cs_scope, eligible_rank)) {
+      count += utils::rank_write_cost;
     }
 
-    current++;
-    count++;
     citr++;
   }
 
   size_change(sum_rank_name, int64_t(sum_rank));
+  pass.save(citr == cs_by_points.end());
 
   if (citr == cs_by_points.end()) {
     // Done.
+    cs_delta_tables deltas(get_self(), cs_scope.value);
+    if (deltas.begin() != deltas.end()) {
+      action merge_action(
+        permission_level{get_self(), "active"_n},
+        get_self(),
+        "mergecsdlt"_n,
+        std::make_tuple(cs_scope)
+      );
+
+      transaction tx;
+      tx.actions.emplace_back(merge_action);
+      tx.delay_sec = 1;
+      tx.send(ranking.value, _self);
+    }
   } else {
     // recursive call
     uint64_t next_value = citr->by_cs_points();
@@ -728,44 +887,120 @@ void harvest::rankcs(uint64_t start_val, uint64_t chunk, uint64_t chunksize, nam
         permission_level{get_self(), "active"_n},
         get_self(),
         "rankcs"_n,
-        std::make_tuple(next_value, chunk + 1, chunksize, cs_scope)
+        std::make_tuple(next_value, citr->account.value, pass.position(), chunksize, cs_scope)
     );
 
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value, _self);
+    tx.send(utils::deferred_id(tx), _self);
     
   }
 
 }
 
+void harvest::mergecsdlt(name cs_scope) {
+  require_auth(get_self());
+
+  // a new pass started, it merges the deltas when it is done
+  if (utils::rank_pass_in_flight(rankpasses, cs_scope == organization_scope ? rankings::org_cs : rankings::cs)) return;
+
+  cs_delta_tables deltas(get_self(), cs_scope.value);
+  uint64_t batch_size = config_get("batchsize"_n);
+  uint64_t count = 0;
+
+  auto ditr = deltas.begin();
+  while (ditr != deltas.end() && count < batch_size) {
+    set_contribution_points(ditr->account, cs_scope, ditr->contribution_points);
+    ditr = deltas.erase(ditr);
+    count++;
+  }
+
+  if (ditr != deltas.end()) {
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "mergecsdlt"_n,
+      std::make_tuple(cs_scope)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(utils::deferred_id(tx), _self);
+  }
+}
+
 
 void harvest::rankrgncss() {
   uint64_t batch_size = config_get("batchsize"_n);
   size_set(sum_rank_rgns, 0);
-  rankrgncs(uint64_t(0), uint64_t(0), batch_size);
+
+  auto bitr = regioncstemp.begin();
+  while (bitr != regioncstemp.end()) {
+    bitr = regioncstemp.erase(bitr);
+  }
+  size_set(cs_rgn_size, 0);
+
+  sumrgncs(uint64_t(0), batch_size);
 }
 
-void harvest::rankrgncs(uint64_t start, uint64_t chunk, uint64_t chunksize) {
+// regions are scored with the current contribution points of their members
+void harvest::sumrgncs(uint64_t start, uint64_t chunksize) {
+  require_auth(get_self());
+
+  auto mitr = start == 0 ? members.begin() : members.lower_bound(start);
+  uint64_t count = 0;
+
+  while (mitr != members.end() && count < chunksize) {
+    auto csitr = cspoints.find(mitr->account.value);
+    if (csitr != cspoints.end()) {
+      add_cs_to_region(mitr->region, csitr->contribution_points);
+    }
+    count++;
+    mitr++;
+  }
+
+  transaction tx;
+  if (mitr == members.end()) {
+    tx.actions.emplace_back(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "rankrgncs"_n,
+      std::make_tuple(uint64_t(0), uint64_t(0), chunksize * utils::rank_write_cost)
+    );
+  } else {
+    tx.actions.emplace_back(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "sumrgncs"_n,
+      std::make_tuple(mitr->account.value, chunksize)
+    );
+  }
+  tx.delay_sec = 1;
+  tx.send(cs_rgn_size.value, _self);
+}
+
+void harvest::rankrgncs(uint64_t start, uint64_t current, uint64_t chunksize) {
   require_auth(get_self());
 
   uint64_t total = get_size(cs_rgn_size);
   if (total == 0) return;
 
   cs_points_tables rgncspoints(get_self(), name("rgn").value);
+  utils::rank_pass<rank_bounds_tables, rank_pass_tables> pass(rankbounds, rankpasses, _self, rankings::rgn_cs, utils::linear_curve, false, total, current);
 
   auto rgns_by_points = regioncstemp.get_index<"bycspoints"_n>();
   auto bitr = start == 0 ? rgns_by_points.begin() : rgns_by_points.find(start);
   
-  uint64_t current = chunk * chunksize;
   uint64_t count = 0;
   uint64_t sum_rank_b = 0;
 
   while (bitr != rgns_by_points.end() && count < chunksize) {
 
-    uint64_t rank = utils::linear_rank(current, total);
+    uint64_t rank = pass.next(bitr->by_cs_points());
 
+    // the temporal row is moved into rgncspoints, so every region costs a write
     auto csitr = rgncspoints.find(bitr -> region.value);
     if (csitr == rgncspoints.end()) {
       rgncspoints.emplace(_self, [&](auto & item){
@@ -783,11 +1018,11 @@ void harvest::rankrgncs(uint64_t start, uint64_t chunk, uint64_t chunksize) {
     sum_rank_b += rank;
 
     bitr = rgns_by_points.erase(bitr);
-    count++;
-    current++;
+    count += utils::rank_write_cost;
   }
 
   size_change(sum_rank_rgns, int64_t(sum_rank_b));
+  pass.save(bitr == rgns_by_points.end());
 
   if (bitr != rgns_by_points.end()) {
     uint64_t next_value = bitr -> by_cs_points();
@@ -795,13 +1030,13 @@ void harvest::rankrgncs(uint64_t start, uint64_t chunk, uint64_t chunksize) {
       permission_level{get_self(), "active"_n},
       get_self(),
       "rankrgncs"_n,
-      std::make_tuple(next_value, chunk + 1, chunksize)
+      std::make_tuple(next_value, pass.position(), chunksize)
     );
 
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value, _self);
+    tx.send(utils::deferred_id(tx), _self);
   } else {
     size_set(cs_rgn_size, 0);
   }
@@ -885,38 +1120,8 @@ void harvest::testcspoints(name account, uint64_t contribution_points) {
   require_auth(get_self());
 
   auto uitr = users.get(account.value, "account not found");
-  name scope;
-  name cs_sz;
 
-  if (uitr.type == "individual"_n) {
-    scope = individual_scope_harvest;
-    cs_sz = cs_size;
-  } else {
-    scope = organization_scope;
-    cs_sz = cs_org_size;
-  }
-
-  cs_points_tables cspoints_t(get_self(), scope.value);
-
-  auto csitr = cspoints_t.find(account.value);
-  if (csitr == cspoints_t.end()) {
-    if (contribution_points > 0) {
-      cspoints_t.emplace(_self, [&](auto& item) {
-        item.account = account;
-        item.contribution_points = contribution_points;
-      });
-      size_change(cs_sz, 1);
-    }
-  } else {
-    if (contribution_points > 0) {
-      cspoints_t.modify(csitr, _self, [&](auto& item) {
-        item.contribution_points = contribution_points;
-      });
-    } else {
-      cspoints_t.erase(csitr);
-      size_change(cs_sz, -1);
-    }
-  }
+  set_contribution_points(account, uitr.type == "individual"_n ? individual_scope_harvest : organization_scope, contribution_points);
 }
 
 void harvest::testupdatecs(name account, uint64_t contribution_score) {
@@ -955,6 +1160,17 @@ void harvest::testupdatecs(name account, uint64_t contribution_score) {
       size_change(cs_sz, -1);
     }
   }
+
+  settle_claim(account, scope, claim_rank(account, scope, contribution_score));
+}
+
+void harvest::testaccrue(name cs_scope, asset amount) {
+  require_auth(get_self());
+
+  token::mint_action t_issue{contracts::token, { contracts::token, "minthrvst"_n }};
+  t_issue.send(get_self(), amount, string("harvest"));
+
+  accrue_harvest(cs_scope, amount);
 }
 
 double harvest::get_rep_multiplier(name account) {
@@ -1040,6 +1256,7 @@ ACTION harvest::setorgtxpt(name organization, uint64_t tx_points) {
     } else {
       orgtxpoints.erase(oitr);
       size_change(org_tx_points_size, -1);
+      mark_dirty(organization);
     }
   } 
 
@@ -1241,52 +1458,150 @@ void harvest::runharvest() {
   print("amount for orgs: ", asset(quantity.amount * orgs_percentage, test_symbol), "\n");
   print("amount for global: ", asset(quantity.amount * global_percentage, test_symbol), "\n");
 
-  send_distribute_harvest("disthvstusrs"_n, asset(quantity.amount * users_percentage, test_symbol));
+  accrue_harvest(individual_scope_harvest, asset(quantity.amount * users_percentage, test_symbol));
+  accrue_harvest(organization_scope, asset(quantity.amount * orgs_percentage, test_symbol));
   send_distribute_harvest("disthvstrgns"_n, asset(quantity.amount * rgns_percentage, test_symbol));
-  send_distribute_harvest("disthvstorgs"_n, asset(quantity.amount * orgs_percentage, test_symbol));
   send_distribute_harvest("disthvstdhos"_n, asset(quantity.amount * global_percentage, test_symbol));
 
 }
 
-void harvest::disthvstusrs (uint64_t start, uint64_t chunksize, asset total_amount) {
-  require_auth(get_self());
+// shared among the ranks accounts hold in hrvstclaims right now, so every accrued unit has a claimant
+void harvest::accrue_harvest (name cs_scope, asset amount) {
+  uint64_t sum_rank = get_size(cs_scope == organization_scope ? claim_rank_orgs : claim_rank_users);
+  if (sum_rank == 0) {
+    print("the sum rank for ", cs_scope, " is zero, nothing accrued\n");
+    return;
+  }
 
-  auto csitr = start == 0 ? cspoints.begin() : cspoints.find(start);
-  uint64_t count = 0;
+  claim_pool_tables claim_pools(get_self(), get_self().value);
+  auto pitr = claim_pools.find(cs_scope.value);
 
-  uint64_t sum_rank = get_size(sum_rank_users);
-  check(sum_rank > 0, "the sum rank for users must be greater than zero");
+  double fragment_seeds = amount.amount / double(sum_rank);
+  print("pool:", cs_scope, ", sum rank:", sum_rank, ", per rank:", fragment_seeds, "\n");
 
-  double fragment_seeds = total_amount.amount / double(sum_rank);
-  
-  while (csitr != cspoints.end() && count < chunksize) {
+  if (pitr == claim_pools.end()) {
+    claim_pools.emplace(_self, [&](auto & item){
+      item.pool = cs_scope;
+      item.per_rank = fragment_seeds;
+      item.outstanding = amount.amount;
+    });
+  } else {
+    claim_pools.modify(pitr, _self, [&](auto & item){
+      item.per_rank += fragment_seeds;
+      item.outstanding += amount.amount;
+    });
+  }
+}
 
-    // auto uitr = users.find(csitr -> account.value);
-    if (csitr->rank > 0) {
+// organizations below the minimum status take no part of the harvest
+uint64_t harvest::claim_rank (name account, name cs_scope, uint64_t rank) {
+  if (rank == 0 || cs_scope != organization_scope) { return rank; }
 
-      print("user:", csitr->account, ", rank:", csitr -> rank, ", amount:", asset(csitr -> rank * fragment_seeds, test_symbol), "\n");
-      withdraw_aux(get_self(), csitr->account, asset(csitr->rank * fragment_seeds, test_symbol), "harvest");
-    
+  auto oitr = organizations.find(account.value);
+  if (oitr == organizations.end() || oitr -> status < config_get(name("org.minharv"))) {
+    return 0;
+  }
+  return rank;
+}
+
+// moves what the account earned with its previous rank into unclaimed and starts accruing with the new one
+bool harvest::settle_claim (name account, name cs_scope, uint64_t rank) {
+  harvest_claim_tables claims(get_self(), cs_scope.value);
+  auto citr = claims.find(account.value);
+
+  if (citr == claims.end() && rank == 0) { return false; }
+
+  // keep the claim rank sum equal to the ranks in the table, an erased or zeroed account leaves it
+  name claim_rank_size = cs_scope == organization_scope ? claim_rank_orgs : claim_rank_users;
+  uint64_t old_rank = citr == claims.end() ? 0 : citr -> rank;
+  if (rank != old_rank) {
+    size_change(claim_rank_size, int64_t(rank) - int64_t(old_rank));
+  }
+
+  claim_pool_tables claim_pools(get_self(), get_self().value);
+  auto pitr = claim_pools.find(cs_scope.value);
+  double per_rank = pitr == claim_pools.end() ? 0.0 : pitr -> per_rank;
+
+  if (citr == claims.end()) {
+    claims.emplace(_self, [&](auto & item){
+      item.account = account;
+      item.rank = rank;
+      item.snapshot = per_rank;
+      item.unclaimed = 0.0;
+    });
+    return true;
+  }
+
+  // accrual is linear in per_rank, so an unchanged rank needs no write
+  if (citr -> rank == rank) { return false; }
+
+  double unclaimed = citr -> unclaimed + citr -> rank * (per_rank - citr -> snapshot);
+
+  if (rank == 0 && unclaimed < 1.0) {
+    claims.erase(citr);
+  } else {
+    claims.modify(citr, _self, [&](auto & item){
+      item.rank = rank;
+      item.snapshot = per_rank;
+      item.unclaimed = unclaimed;
+    });
+  }
+  return true;
+}
+
+void harvest::pay_claim (name account) {
+  for (name cs_scope : { individual_scope_harvest, organization_scope }) {
+    harvest_claim_tables claims(get_self(), cs_scope.value);
+    auto citr = claims.find(account.value);
+    if (citr == claims.end()) { continue; }
+
+    claim_pool_tables claim_pools(get_self(), get_self().value);
+    auto pitr = claim_pools.find(cs_scope.value);
+    double per_rank = pitr == claim_pools.end() ? 0.0 : pitr -> per_rank;
+
+    double unclaimed = citr -> unclaimed + citr -> rank * (per_rank - citr -> snapshot);
+    int64_t amount = int64_t(unclaimed);
+    if (amount <= 0) { continue; }
+
+    // the fraction below one unit keeps accruing
+    if (citr -> rank == 0 && unclaimed - amount < 1.0) {
+      claims.erase(citr);
+    } else {
+      claims.modify(citr, _self, [&](auto & item){
+        item.snapshot = per_rank;
+        item.unclaimed = unclaimed - amount;
+      });
     }
 
-    csitr++;
-    count++;
+    if (pitr != claim_pools.end()) {
+      claim_pools.modify(pitr, _self, [&](auto & item){
+        item.outstanding -= std::min(item.outstanding, uint64_t(amount));
+      });
+    }
+
+    print("claim:", account, ", amount:", asset(amount, test_symbol), "\n");
+    withdraw_aux(get_self(), account, asset(amount, test_symbol), "harvest");
   }
+}
 
-  if (csitr != cspoints.end()) {
-    action next_execution(
-      permission_level{get_self(), "active"_n},
-      get_self(),
-      "disthvstusrs"_n,
-      std::make_tuple(csitr -> account.value, chunksize, total_amount)
-    );
+void harvest::claimharvest (name account) {
+  require_auth(account);
+  pay_claim(account);
+}
 
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(csitr -> account.value, _self);
+// a distribution that had not started yet is accrued, one already walking stops here
+void harvest::disthvstusrs (uint64_t start, uint64_t chunksize, asset total_amount) {
+  require_auth(get_self());
+  if (start == 0) {
+    accrue_harvest(individual_scope_harvest, total_amount);
   }
+}
 
+void harvest::disthvstorgs (uint64_t start, uint64_t chunksize, asset total_amount) {
+  require_auth(get_self());
+  if (start == 0) {
+    accrue_harvest(organization_scope, total_amount);
+  }
 }
 
 void harvest::disthvstrgns (uint64_t start, uint64_t chunksize, asset total_amount) {
@@ -1328,56 +1643,11 @@ void harvest::disthvstrgns (uint64_t start, uint64_t chunksize, asset total_amou
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 
 }
 
-void harvest::disthvstorgs (uint64_t start, uint64_t chunksize, asset total_amount) {
-  require_auth(get_self());
-
-  cs_points_tables cspoints_t(get_self(), organization_scope.value);
-
-  auto csitr = start == 0 ? cspoints_t.begin() : cspoints_t.find(start);
-  uint64_t count = 0;
-
-  uint64_t sum_rank = get_size(sum_rank_orgs);
-  check(sum_rank > 0, "the sum rank for organizations must be greater than zero");
-
-  double fragment_seeds = total_amount.amount / double(sum_rank);
-
-  uint64_t min_eligible = config_get(name("org.minharv"));
-  
-  while (csitr != cspoints_t.end() && count < chunksize) {
-
-    // auto uitr = users.find(csitr -> account.value);
-    if (csitr->rank > 0) {
-      auto uitr = organizations.find(csitr -> account.value);
-      if (uitr -> status >= min_eligible) {
-        print("org:", csitr -> account, ", rank:", csitr -> rank, ", amount:", asset(csitr -> rank * fragment_seeds, test_symbol), "\n");
-        withdraw_aux(get_self(), csitr -> account, asset(csitr -> rank * fragment_seeds, test_symbol), "harvest");
-      }
-    }
-
-    csitr++;
-    count++;
-  }
-
-  if (csitr != cspoints_t.end()) {
-    action next_execution(
-      permission_level{get_self(), "active"_n},
-      get_self(),
-      "disthvstorgs"_n,
-      std::make_tuple(csitr -> account.value, chunksize, total_amount)
-    );
-
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(sum_rank_orgs.value, _self);
-  }
-}
-
 void harvest::disthvstdhos (uint64_t start, uint64_t chunksize, asset total_amount) {
   require_auth(get_self());
 
@@ -1652,7 +1922,7 @@ void harvest::resetlgroups (uint64_t chunksize) {
     transaction tx;
     tx.actions.emplace_back(a);
     tx.delay_sec = 1;
-    tx.send(log_group, _self);
+    tx.send(utils::deferred_id(tx), _self);
 
     lgitr++;
     count++;
@@ -1669,7 +1939,7 @@ void harvest::resetlgroups (uint64_t chunksize) {
     transaction tx;
     tx.actions.emplace_back(a);
     tx.delay_sec = 1;
-    tx.send(lgitr->log_group+1, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 
 }
@@ -1713,7 +1983,7 @@ void harvest::resetlogs (uint64_t log_group, uint64_t chunksize) {
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(log_group, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
@@ -1738,9 +2008,11 @@ void harvest::ldsthvstusrs (uint64_t start, uint64_t chunksize, asset total_amou
   
   while (csitr != cspoints.end() && count < chunksize) {
 
-    if (csitr->rank > 0) {
-      string notes = "User: " + csitr->account.to_string() + ", Rank:" + std::to_string(csitr->rank) + 
-        ", Amount: " + asset(csitr -> rank * fragment_seeds, test_symbol).to_string() + 
+    uint64_t rank = resolve_rank(get_self(), rankings::cs, csitr->by_cs_points(), csitr->rank);
+
+    if (rank > 0) {
+      string notes = "User: " + csitr->account.to_string() + ", Rank:" + std::to_string(rank) + 
+        ", Amount: " + asset(rank * fragment_seeds, test_symbol).to_string() + 
         ", Fragments Seeds: " + std::to_string(fragment_seeds) + 
         ",  Amount = Rank * Fragments_Seeds, 4 decimals of precision when converting to asset";
       
@@ -1750,7 +2022,7 @@ void harvest::ldsthvstusrs (uint64_t start, uint64_t chunksize, asset total_amou
       rewards_t.emplace(_self, [&](auto & item) {
         item.account = csitr->account;
         item.account_type = "user"_n;
-        item.reward = asset(csitr->rank * fragment_seeds, test_symbol);
+        item.reward = asset(rank * fragment_seeds, test_symbol);
         item.notes = notes;
       });
 
@@ -1773,7 +2045,7 @@ void harvest::ldsthvstusrs (uint64_t start, uint64_t chunksize, asset total_amou
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(csitr->account.value, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
@@ -1835,7 +2107,7 @@ void harvest::ldsthvstrgns (uint64_t start, uint64_t chunksize, asset total_amou
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
@@ -1862,12 +2134,14 @@ void harvest::ldsthvstorgs (uint64_t start, uint64_t chunksize, asset total_amou
   
   while (csitr != cspoints_t.end() && count < chunksize) {
 
-    if (csitr->rank > 0) {
+    uint64_t rank = resolve_rank(get_self(), rankings::org_cs, csitr->by_cs_points(), csitr->rank);
+
+    if (rank > 0) {
       auto uitr = organizations.find(csitr -> account.value);
       if (uitr -> status >= min_eligible) {
 
-        string notes = "Org: " + csitr->account.to_string() + ", Rank: " + std::to_string(csitr->rank) + 
-          ", Amount: " + asset(csitr -> rank * fragment_seeds, test_symbol).to_string() +
+        string notes = "Org: " + csitr->account.to_string() + ", Rank: " + std::to_string(rank) + 
+          ", Amount: " + asset(rank * fragment_seeds, test_symbol).to_string() +
           ", Fragments Seeds: " + std::to_string(fragment_seeds) + 
           ",  Amount = Rank * Fragment_Seeds, 4 decimals of precision when converting to asset";
 
@@ -1877,13 +2151,13 @@ void harvest::ldsthvstorgs (uint64_t start, uint64_t chunksize, asset total_amou
         rewards_t.emplace(_self, [&](auto & item) {
           item.account = csitr->account;
           item.account_type = "org"_n;
-          item.reward = asset(csitr -> rank * fragment_seeds, test_symbol);
+          item.reward = asset(rank * fragment_seeds, test_symbol);
           item.notes = notes;
         });
       
       } else {
         logaction(log_group, name("disthvstorgs"), "Organization " + csitr->account.to_string() + 
-          " is not eligible, its rank is " + std::to_string(csitr->rank) + " and its status " + std::to_string(uitr->status));
+          " is not eligible, its rank is " + std::to_string(rank) + " and its status " + std::to_string(uitr->status));
       }
     } else {
       logaction(log_group, name("disthvstorgs"), "Organization " + csitr->account.to_string() + " is not eligible, its rank is 0");
@@ -19,6 +19,12 @@ void history::reset(name account) {
     titr = transactions.erase(titr);
   }
 
+  trx_window_tables windows(get_self(), get_self().value);
+  auto witr = windows.find(account.value);
+  if (witr != windows.end()) {
+    windows.erase(witr);
+  }
+
   qev_tables qevs(get_self(), account.value);
   auto qitr = qevs.begin();
   while (qitr != qevs.end()) {
@@ -53,6 +59,15 @@ void history::reset(name account) {
     }
   }
 
+  pending_trx_tables pending(get_self(), get_self().value);
+  auto pitr = pending.begin();
+  while (pitr != pending.end()) {
+    pitr = pending.erase(pitr);
+  }
+
+  pending_trx_status_tables pendingstat(get_self(), get_self().value);
+  pendingstat.remove();
+
   auto tcitr = trxcbprewards.begin();
   while (tcitr != trxcbprewards.end()) {
     tcitr = trxcbprewards.erase(tcitr);
@@ -197,82 +212,180 @@ void history::trxentry(name from, name to, asset quantity) {
     transaction.timestamp = timestamp;
   });
 
-  auto from_totals_itr = totals.find(from.value);
+  pending_trx_tables pending(get_self(), get_self().value);
+  bool idle = pending.begin() == pending.end();
 
-  if (from_totals_itr != totals.end()) {
-    totals.modify(from_totals_itr, _self, [&](auto & item){
-      item.total_volume += quantity.amount;
-      item.total_number_of_transactions += 1;
-      item.total_outgoing_to_rep_orgs += ( to_is_organization ? 1 : 0 );
-    });
-  } else {
-    totals.emplace(_self, [&](auto & item){
-      item.account = from;
-      item.total_volume += quantity.amount;
-      item.total_number_of_transactions = 1;
-      item.total_incoming_from_rep_orgs = 0;
-      item.total_outgoing_to_rep_orgs = ( to_is_organization ? 1 : 0 );
-    });
-  }
+  pending.emplace(_self, [&](auto & item){
+    item.id = pending.available_primary_key();
+    item.transaction_id = transaction_id;
+    item.timestamp = timestamp;
+    item.from = from;
+    item.to = to;
+    item.volume = quantity.amount;
+    item.from_is_organization = from_is_organization;
+    item.to_is_organization = to_is_organization;
+  });
 
-  if (from_is_organization) {
-    auto to_totals_itr = totals.find(to.value);
-    if (to_totals_itr != totals.end()) {
-      totals.modify(to_totals_itr, _self, [&](auto & item){
-        item.total_incoming_from_rep_orgs += 1;
-      });
-    } else {
-      totals.emplace(_self, [&](auto & item){
-        item.account = to;
-        item.total_volume = 0;
-        item.total_number_of_transactions = 0;
-        item.total_incoming_from_rep_orgs = 1;
-        item.total_outgoing_to_rep_orgs = 0;
-      });
-    }
+  // one processor drains the queue, it is scheduled when the queue was empty
+  // or again when it stopped draining, e.g. its deferred failed or expired
+  if (idle || process_trxs_stalled(timestamp)) {
+    send_process_trxs();
   }
+}
+
+// anyone can restart a processor that stopped draining the queue
+void history::kicktrxs () {
+  pending_trx_tables pending(get_self(), get_self().value);
+  check(pending.begin() != pending.end(), "there are no pending transfers");
+  check(process_trxs_stalled(eosio::current_time_point().sec_since_epoch()), "pending transfers are being processed");
+
+  send_process_trxs();
+}
+
+// the oldest entry waited longer than htry.stale and the processor was not sent since
+bool history::process_trxs_stalled (uint64_t now) {
+  pending_trx_tables pending(get_self(), get_self().value);
+  auto pitr = pending.begin();
+  if (pitr == pending.end()) { return false; }
+
+  pending_trx_status_tables pendingstat(get_self(), get_self().value);
+  uint64_t stale = config_get("htry.stale"_n);
+  return pitr->timestamp + stale <= now && pendingstat.get_or_default().last_sent + stale <= now;
+}
 
-  uint64_t deferred_id = get_deferred_id();
+void history::send_process_trxs () {
+  pending_trx_status_tables pendingstat(get_self(), get_self().value);
+  auto status = pendingstat.get_or_default();
+  status.last_sent = eosio::current_time_point().sec_since_epoch();
+  pendingstat.set(status, _self);
 
   action a(
-    permission_level{contracts::history, "active"_n},
+    permission_level{get_self(), "active"_n},
     get_self(),
-    "savepoints"_n,
-    std::make_tuple(transaction_id, timestamp)
+    "processtrxs"_n,
+    std::make_tuple(config_get("htry.batch"_n))
   );
 
   transaction tx;
   tx.actions.emplace_back(a);
   tx.delay_sec = 1;
-  tx.send(deferred_id, _self);
+  tx.send("processtrxs"_n.value, _self, true);
 }
 
-uint64_t history::get_deferred_id () {
-  deferred_id_tables deferredids(get_self(), get_self().value);
-  deferred_id_table d_s = deferredids.get_or_create(get_self(), deferred_id_table());
+void history::savepoints(uint64_t id, uint64_t timestamp) {
+  require_auth(get_self());
+
+  auto date = eosio::time_point_sec(timestamp / 86400 * 86400);
+  uint64_t day = date.utc_seconds;
+
+  trx_points points;
+  bool save_points = eval_points(id, day, points);
+  check(points.from != name(), "transaction not found");
 
-  d_s.id += 1;
+  if (save_points) {
+    save_from_metrics(points.from, points.from_points, points.qualifying_volume, day);
 
-  deferredids.set(d_s, get_self());
+    if (points.to_is_organization) {
+      add_trx_points(points.to, points.to_points, day);
+    }
+  }
 
-  return d_s.id;
+  cbp_rewards(points.from, points.to);
 }
 
-void history::savepoints(uint64_t id, uint64_t timestamp) {
+void history::processtrxs(uint64_t chunksize) {
   require_auth(get_self());
 
-  auto date = eosio::time_point_sec(timestamp / 86400 * 86400);
-  uint64_t day = date.utc_seconds;
+  check(chunksize > 0, "chunk size must be > 0");
+
+  pending_trx_tables pending(get_self(), get_self().value);
+
+  // rows written by many transfers of the batch are written once
+  std::map<name, totals_table> totals_delta;
+  std::map<std::pair<name, uint64_t>, int64_t> points_delta;
+  std::map<std::pair<uint64_t, uint64_t>, int64_t> qev_delta;
+
+  auto pitr = pending.begin();
+  uint64_t count = 0;
+
+  while (pitr != pending.end() && count < chunksize) {
+    auto & from_totals = totals_delta[pitr->from];
+    from_totals.total_volume += pitr->volume;
+    from_totals.total_number_of_transactions += 1;
+    from_totals.total_outgoing_to_rep_orgs += ( pitr->to_is_organization ? 1 : 0 );
+
+    if (pitr->from_is_organization) {
+      totals_delta[pitr->to].total_incoming_from_rep_orgs += 1;
+    }
+
+    auto date = eosio::time_point_sec(pitr->timestamp / 86400 * 86400);
+    uint64_t day = date.utc_seconds;
+
+    trx_points points;
 
+    if (eval_points(pitr->transaction_id, day, points)) {
+      points_delta[std::make_pair(points.from, day)] += points.from_points;
+      qev_delta[std::make_pair(points.from.value, day)] += points.qualifying_volume;
+      qev_delta[std::make_pair(get_self().value, day)] += points.qualifying_volume;
+
+      if (points.to_is_organization) {
+        points_delta[std::make_pair(points.to, day)] += points.to_points;
+      }
+    }
+
+    // a failing reward only loses its own deferred, not the batch
+    if (has_cbp_rewards(pitr->from, pitr->to)) {
+      send_trx_cbp(pitr->from, pitr->to);
+    }
+
+    pitr = pending.erase(pitr);
+    count++;
+  }
+
+  for (auto & [account, delta] : totals_delta) {
+    auto titr = totals.find(account.value);
+    if (titr != totals.end()) {
+      totals.modify(titr, _self, [&](auto & item){
+        item.total_volume += delta.total_volume;
+        item.total_number_of_transactions += delta.total_number_of_transactions;
+        item.total_incoming_from_rep_orgs += delta.total_incoming_from_rep_orgs;
+        item.total_outgoing_to_rep_orgs += delta.total_outgoing_to_rep_orgs;
+      });
+    } else {
+      totals.emplace(_self, [&](auto & item){
+        item.account = account;
+        item.total_volume = delta.total_volume;
+        item.total_number_of_transactions = delta.total_number_of_transactions;
+        item.total_incoming_from_rep_orgs = delta.total_incoming_from_rep_orgs;
+        item.total_outgoing_to_rep_orgs = delta.total_outgoing_to_rep_orgs;
+      });
+    }
+  }
+
+  for (auto & [key, points] : points_delta) {
+    add_trx_points(key.first, points, key.second);
+  }
+
+  for (auto & [key, qualifying_volume] : qev_delta) {
+    add_qev(key.first, qualifying_volume, key.second);
+  }
+
+  if (pitr != pending.end()) {
+    send_process_trxs();
+  }
+}
+
+bool history::eval_points(uint64_t id, uint64_t day, trx_points & points) {
   daily_transactions_tables transactions(get_self(), day);
   auto transactions_by_from_to = transactions.get_index<"byfromto"_n>();
 
+  // the day may have been deleted already
   auto titr = transactions.find(id);
-  check(titr != transactions.end(), "transaction not found");
+  if (titr == transactions.end()) { return false; }
+
   name from = titr -> from;
   name to = titr -> to;
 
-  auto uitr_from = users.find(from.value);
   auto uitr_to = users.find(to.value);
 
   uint64_t max_number_transactions = config_get("htry.trx.max"_n);
@@ -295,9 +408,12 @@ void history::savepoints(uint64_t id, uint64_t timestamp) {
     count++;
   }
 
-  int64_t from_points = int64_t(titr -> from_points);
-  int64_t to_points = int64_t(titr -> to_points);
-  int64_t qualifying_volume = int64_t(titr -> qualifying_volume);
+  points.from = from;
+  points.to = to;
+  points.to_is_organization = uitr_to -> type == name("organisation");
+  points.from_points = int64_t(titr -> from_points);
+  points.to_points = int64_t(titr -> to_points);
+  points.qualifying_volume = int64_t(titr -> qualifying_volume);
 
   bool save_points = true;
 
@@ -312,9 +428,9 @@ void history::savepoints(uint64_t id, uint64_t timestamp) {
       auto ptrx_itr = ptrx_t_by_timestamp_id.find(ptrx_id);
 
       if (ptrx_itr != ptrx_t_by_timestamp_id.end()) {
-        from_points -= current_itr -> from_points;
-        to_points -= current_itr -> to_points;
-        qualifying_volume -= current_itr -> qualifying_volume;
+        points.from_points -= current_itr -> from_points;
+        points.to_points -= current_itr -> to_points;
+        points.qualifying_volume -= current_itr -> qualifying_volume;
       }
 
     } else {
@@ -325,28 +441,6 @@ void history::savepoints(uint64_t id, uint64_t timestamp) {
   }
 
   if (save_points) {
-    save_from_metrics (from, from_points, qualifying_volume, day);
-
-    if (uitr_to -> type == name("organisation")) {
-      transaction_points_tables trx_points_to(get_self(), to.value);
-      auto trx_itr_to = trx_points_to.find(day);
-
-      if (trx_itr_to != trx_points_to.end()) {
-        trx_points_to.modify(trx_itr_to, _self, [&](auto & item){
-          item.points += to_points;
-        });
-      } else {
-        trx_points_to.emplace(_self, [&](auto & item){
-          item.timestamp = day;
-          item.points = to_points;
-        });
-      }
-    }
-
-    if (uitr_from -> type != name("organisation")) {
-      send_update_txpoints(from);
-    }
-
     ptrx_t.emplace(_self, [&](auto & ptrx){
       ptrx.id = ptrx_t.available_primary_key();
       ptrx.transaction_id = id;
@@ -354,29 +448,38 @@ void history::savepoints(uint64_t id, uint64_t timestamp) {
     });
   }
 
-  send_trx_cbp_reward_action(from, to);
+  return save_points;
 }
 
 void history::save_from_metrics (name from, int64_t & from_points, int64_t & qualifying_volume, uint64_t & day) {
-  transaction_points_tables trx_points_from(get_self(), from.value);
-  qev_tables qevs(get_self(), from.value);
-  qev_tables qevs_total(get_self(), get_self().value);
+  add_trx_points(from, from_points, day);
+  add_qev(from.value, qualifying_volume, day);
+  add_qev(get_self().value, qualifying_volume, day);
+}
 
-  auto trx_itr = trx_points_from.find(day);
-  auto qev_itr = qevs.find(day);
-  auto qev_total_itr = qevs_total.find(day);
+void history::add_trx_points (name account, int64_t points, uint64_t day) {
+  transaction_points_tables trx_points(get_self(), account.value);
 
-  if (trx_itr != trx_points_from.end()) {
-    trx_points_from.modify(trx_itr, _self, [&](auto & item){
-      item.points += from_points;
+  auto trx_itr = trx_points.find(day);
+  if (trx_itr != trx_points.end()) {
+    trx_points.modify(trx_itr, _self, [&](auto & item){
+      item.points += points;
     });
   } else {
-    trx_points_from.emplace(_self, [&](auto & item){
+    trx_points.emplace(_self, [&](auto & item){
       item.timestamp = day;
-      item.points = from_points;
+      item.points = points;
     });
   }
 
+  add_window_points(account, points, day);
+}
+
+// scoped by account, or by the contract for the total
+void history::add_qev (uint64_t scope, int64_t qualifying_volume, uint64_t day) {
+  qev_tables qevs(get_self(), scope);
+
+  auto qev_itr = qevs.find(day);
   if (qev_itr != qevs.end()) {
     qevs.modify(qev_itr, _self, [&](auto & item){
       item.qualifying_volume += qualifying_volume;
@@ -387,34 +490,47 @@ void history::save_from_metrics (name from, int64_t & from_points, int64_t & qua
       item.qualifying_volume = qualifying_volume;
     });
   }
+}
 
-  if (qev_total_itr != qevs_total.end()) {
-    qevs_total.modify(qev_total_itr, _self, [&](auto & item){
-      item.qualifying_volume += qualifying_volume;
-    });
-  } else {
-    qevs_total.emplace(_self, [&](auto & item){
-      item.timestamp = day;
-      item.qualifying_volume = qualifying_volume;
+void history::add_window_points (name account, int64_t points, uint64_t day) {
+  uint64_t now = eosio::current_time_point().sec_since_epoch();
+  uint64_t cutoff = now - (utils::moon_cycle * config_float_get("cyctrx.trail"_n));
+
+  transaction_points_tables trx_points(get_self(), account.value);
+  trx_window_tables windows(get_self(), get_self().value);
+
+  auto witr = windows.find(account.value);
+
+  if (witr == windows.end()) {
+    // the rows are summed once, the day's row is already up to date
+    uint64_t total_points = 0;
+    uint64_t last_day = 0;
+    auto titr = trx_points.lower_bound(cutoff);
+    while (titr != trx_points.end()) {
+      total_points += titr -> points;
+      last_day = titr -> timestamp;
+      titr++;
+    }
+    windows.emplace(_self, [&](auto & item){
+      item.account = account;
+      item.points = total_points;
+      item.start = cutoff;
+      item.last_day = last_day;
     });
+    return;
   }
-}
-
-void history::send_trx_cbp_reward_action (name from, name to) {
-
-  uint64_t deferred_id = get_deferred_id();
-
-  action a(
-    permission_level(get_self(), "active"_n),
-    get_self(),
-    "sendtrxcbp"_n,
-    std::make_tuple(deferred_id, from, to)
-  );
 
-  transaction tx;
-  tx.actions.emplace_back(a);
-  tx.delay_sec = 1;
-  tx.send(deferred_id, _self);
+  windows.modify(witr, _self, [&](auto & item){
+    if (item.start < cutoff) {
+      uint64_t count = 0;
+      item.points = utils::trx_window_points(trx_points, item, cutoff, count);
+      item.start = cutoff;
+    }
+    if (day >= item.start) {
+      item.points = uint64_t(std::max(int64_t(item.points) + points, int64_t(0)));
+      item.last_day = std::max(item.last_day, day);
+    }
+  });
 }
 
 void history::send_add_cbs (name account, int points) {
@@ -459,6 +575,42 @@ void history::trx_cbp_reward (name account, name key) {
 void history::sendtrxcbp (uint64_t deferred_id, name from, name to) {
   require_auth(get_self());
 
+  cbp_rewards(from, to);
+}
+
+void history::send_trx_cbp (name from, name to) {
+  uint64_t deferred_id = utils::deferred_id(eosio::pack(std::make_tuple("sendtrxcbp"_n, from, to)));
+
+  action a(
+    permission_level(get_self(), "active"_n),
+    get_self(),
+    "sendtrxcbp"_n,
+    std::make_tuple(deferred_id, from, to)
+  );
+
+  transaction tx;
+  tx.actions.emplace_back(a);
+  tx.delay_sec = 1;
+  tx.send(deferred_id, _self);
+}
+
+bool history::has_cbp_rewards (name from, name to) {
+  auto oitr = organizations.find(to.value);
+
+  if (oitr != organizations.end() &&
+    (oitr->status == status_regenerative || oitr->status == status_thrivable)) {
+    return true;
+  }
+
+  auto bitr_from = members.find(from.value);
+  auto bitr_to = members.find(to.value);
+
+  return bitr_from != members.end() && 
+    bitr_to != members.end() && 
+    bitr_from->region == bitr_to->region;
+}
+
+void history::cbp_rewards (name from, name to) {
   auto oitr = organizations.find(to.value);
 
   if (oitr != organizations.end()) {
@@ -557,24 +709,6 @@ void history::updatetxpt (uint64_t deferred_id, name from) {
   );
 }
 
-void history::send_update_txpoints (name from) {
-  // delayed update
-
-  uint64_t deferred_id = get_deferred_id();
-
-  action a(
-    permission_level{get_self(), "active"_n},
-    get_self(),
-    "updatetxpt"_n,
-    std::make_tuple(deferred_id, from)
-  );
-
-  transaction tx;
-  tx.actions.emplace_back(a);
-  tx.delay_sec = 1; 
-  tx.send(deferred_id, _self);
-}
-
 void history::numtrx(name account) {
   auto titr = totals.find(account.value);
   uint64_t num = 0;
@@ -850,18 +984,7 @@ void history::adjust_transactions (uint64_t id, uint64_t timestamp) {
   save_from_metrics(from, from_points, qualifying_volume, day);
   
   if (uitr_to -> type == name("organisation")) {
-    transaction_points_tables trx_points_to(get_self(), to.value);
-    auto trx_itr_to = trx_points_to.find(day);
-    if (trx_itr_to != trx_points_to.end()) {
-      trx_points_to.modify(trx_itr_to, _self, [&](auto & item){
-        item.points += to_points;
-      });
-    } else {
-      trx_points_to.emplace(_self, [&](auto & item){
-        item.timestamp = day;
-        item.points = to_points;
-      });
-    }
+    add_trx_points(to, to_points, day);
   }
 }
 
@@ -908,7 +1031,7 @@ void history::cleanptrxs () {
     transaction tx;
     tx.actions.emplace_back(a);
     tx.delay_sec = 1; 
-    tx.send(get_deferred_id(), _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
@@ -633,7 +633,7 @@ void onboarding::cleanup(uint64_t start_id, uint64_t max_id, uint64_t batch_size
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
@@ -870,7 +870,7 @@ ACTION onboarding::rtrnfundsaux(uint64_t campaign_id)
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(campaign_id, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
   else
   {
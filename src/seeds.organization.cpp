@@ -162,6 +162,16 @@ ACTION organization::reset() {
         dsitr = dausscores.erase(dsitr);
     }
 
+    auto rbitr = rankbounds.begin();
+    while (rbitr != rankbounds.end()) {
+        rbitr = rankbounds.erase(rbitr);
+    }
+
+    auto rpitr = rankpasses.begin();
+    while (rpitr != rankpasses.end()) {
+        rpitr = rankpasses.erase(rpitr);
+    }
+
     auto bitr = sponsors.begin();
     while(bitr != sponsors.end()){
         bitr = sponsors.erase(bitr);
@@ -455,10 +465,10 @@ ACTION organization::subregen(name organization, name account, uint64_t amount)
 
 ACTION organization::rankregens() {
     auto batch_size = config.get(name("batchsize").value, "The batchsize parameter has not been initialized yet");
-    rankregen((uint64_t)0, (uint64_t)0, batch_size.value);
+    rankregen((uint64_t)0, (uint64_t)0, (uint64_t)0, batch_size.value);
 }
 
-ACTION organization::rankregen(uint64_t start, uint64_t chunk, uint64_t chunksize) {
+ACTION organization::rankregen(uint64_t start, uint64_t start_id, uint64_t chunk, uint64_t chunksize) {
     require_auth(get_self());
 
     check(chunksize > 0, "chunk size must be > 0");
@@ -468,7 +478,7 @@ ACTION organization::rankregen(uint64_t start, uint64_t chunk, uint64_t chunksiz
 
     uint64_t current = chunk * chunksize;
     auto regen_score_by_avg_regen = regenscores.get_index<"byregenavg"_n>();
-    auto rsitr = start == 0 ? regen_score_by_avg_regen.begin() : regen_score_by_avg_regen.lower_bound(start);
+    auto rsitr = utils::cursor_seek(regen_score_by_avg_regen, start, start_id);
     uint64_t count = 0;
 
     while (rsitr != regen_score_by_avg_regen.end() && count < chunksize) {
@@ -489,7 +499,7 @@ ACTION organization::rankregen(uint64_t start, uint64_t chunk, uint64_t chunksiz
             permission_level(get_self(), "active"_n),
             get_self(),
             "rankregen"_n,
-            std::make_tuple((rsitr -> org_name).value, chunk + 1, chunksize)
+            std::make_tuple(rsitr->by_regen_avg(), (rsitr -> org_name).value, chunk + 1, chunksize)
         );
         transaction tx;
         tx.actions.emplace_back(next_execution);
@@ -544,7 +554,8 @@ void organization::check_status_requirements (name organization, uint64_t status
 
     rep_tables rep_t(contracts::accounts, name("org").value);
     auto repitr = rep_t.get(organization.value, "organization does not have reputation");
-    check(repitr.rank >= min_rep_rank, "organization has less than the required reputation rank");
+    uint64_t rep_rank = utils::rank_resolver(contracts::accounts, rankings::org_rep).rank(repitr.by_rep(), repitr.rank);
+    check(rep_rank >= min_rep_rank, "organization has less than the required reputation rank");
 
     check(oitr->regen >= min_regen_score, "organization has less than the required regen score");
 
@@ -608,6 +619,9 @@ ACTION organization::registerapp (name owner, name organization, name appname, s
         app.app_long_name = applongname;
         app.is_banned = false;
         app.number_of_uses = 0;
+        app.trailing_points.emplace(0);
+        app.trailing_users.emplace(0);
+        app.window_start.emplace(0);
     });
 
     increase_size_by_one(app_size);
@@ -633,11 +647,12 @@ ACTION organization::appuse (name appname, name account) {
     check(appitr != apps.end(), "This application does not exist.");
     check(!(appitr -> is_banned), "Can not use a banned app.");
 
-     apps.modify(appitr, _self, [&](auto & app){
-        app.number_of_uses += 1;
-    });
-
-    if (uitr.status != "citizen"_n && uitr.status != "resident"_n) { return; }
+    if (uitr.status != "citizen"_n && uitr.status != "resident"_n) {
+        apps.modify(appitr, _self, [&](auto & app){
+            app.number_of_uses += 1;
+        });
+        return;
+    }
 
     daus_tables daus(get_self(), appname.value);
     daus_totals_tables daus_totals(get_self(), appname.value);
@@ -652,6 +667,9 @@ ACTION organization::appuse (name appname, name account) {
     uint64_t points = uitr.status == "citizen"_n ? config_get("dau.cit.pt"_n) : config_get("dau.res.pt"_n);
     points *= utils::get_rep_multiplier(account);
 
+    int64_t added_points = 0;
+    uint64_t added_users = 0;
+
     if (ditr != daus_by_day_account.end()) {
         uint64_t max_uses = config_get("dau.maxuse"_n);
         if (ditr->number_app_uses < max_uses) {
@@ -662,6 +680,7 @@ ACTION organization::appuse (name appname, name account) {
             daus_totals.modify(dtitr, _self, [&](auto & item){
                 item.daily_points += points;
             });
+            added_points = points;
         }
     } else {
         daus.emplace(_self, [&](auto & item){
@@ -684,8 +703,18 @@ ACTION organization::appuse (name appname, name account) {
                 item.daily_users = 1;
             });
         }
-
+        added_points = points;
+        added_users = 1;
     }
+
+    // apps that predate the running totals get them from calcmappuse
+    apps.modify(appitr, _self, [&](auto & app){
+        app.number_of_uses += 1;
+        if (app.window_start.has_value()) {
+            app.trailing_points.emplace(app.trailing_points.value_or(0) + added_points);
+            app.trailing_users.emplace(app.trailing_users.value_or(0) + added_users);
+        }
+    });
 }
 
 ACTION organization::calcmappuses () {
@@ -714,7 +743,7 @@ ACTION organization::calcmappuse (uint64_t start, uint64_t chunksize, uint64_t t
         print("app:", appitr->app_name, "\n");
 
         if (!appitr->is_banned) {
-            calculate_trailing_app_use(appitr->app_name, cutoff, threshold);
+            calculate_trailing_app_use(appitr, cutoff, threshold);
         } else {
             auto dsitr = dausscores.find(appitr->app_name.value);
             if (dsitr != dausscores.end()) {
@@ -735,24 +764,45 @@ ACTION organization::calcmappuse (uint64_t start, uint64_t chunksize, uint64_t t
         transaction tx;
         tx.actions.emplace_back(next_execution);
         tx.delay_sec = 1;
-        tx.send((appitr->app_name).value, _self);
+        tx.send(utils::deferred_id(tx), _self);
     }
 }
 
-void organization::calculate_trailing_app_use (const name & appname, const uint64_t & cutoff, const int64_t & threshold) {
+void organization::calculate_trailing_app_use (app_tables::const_iterator & appitr, const uint64_t & cutoff, const int64_t & threshold) {
 
+    name appname = appitr->app_name;
     daus_totals_tables daus_totals(get_self(), appname.value);
 
-    int64_t trailing_points = 0;
-    uint64_t trailing_uses = 0;
-
-    auto dtitr = daus_totals.rbegin();
-    while (dtitr != daus_totals.rend() && dtitr->day >= cutoff) {
-        trailing_points += dtitr->daily_points;
-        trailing_uses += dtitr->daily_users;
-        dtitr++;
+    int64_t trailing_points = appitr->trailing_points.value_or(0);
+    uint64_t trailing_uses = appitr->trailing_users.value_or(0);
+    uint64_t window_start = appitr->window_start.value_or(0);
+
+    if (!appitr->window_start.has_value() || cutoff < window_start) {
+        // no running total yet, or the window grew: sum the window once
+        trailing_points = 0;
+        trailing_uses = 0;
+        auto dtitr = daus_totals.lower_bound(cutoff);
+        while (dtitr != daus_totals.end()) {
+            trailing_points += dtitr->daily_points;
+            trailing_uses += dtitr->daily_users;
+            dtitr++;
+        }
+    } else {
+        // expire only the days that left the window since the last run
+        auto dtitr = daus_totals.lower_bound(window_start);
+        while (dtitr != daus_totals.end() && dtitr->day < cutoff) {
+            trailing_points -= dtitr->daily_points;
+            trailing_uses -= dtitr->daily_users;
+            dtitr++;
+        }
     }
 
+    apps.modify(appitr, _self, [&](auto & app){
+        app.trailing_points.emplace(trailing_points);
+        app.trailing_users.emplace(trailing_uses);
+        app.window_start.emplace(cutoff);
+    });
+
     auto dsitr = dausscores.find(appname.value);
     if (dsitr != dausscores.end()) {
         if (trailing_points >= threshold) {
@@ -778,10 +828,10 @@ void organization::calculate_trailing_app_use (const name & appname, const uint6
 ACTION organization::rankappuses () {
     require_auth(get_self());
     uint64_t batch_size = config_get("batchsize"_n);
-    rankappuse(uint128_t(0), uint64_t(0), batch_size);
+    rankappuse(uint128_t(0), uint64_t(0), batch_size * utils::rank_write_cost);
 }
 
-ACTION organization::rankappuse (uint128_t start, uint64_t chunk, uint64_t chunksize) {
+ACTION organization::rankappuse (uint128_t start, uint64_t current, uint64_t chunksize) {
     require_auth(get_self());
 
     check(chunksize > 0, "chunk size must be > 0");
@@ -789,35 +839,42 @@ ACTION organization::rankappuse (uint128_t start, uint64_t chunk, uint64_t chunk
     uint64_t total = get_size(app_use_size);
     if (total == 0) return;
 
-    uint64_t current = chunk * chunksize;
+    bool lazy = config_get("rank.lazy"_n) > 0;
+    utils::rank_pass<rank_bounds_tables, rank_pass_tables> pass(rankbounds, rankpasses, _self, rankings::app_use, utils::spline_curve, lazy, total, current);
+
     auto daus_scores_by_total_points = dausscores.get_index<"bytpointsapp"_n>();
     auto dsitr = start == 0 ? daus_scores_by_total_points.begin() : daus_scores_by_total_points.lower_bound(start);
     uint64_t count = 0;
 
     while (dsitr != daus_scores_by_total_points.end() && count < chunksize) {
         
-        uint64_t rank = utils::spline_rank(current, total);
+        uint64_t rank = pass.next(dsitr->by_total_points_app());
         
-        daus_scores_by_total_points.modify(dsitr, _self, [&](auto & item){
-            item.rank = rank;
-        });
+        if (pass.should_write(dsitr->rank, rank)) {
+            daus_scores_by_total_points.modify(dsitr, _self, [&](auto & item){
+                item.rank = rank;
+            });
+            count += utils::rank_write_cost;
+        } else {
+            count += utils::rank_read_cost;
+        }
 
-        current++;
-        count++;
         dsitr++;
     }
 
+    pass.save(dsitr == daus_scores_by_total_points.end());
+
     if (dsitr != daus_scores_by_total_points.end()) {
         action next_execution(
             permission_level(get_self(), "active"_n),
             get_self(),
             "rankappuse"_n,
-            std::make_tuple(dsitr->by_total_points_app(), chunk + 1, chunksize)
+            std::make_tuple(dsitr->by_total_points_app(), pass.position(), chunksize)
         );
         transaction tx;
         tx.actions.emplace_back(next_execution);
         tx.delay_sec = 1;
-        tx.send((dsitr->app_name).value, _self);
+        tx.send(utils::deferred_id(tx), _self);
     }
 
 }
@@ -66,7 +66,7 @@ void policy::createexp(name account, string backend_user_id, string device_id, s
   transaction tx;
   tx.actions.emplace_back(delete_action);
   tx.delay_sec = expiry_seconds;
-  tx.send(policy_id, _self);
+  tx.send(utils::deferred_id(tx), _self);
 }
 
 void policy::update(uint64_t id, name account, string backend_user_id, string device_id, string signature, string policy)
@@ -1,4 +1,5 @@
 #include <seeds.pool.hpp>
+#include <cmath>
 
 
 ACTION pool::reset () {
@@ -13,6 +14,8 @@ ACTION pool::reset () {
   while (sitr != sizes.end()) {
     sitr = sizes.erase(sitr);
   }
+
+  payoutindex.remove();
 }
 
 
@@ -28,13 +31,19 @@ ACTION pool::ontransfer (name from, name to, asset quantity, string memo) {
     name account = name(memo);
     check(is_account(account), account.to_string() + " is not an account");
 
+    realize(account);
+
+    auto index = payoutindex.get_or_default();
     auto bitr = balances.find(account.value);
 
     if (bitr == balances.end()) {
       balances.emplace(_self, [&](auto & item){
         item.account = account;
         item.balance = quantity;
+        item.factor.emplace(index.factor);
+        item.epoch.emplace(index.epoch);
       });
+      size_change(accounts_size, 1);
     } else {
       balances.modify(bitr, _self, [&](auto & item){
         item.balance += quantity;
@@ -42,6 +51,7 @@ ACTION pool::ontransfer (name from, name to, asset quantity, string memo) {
     }
     
     size_change(total_balance_size, quantity.amount);
+    size_change(stored_balance_size, quantity.amount);
   }
 
 }
@@ -51,60 +61,83 @@ ACTION pool::payouts (asset quantity) {
 
   require_auth(get_self());
 
-  uint64_t batch_size = config_get("batchsize"_n);
-  payout(quantity, uint64_t(0), batch_size, uint64_t(0));
+  int64_t total_balance = int64_t(get_size(total_balance_size));
+
+  if (total_balance <= 0) { return; }
+  if (quantity.amount <= 0) { return; }
+  if (total_balance < quantity.amount) { return; }
+
+  auto index = payoutindex.get_or_default();
+
+  if (total_balance == quantity.amount) {
+    index.factor = 1.0;
+    index.epoch += 1;
+  } else {
+    index.factor *= double(total_balance - quantity.amount) / double(total_balance);
+  }
+
+  payoutindex.set(index, _self);
+  size_change(total_balance_size, -1 * quantity.amount);
+  size_set(pending_size, get_size(accounts_size));
 
 }
 
 
-ACTION pool::payout (asset quantity, uint64_t start, uint64_t chunksize, int64_t old_total_balance) {
+ACTION pool::claim (name account) {
 
-  require_auth(get_self());
+  require_auth(account);
 
-  auto bitr = start == 0 ? balances.begin() : balances.lower_bound(start);
-  uint64_t current = 0;
+  check(balances.find(account.value) != balances.end(), account.to_string() + " has no balance in the pool");
+  realize(account);
 
-  int64_t total_balance = old_total_balance == 0 ? int64_t(get_size(total_balance_size)) : old_total_balance;
+}
 
-  if (total_balance <= 0) { return; }
-  if (quantity.amount <= 0) { return; }
-  if (total_balance < quantity.amount) { return; }
 
-  double total_balance_divisor = double(total_balance);
-  string memo("dSeeds pool distribution");
+// pays out what the account's share of the payouts since it last realized amounts to
+// shares are truncated, the last account to realize a payout takes the dust the others left
+void pool::realize (const name & account) {
 
-  while (bitr != balances.end() && current < chunksize) {
+  auto bitr = balances.find(account.value);
+  if (bitr == balances.end()) { return; }
 
-    double percentage = bitr->balance.amount / total_balance_divisor;
-    asset amount_to_payout = asset(std::min(bitr->balance.amount, int64_t(percentage * quantity.amount)), utils::seeds_symbol);
-    
-    send_transfer(bitr->account, amount_to_payout, memo);
-    size_change(total_balance_size, -1 * amount_to_payout.amount);
+  auto index = payoutindex.get_or_default();
 
-    if (bitr->balance == amount_to_payout) {
-      bitr = balances.erase(bitr);
-    } else {
-      balances.modify(bitr, _self, [&](auto & item){
-        item.balance -= amount_to_payout;
-      });
-      bitr++;
+  int64_t stored = bitr->balance.amount;
+  int64_t current = 0;
+  if (bitr->epoch.value_or(0) == index.epoch) {
+    double exact = stored * (index.factor / bitr->factor.value_or(1.0));
+    int64_t owed = std::max(int64_t(0), std::min(stored, int64_t(std::floor(stored - exact))));
+    current = stored - owed;
+  }
+
+  bool stale = bitr->epoch.value_or(0) != index.epoch || bitr->factor.value_or(1.0) != index.factor;
+  uint64_t pending = get_size(pending_size);
+
+  if (stale && pending > 0) {
+    size_change(pending_size, -1);
+    if (pending == 1) {
+      int64_t others = int64_t(get_size(stored_balance_size)) - stored;
+      int64_t rest = int64_t(get_size(total_balance_size)) - others;
+      current = std::max(int64_t(0), std::min(stored, rest));
     }
+  }
 
-    current += 8;
+  asset amount_to_payout = asset(stored - current, utils::seeds_symbol);
+  size_change(stored_balance_size, -1 * amount_to_payout.amount);
+
+  if (current == 0) {
+    balances.erase(bitr);
+    size_change(accounts_size, -1);
+  } else {
+    balances.modify(bitr, _self, [&](auto & item){
+      item.balance = asset(current, utils::seeds_symbol);
+      item.factor.emplace(index.factor);
+      item.epoch.emplace(index.epoch);
+    });
   }
 
-  if (bitr != balances.end()) {
-    action next_execution(
-      permission_level(get_self(), "active"_n),
-      get_self(),
-      "payout"_n,
-      std::make_tuple(asset(quantity.amount, utils::seeds_symbol), bitr->account.value, chunksize, total_balance)
-    );
-
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(bitr->account.value, _self);
+  if (amount_to_payout.amount > 0) {
+    send_transfer(account, amount_to_payout, string("dSeeds pool distribution"));
   }
 }
 
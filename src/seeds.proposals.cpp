@@ -36,6 +36,23 @@ void proposals::reset() {
     while (sitr != support.end()) {
       sitr = support.erase(sitr);
     }
+
+    delegation_pool_tables pools(get_self(), s.value);
+    auto poitr = pools.begin();
+    while (poitr != pools.end()) {
+      pool_spend_tables spends(get_self(), poitr -> delegatee.value);
+      auto spitr = spends.begin();
+      while (spitr != spends.end()) {
+        spitr = spends.erase(spitr);
+      }
+      poitr = pools.erase(poitr);
+    }
+  }
+
+  voice_decay_tables voicedecay(get_self(), get_self().value);
+  auto vditr = voicedecay.begin();
+  while (vditr != voicedecay.end()) {
+    vditr = voicedecay.erase(vditr);
   }
 
   auto paitr = participants.begin();
@@ -66,6 +83,11 @@ void proposals::reset() {
 
   cycle.remove();
 
+  eval_queue_tables evalqueue_t(get_self(), get_self().value);
+  evalqueue_t.remove();
+
+  utils::delete_table<eval_skip_tables>(get_self(), get_self().value);
+
 }
 
 bool proposals::is_enough_stake(asset staked, asset quantity, name fund) {
@@ -218,6 +240,7 @@ void proposals::calcvotepow() {
   DEFINE_CS_POINTS_TABLE_MULTI_INDEX
 
   cs_points_tables cspoints(contracts::harvest, contracts::harvest.value);
+  utils::rank_resolver cs_rank(contracts::harvest, rankings::cs);
   uint64_t cutoff_date = active_cutoff_date();
   uint64_t vote_power = 0;
   uint64_t voice_size = 0;
@@ -228,7 +251,7 @@ void proposals::calcvotepow() {
       auto csitr = cspoints.find(vitr->account.value);
       uint64_t points = 0;
       if (csitr != cspoints.end()) {
-        points = csitr -> rank;
+        points = cs_rank.rank(csitr->by_cs_points(), csitr->rank);
       }
 
       vote_power += points;
@@ -314,7 +337,18 @@ uint64_t proposals::active_cutoff_date() {
 
 bool proposals::is_active(name account, uint64_t cutoff_date) {
   auto aitr = actives.find(account.value);
-  return aitr != actives.end() && aitr->timestamp > cutoff_date;
+  if (aitr != actives.end() && aitr->timestamp > cutoff_date) {
+    return true;
+  }
+
+  // delegators vote through their delegatee's pool
+  delegate_trust_tables deltrusts(get_self(), get_self().value);
+  auto ditr = deltrusts.find(account.value);
+  if (ditr == deltrusts.end()) {
+    return false;
+  }
+  auto daitr = actives.find(ditr->delegatee.value);
+  return daitr != actives.end() && daitr->timestamp > cutoff_date;
 }
 
 void proposals::send_create_invite (
@@ -403,6 +437,13 @@ ACTION proposals::checkprop (uint64_t proposal_id, string message) {
   check(check_prop_majority(pitr.favour, pitr.against), msg);
 }
 
+ACTION proposals::voiceof (name account, name scope) {
+  voice_tables voice_t(get_self(), scope.value);
+  auto vitr = voice_t.find(account.value);
+  uint64_t balance = vitr == voice_t.end() ? 0 : get_voice(*vitr, scope);
+  print("{\"account\":\"", account, "\",\"scope\":\"", scope, "\",\"voice\":", balance, "}");
+}
+
 ACTION proposals::doneprop (uint64_t proposal_id) {
   require_auth(get_self());
   
@@ -416,12 +457,21 @@ ACTION proposals::doneprop (uint64_t proposal_id) {
   });
 }
 
+// a proposal that can not be evaluated is skipped and recorded in evalskips instead of failing,
+// so one bad proposal does not roll back the batch it is evaluated in
 void proposals::evalproposal (uint64_t proposal_id, uint64_t prop_cycle) {
   require_auth(get_self());
 
   auto pitr = props.find(proposal_id);
   if (pitr == props.end()) { return; }
 
+  if (pitr->stage != stage_active && pitr->stage != stage_staged) { return; }
+
+  if (!cycle.exists() || cyclestats.find(cycle.get().propcycle) == cyclestats.end()) {
+    skip_eval(proposal_id, prop_cycle, "no stats for the current cycle");
+    return;
+  }
+
   uint64_t number_active_proposals = 0;
   uint64_t quorum_votes_needed = 0;
 
@@ -459,6 +509,40 @@ void proposals::evalproposal (uint64_t proposal_id, uint64_t prop_cycle) {
       passed = false;
     }
 
+    // everything the evaluation pays is checked before anything is paid
+    std::map<name, int64_t> outflows;
+    asset payout_amount = asset(0, seeds_symbol);
+
+    if (passed && valid_quorum) {
+      if (pitr->status == status_open) {
+        outflows[contracts::bank] += pitr->staked.amount;
+        if (is_alliance_type || is_milestone_type) {
+          payout_amount = pitr->quantity;
+        } else if (is_campaign_type) {
+          payout_amount = get_payout_amount(pitr->pay_percentages, 0, pitr->quantity, pitr->current_payout);
+        }
+      } else if (is_campaign_type) {
+        payout_amount = get_payout_amount(pitr->pay_percentages, pitr->age + 1, pitr->quantity, pitr->current_payout);
+      }
+      outflows[pitr->fund] += payout_amount.amount;
+    } else if (pitr->status != status_evaluate) {
+      outflows[contracts::bank] += pitr->staked.amount;
+    }
+
+    if (!payout_amount.is_valid() || payout_amount.amount < 0) {
+      skip_eval(proposal_id, prop_cycle, "invalid payout " + payout_amount.to_string());
+      return;
+    }
+
+    if (!can_pay(outflows)) {
+      skip_eval(proposal_id, prop_cycle, "not enough funds to pay " + payout_amount.to_string() + " from " + pitr->fund.to_string());
+      return;
+    }
+
+    for (auto & [account, amount] : outflows) {
+      eval_outflows[account] += amount;
+    }
+
     if (passed && valid_quorum) {
 
       if (pitr -> status == status_open) {
@@ -466,16 +550,11 @@ void proposals::evalproposal (uint64_t proposal_id, uint64_t prop_cycle) {
         refund_staked(pitr->creator, pitr->staked);
         change_rep(pitr->creator, true);
 
-        asset payout_amount;
-
         if (is_alliance_type) { 
-          payout_amount = pitr->quantity;
           send_to_escrow(pitr->fund, pitr->recipient, payout_amount, "proposal id: "+std::to_string(pitr->id));
         } else if (is_milestone_type) {
-          payout_amount = pitr->quantity;
           withdraw(pitr->recipient, payout_amount, pitr->fund, "");
         } else if (is_campaign_type) {
-          payout_amount = get_payout_amount(pitr->pay_percentages, 0, pitr->quantity, pitr->current_payout);
           if (pitr->campaign_type == campaign_invite_type) {
             withdraw(get_self(), payout_amount, pitr->fund, "invites");
             withdraw(contracts::onboarding, payout_amount, get_self(), "sponsor " + (get_self()).to_string());
@@ -508,13 +587,8 @@ void proposals::evalproposal (uint64_t proposal_id, uint64_t prop_cycle) {
         
         uint64_t age = pitr -> age + 1;
 
-        asset payout_amount;
-
         if (is_campaign_type) {
-          payout_amount = get_payout_amount(pitr->pay_percentages, age, pitr->quantity, pitr->current_payout);
-          withdraw(pitr->recipient, payout_amount, pitr->fund, "");// TODO limit by amount available
-        } else {
-          payout_amount = asset(0, utils::seeds_symbol);
+          withdraw(pitr->recipient, payout_amount, pitr->fund, "");
         }
 
         uint64_t num_cycles = pitr -> pay_percentages.size() - 1;
@@ -585,18 +659,63 @@ void proposals::evalproposal (uint64_t proposal_id, uint64_t prop_cycle) {
     update_cycle_stats_from_proposal(pitr->id, prop_type, stage_active);
   }
 
+  eval_skip_tables evalskips(get_self(), get_self().value);
+  auto sitr = evalskips.find(proposal_id);
+  if (sitr != evalskips.end()) {
+    evalskips.erase(sitr);
+  }
+
 }
 
-void proposals::send_eval_prop (uint64_t proposal_id, uint64_t prop_cycle) {
+void proposals::send_eval_props () {
   transaction trx{};
   trx.actions.emplace_back(
     permission_level(get_self(), "active"_n),
     get_self(),
-    "evalproposal"_n,
-    std::make_tuple(proposal_id, prop_cycle)
+    "evalprops"_n,
+    std::make_tuple()
   );
   // trx.delay_sec = 1;
-  trx.send(proposal_id, _self);
+  trx.send(utils::deferred_id(trx), _self);
+}
+
+// the accounts hold what they pay, on top of what earlier evaluations of this action pay
+bool proposals::can_pay (const std::map<name, int64_t> & outflows) {
+  for (auto & [account, amount] : outflows) {
+    if (amount <= 0) { continue; }
+
+    token::accounts balances(contracts::token, account.value);
+    auto bitr = balances.find(seeds_symbol.code().raw());
+    int64_t balance = bitr == balances.end() ? 0 : bitr->balance.amount;
+
+    auto oitr = eval_outflows.find(account);
+    int64_t paid = oitr == eval_outflows.end() ? 0 : oitr->second;
+
+    if (balance - paid < amount) { return false; }
+  }
+  return true;
+}
+
+void proposals::skip_eval (uint64_t proposal_id, uint64_t prop_cycle, string reason) {
+  print("skipped proposal ", proposal_id, ": ", reason, "\n");
+
+  eval_skip_tables evalskips(get_self(), get_self().value);
+  auto sitr = evalskips.find(proposal_id);
+
+  if (sitr == evalskips.end()) {
+    evalskips.emplace(_self, [&](auto & item){
+      item.proposal_id = proposal_id;
+      item.prop_cycle = prop_cycle;
+      item.reason = reason;
+      item.timestamp = eosio::current_time_point().sec_since_epoch();
+    });
+  } else {
+    evalskips.modify(sitr, _self, [&](auto & item){
+      item.prop_cycle = prop_cycle;
+      item.reason = reason;
+      item.timestamp = eosio::current_time_point().sec_since_epoch();
+    });
+  }
 }
 
 void proposals::send_update_voices () {
@@ -608,12 +727,17 @@ void proposals::send_update_voices () {
     std::make_tuple(uint64_t(0))
   );
   // trx.delay_sec = 1;
-  trx.send(eosio::current_time_point().sec_since_epoch() + contracts::proposals.value, _self);
+  trx.send(utils::deferred_id(trx), _self);
 }
 
 void proposals::onperiod() {
   require_auth(get_self());
 
+  eval_queue_tables evalqueue_t(get_self(), get_self().value);
+  eval_queue_table q = evalqueue_t.get_or_create(get_self(), eval_queue_table());
+
+  check(q.stage == name(), "proposals of the previous cycle are still being evaluated");
+
   cycle_table c = cycle.get_or_create(get_self(), cycle_table());
 
   auto citr = cyclestats.find(c.propcycle);
@@ -623,35 +747,70 @@ void proposals::onperiod() {
     });
   }
 
-  uint64_t number_active_proposals = get_size(prop_active_size);
+  q.prop_cycle = c.propcycle;
+  q.stage = stage_active;
+  q.next_id = 0;
+  q.end_id = props.available_primary_key();
+  q.active_proposals = get_size(prop_active_size);
+  evalqueue_t.set(q, get_self());
 
-  auto props_by_stage = props.get_index<"bystage"_n>();
+  update_cycle();
+  init_cycle_new_stats();
+  send_eval_props();
+}
 
-  auto spitr = props_by_stage.find(stage_staged.value);
-  while (spitr != props_by_stage.end() && spitr->stage == stage_staged) {
-    send_eval_prop(spitr->id, c.propcycle);
-    spitr++;
+ACTION proposals::evalprops() {
+  require_auth(get_self());
+
+  eval_queue_tables evalqueue_t(get_self(), get_self().value);
+  eval_queue_table q = evalqueue_t.get_or_create(get_self(), eval_queue_table());
+
+  if (q.stage == name()) { return; }
+
+  uint64_t batch_size = config_get("prop.evl.bt"_n);
+  uint64_t count = 0;
+
+  auto props_by_stage_id = props.get_index<"bystageid"_n>();
+
+  while (q.stage != name() && count < batch_size) {
+    auto pitr = props_by_stage_id.lower_bound((uint128_t(q.stage.value) << 64) + q.next_id);
+
+    if (pitr == props_by_stage_id.end() || pitr->stage != q.stage || pitr->id >= q.end_id) {
+      // active proposals go first, so staged ones activated below are not evaluated twice
+      if (q.stage == stage_active) {
+        q.stage = stage_staged;
+        q.next_id = 0;
+      } else {
+        q.stage = name();
+      }
+      continue;
+    }
+
+    // evaluating may activate staged proposals, the cursor moves past this one first
+    q.next_id = pitr->id + 1;
+    evalproposal(pitr->id, q.prop_cycle);
+    count++;
   }
 
-  auto apitr = props_by_stage.find(stage_active.value);
-  while (apitr != props_by_stage.end() && apitr->stage == stage_active) {
-    send_eval_prop(apitr->id, c.propcycle);
-    apitr++;
+  evalqueue_t.set(q, get_self());
+
+  // the batch evaluated inline, so the voice update and cleanup below only start once all are done
+  if (q.stage != name()) {
+    send_eval_props();
+    return;
   }
 
-  update_cycle();
-  init_cycle_new_stats();
   send_update_voices();
-  
+
   transaction trx_erase_participants{};
   trx_erase_participants.actions.emplace_back(
     permission_level(_self, "active"_n),
     _self,
     "erasepartpts"_n,
-    std::make_tuple(number_active_proposals)
+    std::make_tuple(q.active_proposals)
   );
   // trx_erase_participants.delay_sec = 5;
-  trx_erase_participants.send(eosio::current_time_point().sec_since_epoch(), _self);
+  trx_erase_participants.send(utils::deferred_id(trx_erase_participants), _self);
 }
 
 void proposals::testevalprop (uint64_t proposal_id, uint64_t prop_cycle) {
@@ -775,6 +934,7 @@ void proposals::updatevoice(uint64_t start) {
   uint64_t cutoff_date = active_cutoff_date();
 
   cs_points_tables cspoints(contracts::harvest, contracts::harvest.value);
+  utils::rank_resolver cs_rank(contracts::harvest, rankings::cs);
 
   auto vitr = start == 0 ? voice.begin() : voice.find(start);
 
@@ -792,7 +952,7 @@ void proposals::updatevoice(uint64_t start) {
       auto csitr = cspoints.find(vitr->account.value);
       uint64_t points = 0;
       if (csitr != cspoints.end()) {
-        points = csitr -> rank;
+        points = cs_rank.rank(csitr->by_cs_points(), csitr->rank);
       }
 
       set_voice(vitr -> account, points, ""_n);
@@ -821,7 +981,7 @@ void proposals::updatevoice(uint64_t start) {
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
@@ -850,60 +1010,121 @@ void proposals::decayvoices() {
   ) {
     c.t_voicedecay = now;
     cycle.set(c, get_self());
-    uint64_t batch_size = config_get(name("batchsize"));
-    decayvoice(0, batch_size);
+    decay_voice();
   }
 }
 
-void proposals::decayvoice(uint64_t start, uint64_t chunksize) {
-  require_auth(get_self());
-
-  voice_tables voice_alliance(get_self(), alliance_type.value);
-  voice_tables voice_milestone(get_self(), milestone_type.value);
-
+void proposals::decay_voice() {
   uint64_t percentage_decay = config_get(name("vdecayprntge"));
   check(percentage_decay <= 100, "Voice decay parameter can not be more than 100%.");
-  auto vitr = start == 0 ? voice.begin() : voice.find(start);
-  uint64_t count = 0;
 
   double multiplier = (100.0 - (double)percentage_decay) / 100.0;
 
-  while (vitr != voice.end() && count < chunksize) {
-    auto vaitr = voice_alliance.find(vitr->account.value);
-    auto hvitr = voice_milestone.find(vitr->account.value);
-
-    voice.modify(vitr, _self, [&](auto & v){
-      v.balance *= multiplier;
-    });
+  voice_decay_tables voicedecay(get_self(), get_self().value);
 
-    if (vaitr != voice_alliance.end()) {
-      voice_alliance.modify(vaitr, _self, [&](auto & va){
-        va.balance *= multiplier;
+  for (auto & s : { get_self(), alliance_type, milestone_type }) {
+    auto vditr = voicedecay.find(s.value);
+    if (vditr != voicedecay.end()) {
+      voicedecay.modify(vditr, _self, [&](auto & item){
+        item.factor *= multiplier;
       });
-    }
-
-    if (hvitr != voice_milestone.end()) {
-      voice_milestone.modify(hvitr, _self, [&](auto & hv){
-        hv.balance *= multiplier;
+    } else {
+      voicedecay.emplace(_self, [&](auto & item){
+        item.scope = s;
+        item.factor = multiplier;
       });
     }
-    vitr++;
-    count++;
   }
+}
 
-  if (vitr != voice.end()) {
-    uint64_t next_value = vitr->account.value;
-    action next_execution(
-        permission_level{get_self(), "active"_n},
-        get_self(),
-        "decayvoice"_n,
-        std::make_tuple(next_value, chunksize)
-    );
+double proposals::voice_decay_factor(name scope) {
+  voice_decay_tables voicedecay(get_self(), get_self().value);
+  auto vditr = voicedecay.find(scope.value);
+  return vditr != voicedecay.end() ? vditr->factor : 1.0;
+}
 
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(next_value, _self);
+uint64_t proposals::voice_balance(const voice_table & v, double factor) {
+  double written = v.decay_factor.value_or(1.0);
+  if (written == factor) {
+    return v.balance;
+  }
+  return v.balance * (factor / written);
+}
+
+void proposals::write_voice(voice_table & v, uint64_t amount, double factor) {
+  v.balance = amount;
+  v.decay_factor.emplace(factor);
+}
+
+double proposals::pool_units(uint64_t balance, double decay_factor, double pool_factor) {
+  double scale = decay_factor * pool_factor;
+  return scale > 0 ? balance / scale : 0.0;
+}
+
+uint64_t proposals::get_voice(const voice_table & v, name scope) {
+  double factor = voice_decay_factor(scope);
+
+  delegate_trust_tables deltrusts(get_self(), scope.value);
+  auto ditr = deltrusts.find(v.account.value);
+  if (ditr == deltrusts.end() || !ditr->pool_factor.has_value()) {
+    return voice_balance(v, factor);
+  }
+
+  delegation_pool_tables pools(get_self(), scope.value);
+  auto pitr = pools.find(ditr->delegatee.value);
+  if (pitr == pools.end() || pitr->epoch != ditr->pool_epoch.value_or(0)) {
+    return 0;
+  }
+
+  uint64_t balance = voice_balance(v, factor);
+  double written = ditr->pool_factor.value();
+  double live = pool_live_factor(*pitr, scope);
+  if (written == live) {
+    return balance;
+  }
+  if (!(written > 0)) {
+    return 0;
+  }
+  // what the pool spent is rounded down, as a delegator's own vote was
+  return balance - uint64_t(balance * (1.0 - live / written));
+}
+
+// writes a voice balance, keeping the delegation pool of a delegator in sync
+void proposals::store_voice(name user, name scope, uint64_t amount) {
+  voice_tables voice_t(get_self(), scope.value);
+  auto vitr = voice_t.find(user.value);
+  double factor = voice_decay_factor(scope);
+
+  delegate_trust_tables deltrusts(get_self(), scope.value);
+  auto ditr = deltrusts.find(user.value);
+
+  if (ditr != deltrusts.end() && ditr->pool_factor.has_value()) {
+    delegation_pool_tables pools(get_self(), scope.value);
+    pool_link link = refresh_pool(pools, ditr->delegatee);
+    auto pitr = pools.find(ditr->delegatee.value);
+
+    // the units written before are kept for the votes the pool cast before this write
+    double written_units = 0.0;
+    if (vitr != voice_t.end()) {
+      written_units = pool_units(vitr->balance, vitr->decay_factor.value_or(1.0), ditr->pool_factor.value());
+    }
+    double old_units = ditr->pool_epoch.value_or(0) == pitr->epoch ? written_units : 0.0;
+
+    add_pool_units(pools, ditr->delegatee, pool_units(amount, factor, link.live_factor) - old_units);
+    deltrusts.modify(ditr, _self, [&](auto & item){
+      write_pool_share(item, link.live_factor, pitr->epoch, written_units, item.pool_epoch.value_or(0));
+    });
+  }
+
+  if (vitr == voice_t.end()) {
+    voice_t.emplace(_self, [&](auto & voice){
+      voice.account = user;
+      write_voice(voice, amount, factor);
+    });
+  } else {
+    voice_t.modify(vitr, _self, [&](auto & voice){
+      write_voice(voice, amount, factor);
+    });
   }
 }
 
@@ -1346,8 +1567,9 @@ void proposals::erasepartpts(uint64_t active_proposals) {
   // TODO: If there was delegation, this should be multiplied by delegation factor, e.g. 0.8 for example
   uint64_t reward_points = config_get(name("voterep1.ind"));
 
-  uint64_t counter = 0;
-  auto pitr = participants.begin();
+  // delegators take part through the votes of their delegatees' pools, they are added before the rewards
+  uint64_t counter = credit_pools(batch_size);
+  auto pitr = counter < batch_size ? participants.begin() : participants.end();
   while (pitr != participants.end() && counter < batch_size) {
     if (pitr -> count == active_proposals && pitr -> nonneutral) {
       if (reward_points > 0) {
@@ -1362,7 +1584,7 @@ void proposals::erasepartpts(uint64_t active_proposals) {
     pitr = participants.erase(pitr);
   }
 
-  if (counter == batch_size) {
+  if (counter >= batch_size) {
     transaction trx_erase_participants{};
     trx_erase_participants.actions.emplace_back(
       permission_level(_self, "active"_n),
@@ -1372,11 +1594,11 @@ void proposals::erasepartpts(uint64_t active_proposals) {
     );
     // I don't know how long delay I should use
     trx_erase_participants.delay_sec = 5;
-    trx_erase_participants.send(eosio::current_time_point().sec_since_epoch(), _self);
+    trx_erase_participants.send(utils::deferred_id(trx_erase_participants), _self);
   }
 }
 
-void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option, bool is_new, bool is_delegated) {
+void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option, bool is_new) {
   check_citizen(voter);
 
   // check(false, "contract is paused");
@@ -1398,21 +1620,27 @@ void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option,
   
   check(option == trust || option == distrust || option == abstain, "Invalid option");
 
+  name scope = get_scope(pitr -> fund);
+
+  check(!is_trust_delegated(voter, scope), "voice is delegated, user can not vote by itself");
+
+  double percenetage_used = voice_change(voter, amount, true, scope);
+
+  // delegators vote with the same share of their voice as their delegatee
+  uint64_t delegated = spend_pool(voter, scope, id, percenetage_used, option);
+  uint64_t total = amount + delegated;
+
   if (option == trust) {
     props.modify(pitr, _self, [&](auto& proposal) {
-      proposal.total += amount;
-      proposal.favour += amount;
+      proposal.total += total;
+      proposal.favour += total;
     });
   } else if (option == distrust) {
     props.modify(pitr, _self, [&](auto& proposal) {
-      proposal.total += amount;
-      proposal.against += amount;
+      proposal.total += total;
+      proposal.against += total;
     });
   }
-
-  name scope = get_scope(pitr -> fund);
-
-  double percenetage_used = voice_change(voter, amount, true, scope);
   
   votes.emplace(_self, [&](auto& vote) {
     vote.account = voter;
@@ -1423,48 +1651,54 @@ void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option,
       vote.favour = false;
     }
     vote.proposal_id = id;
+    vote.delegated.emplace(delegated);
   });
 
-  if (!is_delegated) {
-    check(!is_trust_delegated(voter, scope), "voice is delegated, user can not vote by itself");
+  if (is_new) {
+    add_participant(voter, option, 1.0);
   }
 
-  send_mimic_delegatee_vote(voter, scope, id, percenetage_used, option);
+  add_active(voter);
 
-  if (is_new) {
-    auto rep = config_get(name("voterep2.ind"));
-    double rep_multiplier = is_delegated ? config_get(name("votedel.mul")) / 100.0 : 1.0;
-    uint64_t rep_int_value = uint64_t(round( rep * rep_multiplier ));
-    auto paitr = participants.find(voter.value);
-    if (paitr == participants.end()) {
-      if (rep_int_value > 0) {
-        // add reputation for entering in the table
-        action(
-          permission_level{contracts::accounts, "active"_n},
-          contracts::accounts, "addrep"_n,
-          std::make_tuple(voter, rep_int_value)
-        ).send();
-      }
-      // add the voter to the table
-      participants.emplace(_self, [&](auto & participant){
-        participant.account = voter;
-        if (option == abstain) {
-          participant.nonneutral = false;
-        } else {
-          participant.nonneutral = true;
-        }
-        participant.count = 1;
-      });
-    } else {
-      participants.modify(paitr, _self, [&](auto & participant){
-        participant.count += 1;
-        if (option != abstain) {
-          participant.nonneutral = true;
-        }
-      });
+  add_voted_proposal(pitr->id); // this should happen in onperiod, when status is set to open / active
+  increase_voice_cast(total, option, get_type(pitr -> fund));
+
+}
+
+void proposals::add_participant(name voter, name option, double rep_multiplier, uint64_t count) {
+  auto rep = config_get(name("voterep2.ind"));
+  uint64_t rep_int_value = uint64_t(round( rep * rep_multiplier ));
+  auto paitr = participants.find(voter.value);
+  if (paitr == participants.end()) {
+    if (rep_int_value > 0) {
+      // add reputation for entering in the table
+      action(
+        permission_level{contracts::accounts, "active"_n},
+        contracts::accounts, "addrep"_n,
+        std::make_tuple(voter, rep_int_value)
+      ).send();
     }
+    // add the voter to the table
+    participants.emplace(_self, [&](auto & participant){
+      participant.account = voter;
+      if (option == abstain) {
+        participant.nonneutral = false;
+      } else {
+        participant.nonneutral = true;
+      }
+      participant.count = count;
+    });
+  } else {
+    participants.modify(paitr, _self, [&](auto & participant){
+      participant.count += count;
+      if (option != abstain) {
+        participant.nonneutral = true;
+      }
+    });
   }
+}
 
+void proposals::add_active(name voter) {
   auto aitr = actives.find(voter.value);
   if (aitr == actives.end()) {
     actives.emplace(_self, [&](auto& item) {
@@ -1477,10 +1711,6 @@ void proposals::vote_aux (name voter, uint64_t id, uint64_t amount, name option,
       item.timestamp = current_time_point().sec_since_epoch();
     });
   }
-
-  add_voted_proposal(pitr->id); // this should happen in onperiod, when status is set to open / active
-  increase_voice_cast(amount, option, get_type(pitr -> fund));
-
 }
 
 name proposals::get_scope(name fund) {
@@ -1498,17 +1728,17 @@ name proposals::get_scope(name fund) {
 
 void proposals::favour(name voter, uint64_t id, uint64_t amount) {
   require_auth(voter);
-  vote_aux(voter, id, amount, trust, true, false);
+  vote_aux(voter, id, amount, trust, true);
 }
 
 void proposals::against(name voter, uint64_t id, uint64_t amount) {
   require_auth(voter);
-  vote_aux(voter, id, amount, distrust, true, false);
+  vote_aux(voter, id, amount, distrust, true);
 }
 
 void proposals::neutral(name voter, uint64_t id) {
   require_auth(voter);
-  vote_aux(voter, id, (uint64_t)0, abstain, true, false);
+  vote_aux(voter, id, (uint64_t)0, abstain, true);
 }
 
 void proposals::revertvote(name voter, uint64_t id) {
@@ -1524,7 +1754,8 @@ void proposals::revertvote(name voter, uint64_t id) {
 
   check(voteitr != votes.end(), "Voter has not voted on this proposal, can't revert");
 
-  uint64_t amount = voteitr->amount;
+  // delegated voice follows the delegatee's vote
+  uint64_t amount = voteitr->amount + voteitr->delegated.value_or(0);
 
   check(voteitr->favour == true && amount > 0, "Only trust votes can be changed");
 
@@ -1537,62 +1768,6 @@ void proposals::revertvote(name voter, uint64_t id) {
     proposal.favour -= amount;
   });
 
-  name scope = get_scope(pitr -> fund);
-  if (has_delegates(voter, scope)) {
-
-    action(
-      permission_level{get_self(), "active"_n},
-      get_self(), 
-      "mimicrevert"_n,
-      std::make_tuple(voter, (uint64_t)0, scope, id, (uint64_t)30)
-    ).send();
-
-  }
-
-}
-
-bool proposals::has_delegates(name voter, name scope) {
-  delegate_trust_tables deltrusts(get_self(), scope.value);
-  auto deltrusts_by_delegatee = deltrusts.get_index<"bydelegatee"_n>();
-  auto ditr = deltrusts_by_delegatee.find(voter.value);
-  return ditr != deltrusts_by_delegatee.end();
-}
-
-void proposals::revertvote_delegate(name voter, uint64_t id) {
-
-  auto pitr = props.find(id);
-  
-  check(pitr != props.end(), "Proposal not found");
-  check(pitr->status == status_evaluate, "Proposal is not in evaluate state");
-
-  votes_tables votes(get_self(), id);
-  auto voteitr = votes.find(voter.value);
-
-  if (voteitr != votes.end()) {
-    uint64_t amount = voteitr->amount;
-
-    if (voteitr->favour == true && amount > 0) {
-      votes.modify(voteitr, _self, [&](auto& item) {
-        item.favour = false;
-       });
-
-      props.modify(pitr, _self, [&](auto& proposal) {
-        proposal.against += amount;
-        proposal.favour -= amount;
-      });
-    }
-  }
-}
-
-
-void proposals::voteonbehalf(name voter, uint64_t id, uint64_t amount, name option) {
-  require_auth(get_self());
-  bool is_new = true;
-  // if (option == distrust) {
-  //   is_new = !(revert_vote(voter, id));
-  // TODO not sure I think revert vote needs to somehow work for delegated votes too
-  // }
-  vote_aux(voter, id, amount, option, is_new, true);
 }
 
 void proposals::addvoice(name user, uint64_t amount) {
@@ -1618,25 +1793,17 @@ double proposals::voice_change (name user, uint64_t amount, bool reduce, name sc
 
       if (vitr == voice_t.end()) {
         check(!reduce, "user can not have negative voice balance");
-        voice_t.emplace(_self, [&](auto & voice){
-          voice.account = user;
-          voice.balance = amount;
-        });
+        store_voice(user, s, amount);
       }
       else {
+        uint64_t current = get_voice(*vitr, s);
         if (reduce) {
-          check(amount <= vitr->balance, s.to_string() + " voice balance exceeded");
+          check(amount <= current, s.to_string() + " voice balance exceeded");
         }
 
         increase_size = false;
 
-        voice_t.modify(vitr, _self, [&](auto & voice){
-          if (reduce) {
-            voice.balance -= amount;
-          } else {
-            voice.balance += amount;
-          }
-        });
+        store_voice(user, s, reduce ? current - amount : current + amount);
       }
     }
 
@@ -1644,22 +1811,18 @@ double proposals::voice_change (name user, uint64_t amount, bool reduce, name sc
       size_change("voice.sz"_n, 1);
     }
 
-  } else {    
+  } else {
     voice_tables voice_t(get_self(), scope.value);
     auto vitr = voice_t.find(user.value);
     check(vitr != voice_t.end(), "user does not have voice");
 
+    uint64_t current = get_voice(*vitr, scope);
+
     if (reduce) {
-      check(amount <= vitr->balance, "voice balance exceeded");
-      percentage_used = amount / double(vitr -> balance);
+      check(amount <= current, "voice balance exceeded");
+      percentage_used = amount / double(current);
     }
-    voice_t.modify(vitr, _self, [&](auto & voice){
-      if (reduce) {
-        voice.balance -= amount;
-      } else {
-        voice.balance += amount;
-      }
-    });
+    store_voice(user, scope, reduce ? current - amount : current + amount);
   }
   return percentage_used;
 }
@@ -1671,34 +1834,22 @@ void proposals::set_voice (name user, uint64_t amount, name scope) {
 
     for (auto & s : scopes) {
       voice_tables voice_t(get_self(), s.value);
-      auto vitr = voice_t.find(user.value);
-
-      if (vitr == voice_t.end()) {
-        voice_t.emplace(_self, [&](auto & voice){
-          voice.account = user;
-          voice.balance = amount;
-        });
-      }
-      else {
+      if (voice_t.find(user.value) != voice_t.end()) {
         increase_size = false;
-        voice_t.modify(vitr, _self, [&](auto & voice){
-          voice.balance = amount;
-        });
       }
+      store_voice(user, s, amount);
     }
 
     if (increase_size) {
       size_change("voice.sz"_n, 1);
     }
 
-  } else {    
+  } else {
     voice_tables voices(get_self(), scope.value);
     auto vitr = voices.find(user.value);
     check(vitr != voices.end(), "user does not have a voice entry");
 
-    voices.modify(vitr, _self, [&](auto & voice){
-      voice.balance = amount;
-    });
+    store_voice(user, scope, amount);
   }
 }
 
@@ -1708,6 +1859,21 @@ void proposals::erase_voice (name user) {
   for (auto & s : scopes) {
     voice_tables voice_t(get_self(), s.value);
     auto vitr = voice_t.find(user.value);
+
+    // the delegation is kept, only the voice leaves the delegatee's pool
+    delegate_trust_tables deltrusts(get_self(), s.value);
+    auto ditr = deltrusts.find(user.value);
+    if (vitr != voice_t.end() && ditr != deltrusts.end() && ditr -> pool_factor.has_value()) {
+      delegation_pool_tables pools(get_self(), s.value);
+      auto pitr = pools.find(ditr -> delegatee.value);
+      if (pitr != pools.end()) {
+        refresh_pool(pools, ditr -> delegatee);
+        if (ditr -> pool_epoch.value_or(0) == pitr -> epoch) {
+          add_pool_units(pools, ditr -> delegatee, -pool_units(vitr -> balance, vitr -> decay_factor.value_or(1.0), ditr -> pool_factor.value()));
+        }
+      }
+    }
+
     voice_t.erase(vitr);
   }
   
@@ -1868,12 +2034,13 @@ void proposals::recover_voice(name account) {
   DEFINE_CS_POINTS_TABLE_MULTI_INDEX
   
   cs_points_tables cspoints(contracts::harvest, contracts::harvest.value);
+  utils::rank_resolver cs_rank(contracts::harvest, rankings::cs);
 
   auto csitr = cspoints.find(account.value);
   uint64_t voice_amount = 0;
 
   if (csitr != cspoints.end()) {
-    voice_amount = calculate_decay(csitr -> rank);
+    voice_amount = calculate_decay(cs_rank.rank(csitr->by_cs_points(), csitr->rank));
   }
 
   set_voice(account, voice_amount, ""_n);
@@ -1990,6 +2157,7 @@ bool proposals::is_trust_delegated (name account, name scope) {
 ACTION proposals::delegate (name delegator, name delegatee, name scope) {
 
   require_auth(delegator);
+  check_voice_scope(scope);
 
   voice_tables voice(get_self(), scope.value);
   auto vitr = voice.find(delegator.value);
@@ -2017,166 +2185,530 @@ ACTION proposals::delegate (name delegator, name delegatee, name scope) {
 
   check(has_no_cycles, "can not add delegatee, cycles are not allowed");
 
+  if (ditr != deltrusts.end()) {
+    leave_pool(delegator, scope);
+  }
+
+  join_pool(delegator, delegatee, scope);
+
+}
+
+ACTION proposals::undelegate (name delegator, name scope) {
+  check_voice_scope(scope);
+
+  delegate_trust_tables deltrusts(get_self(), scope.value);
+  auto ditr = deltrusts.find(delegator.value);
+
+  check(ditr != deltrusts.end(), "delegator not found");
+
+  if (!has_auth(ditr -> delegatee)) {
+    require_auth(delegator);
+  } else {
+    require_auth(ditr -> delegatee);
+  }
+
+  leave_pool(delegator, scope);
+}
+
+ACTION proposals::pooldelegs (name scope, uint64_t start, uint64_t chunksize) {
+  require_auth(get_self());
+  check_voice_scope(scope);
+
+  voice_tables voice_t(get_self(), scope.value);
+  delegate_trust_tables deltrusts(get_self(), scope.value);
+  auto ditr = deltrusts.lower_bound(start);
+  uint64_t count = 0;
+
+  while (ditr != deltrusts.end() && count < chunksize) {
+    name delegator = ditr -> delegator;
+    name delegatee = ditr -> delegatee;
+    bool pooled = ditr -> pool_factor.has_value();
+    ditr++;
+
+    if (!pooled && voice_t.find(delegator.value) != voice_t.end()) {
+      join_pool(delegator, delegatee, scope);
+    }
+    count++;
+  }
+
+  if (ditr != deltrusts.end()) {
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "pooldelegs"_n,
+      std::make_tuple(scope, ditr -> delegator.value, chunksize)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(utils::deferred_id(tx), _self);
+  }
+}
+
+void proposals::join_pool (name delegator, name delegatee, name scope) {
+  voice_tables voice_t(get_self(), scope.value);
+  auto vitr = voice_t.require_find(delegator.value, "delegator does not have voice");
+
+  double factor = voice_decay_factor(scope);
+  uint64_t current = voice_balance(*vitr, factor);
+  uint64_t now = eosio::current_time_point().sec_since_epoch();
+
+  delegate_trust_tables deltrusts(get_self(), scope.value);
+  delegation_pool_tables pools(get_self(), scope.value);
+
+  if (pools.find(delegatee.value) == pools.end()) {
+    pools.emplace(_self, [&](auto & pool){
+      pool.delegatee = delegatee;
+      pool.parent = name();
+      pool.units = 0.0;
+      pool.factor = 1.0;
+      pool.epoch = 0;
+      pool.delegators = 0;
+      pool.parent_factor = 1.0;
+      pool.parent_epoch = 0;
+      pool.linked = now;
+      pool.votes = 0;
+      pool.nonneutral = false;
+      pool.credit_from = name();
+    });
+
+    // a delegatee that delegates itself is spent by the votes of its own delegatee
+    auto parent_itr = deltrusts.find(delegatee.value);
+    if (parent_itr != deltrusts.end() && parent_itr -> pool_factor.has_value()) {
+      link_pool(pools, delegatee, parent_itr -> delegatee);
+    }
+  }
+
+  pool_link link = refresh_pool(pools, delegatee);
+  auto pitr = pools.find(delegatee.value);
+
+  add_pool_units(pools, delegatee, pool_units(current, factor, link.live_factor));
+  pools.modify(pitr, _self, [&](auto & pool){
+    pool.delegators += 1;
+  });
+
+  voice_t.modify(vitr, _self, [&](auto & voice){
+    write_voice(voice, current, factor);
+  });
+
+  auto ditr = deltrusts.find(delegator.value);
   if (ditr != deltrusts.end()) {
     deltrusts.modify(ditr, _self, [&](auto & item){
       item.delegatee = delegatee;
-      item.weight = 1.0;
-      item.timestamp = eosio::current_time_point().sec_since_epoch();
+      write_pool_share(item, link.live_factor, pitr -> epoch, 0.0, pitr -> epoch);
     });
   } else {
     deltrusts.emplace(_self, [&](auto & item){
       item.delegator = delegator;
       item.delegatee = delegatee;
       item.weight = 1.0;
-      item.timestamp = eosio::current_time_point().sec_since_epoch();
+      item.timestamp = now;
+      write_pool_share(item, link.live_factor, pitr -> epoch, 0.0, pitr -> epoch);
     });
   }
 
+  // the delegator's own pool is counted and spent in the delegatee's from now on
+  link_pool(pools, delegator, delegatee);
 }
 
-void proposals::send_vote_on_behalf (name voter, uint64_t id, uint64_t amount, name option) {
-  action vote_on_behalf_action(
-    permission_level{get_self(), "active"_n},
-    get_self(),
-    "voteonbehalf"_n,
-    std::make_tuple(voter, id, amount, option)
-  );
-  transaction tx;
-  tx.actions.emplace_back(vote_on_behalf_action);
-  // tx.delay_sec = 1;
-  tx.send(voter.value, _self);
+void proposals::leave_pool (name delegator, name scope) {
+  delegate_trust_tables deltrusts(get_self(), scope.value);
+  auto ditr = deltrusts.require_find(delegator.value, "delegator not found");
+
+  voice_tables voice_t(get_self(), scope.value);
+  auto vitr = voice_t.find(delegator.value);
+
+  double factor = voice_decay_factor(scope);
+  delegation_pool_tables pools(get_self(), scope.value);
+  auto pitr = pools.find(ditr -> delegatee.value);
+
+  if (ditr -> pool_factor.has_value() && pitr != pools.end()) {
+    pool_link link = refresh_pool(pools, ditr -> delegatee);
+
+    settle_pool_spends(pools, *ditr, link, scope);
+
+    if (vitr != voice_t.end() && ditr -> pool_epoch.value_or(0) == pitr -> epoch) {
+      add_pool_units(pools, ditr -> delegatee, -pool_units(vitr -> balance, vitr -> decay_factor.value_or(1.0), ditr -> pool_factor.value()));
+    }
+  }
+
+  uint64_t current = vitr != voice_t.end() ? get_voice(*vitr, scope) : 0;
+
+  unlink_pool(pools, delegator);
+
+  if (ditr -> pool_factor.has_value() && pitr != pools.end()) {
+    if (pitr -> delegators <= 1) {
+      // what is left are rounding residues, they leave the pools above with it
+      add_pool_units(pools, pitr -> delegatee, -pitr -> units);
+      clear_pool_spends(pitr -> delegatee, scope);
+      pools.erase(pitr);
+    } else {
+      pools.modify(pitr, _self, [&](auto & pool){
+        pool.delegators -= 1;
+      });
+    }
+  }
+
+  deltrusts.erase(ditr);
+
+  if (vitr != voice_t.end()) {
+    voice_t.modify(vitr, _self, [&](auto & voice){
+      write_voice(voice, current, factor);
+    });
+  }
 }
 
-void proposals::send_mimic_delegatee_vote (name delegatee, name scope, uint64_t proposal_id, double percentage_used, name option) {
+// the share of a pool's written voice the votes of the pools above it have not spent, 0 if one of them was fully spent
+double proposals::pool_live_factor (const delegation_pool_table & pool, name scope) {
+  delegation_pool_tables pools(get_self(), scope.value);
 
-  uint64_t batch_size = config_get("batchsize"_n);
+  double live = pool.factor;
+  name parent = pool.parent;
+  uint64_t parent_epoch = pool.parent_epoch;
+  double parent_factor = pool.parent_factor;
 
-  delegate_trust_tables deltrusts(get_self(), scope.value);
-  auto deltrusts_by_delegatee_delegator = deltrusts.get_index<"byddelegator"_n>();
+  while (parent != name()) {
+    auto pitr = pools.find(parent.value);
+    if (pitr == pools.end()) {
+      break;
+    }
+    if (pitr -> epoch != parent_epoch) {
+      return 0.0;
+    }
+    live *= pitr -> factor / parent_factor;
+    parent = pitr -> parent;
+    parent_epoch = pitr -> parent_epoch;
+    parent_factor = pitr -> parent_factor;
+  }
 
-  uint128_t id = uint128_t(delegatee.value) << 64;
-  auto ditr = deltrusts_by_delegatee_delegator.lower_bound(id);
+  return live;
+}
 
-  if (ditr != deltrusts_by_delegatee_delegator.end() && ditr -> delegatee == delegatee) {
-    action mimic_action(
-      permission_level{get_self(), "active"_n},
-      get_self(),
-      "mimicvote"_n,
-      std::make_tuple(delegatee, ditr -> delegator, scope, proposal_id, percentage_used, option, batch_size)
-    );
+// walks up to the pool that votes for this one, pools linked below a fully spent pool move to a new epoch on the way down
+proposals::pool_link proposals::refresh_pool (delegation_pool_tables & pools, name delegatee) {
+  std::vector<name> chain;
+  name current = delegatee;
+  while (current != name()) {
+    auto pitr = pools.find(current.value);
+    if (pitr == pools.end()) {
+      break;
+    }
+    chain.push_back(current);
+    current = pitr -> parent;
+  }
+  check(!chain.empty(), "delegation pool not found");
+
+  auto ritr = pools.find(chain.back().value);
+
+  pool_link link;
+  link.root = chain.back();
+  link.live_factor = ritr -> factor;
+  link.root_ratio = 1.0;
+  link.linked = 0;
+
+  for (int64_t i = int64_t(chain.size()) - 2; i >= 0; i--) {
+    auto parent_itr = pools.find(chain[i + 1].value);
+    auto pitr = pools.find(chain[i].value);
+
+    if (pitr -> parent_epoch != parent_itr -> epoch) {
+      pools.modify(pitr, _self, [&](auto & pool){
+        pool.units = 0.0;
+        pool.factor = 1.0;
+        pool.epoch += 1;
+        pool.parent_factor = link.live_factor;
+        pool.parent_epoch = parent_itr -> epoch;
+        pool.linked = eosio::current_time_point().sec_since_epoch();
+      });
+    }
 
-    transaction tx;
-    tx.actions.emplace_back(mimic_action);
-    tx.delay_sec = 1;
-    tx.send(delegatee.value + 1, _self);
+    link.root_ratio *= pitr -> factor / pitr -> parent_factor;
+    link.live_factor *= pitr -> factor / pitr -> parent_factor;
+    link.linked = std::max(link.linked, pitr -> linked);
   }
 
+  return link;
 }
 
-ACTION proposals::mimicvote (name delegatee, name delegator, name scope, uint64_t proposal_id, double percentage_used, name option, uint64_t chunksize) {
+// adds units to a pool and, converted, to every pool it is linked into
+void proposals::add_pool_units (delegation_pool_tables & pools, name delegatee, double units) {
+  auto pitr = pools.find(delegatee.value);
 
-  require_auth(get_self());
+  while (pitr != pools.end()) {
+    pools.modify(pitr, _self, [&](auto & pool){
+      pool.units = std::max(0.0, pool.units + units);
+    });
 
-  delegate_trust_tables deltrusts(get_self(), scope.value);
-  auto deltrusts_by_delegatee_delegator = deltrusts.get_index<"byddelegator"_n>();
+    if (pitr -> parent == name()) {
+      break;
+    }
+    auto parent_itr = pools.find(pitr -> parent.value);
+    if (parent_itr == pools.end() || parent_itr -> epoch != pitr -> parent_epoch) {
+      break;
+    }
+    units *= pitr -> factor / pitr -> parent_factor;
+    pitr = parent_itr;
+  }
+}
 
-  check_voice_scope(scope);
-  voice_tables voices(get_self(), scope.value);
+// counts a delegator's own pool in its delegatee's, its factor is kept and follows the delegatee's live factor
+void proposals::link_pool (delegation_pool_tables & pools, name delegatee, name parent) {
+  auto pitr = pools.find(delegatee.value);
+  if (pitr == pools.end() || pools.find(parent.value) == pools.end()) {
+    return;
+  }
 
-  uint128_t id = (uint128_t(delegatee.value) << 64) + delegator.value;
+  pool_link link = refresh_pool(pools, parent);
+  auto parent_itr = pools.find(parent.value);
 
-  auto ditr = deltrusts_by_delegatee_delegator.find(id);
-  uint64_t count = 0;
+  pools.modify(pitr, _self, [&](auto & pool){
+    pool.parent = parent;
+    pool.parent_factor = link.live_factor;
+    pool.parent_epoch = parent_itr -> epoch;
+    pool.linked = eosio::current_time_point().sec_since_epoch();
+  });
+
+  add_pool_units(pools, parent, pitr -> units * pitr -> factor / link.live_factor);
+}
 
-  while (ditr != deltrusts_by_delegatee_delegator.end() && ditr -> delegatee == delegatee && count < chunksize) {
+// the pool votes by itself again, it keeps what the pools above it spent
+void proposals::unlink_pool (delegation_pool_tables & pools, name delegatee) {
+  auto pitr = pools.find(delegatee.value);
+  if (pitr == pools.end() || pitr -> parent == name()) {
+    return;
+  }
 
-    name voter = ditr -> delegator;
+  pool_link link = refresh_pool(pools, delegatee);
 
-    auto vitr = voices.find(voter.value);
-    if (vitr != voices.end()) {
-      if (option == trust) {
-        send_vote_on_behalf(voter, proposal_id, vitr -> balance * percentage_used, trust);
-      } else if (option == distrust) {
-        send_vote_on_behalf(voter, proposal_id, vitr -> balance * percentage_used, distrust);
-      } else if (option == abstain) {
-        send_vote_on_behalf(voter, proposal_id, uint64_t(0), abstain);
-      }
+  if (pools.find(pitr -> parent.value) != pools.end()) {
+    add_pool_units(pools, pitr -> parent, -pitr -> units * pitr -> factor / pitr -> parent_factor);
+  }
+
+  pools.modify(pitr, _self, [&](auto & pool){
+    pool.factor = link.live_factor;
+    if (pool.factor < 1e-12) {
+      pool.factor = 1.0;
+      pool.units = 0.0;
+      pool.epoch += 1;
     }
+    pool.parent = name();
+    pool.parent_factor = 1.0;
+    pool.parent_epoch = 0;
+    pool.linked = eosio::current_time_point().sec_since_epoch();
+  });
+}
 
-    ditr++;
-    count++;
+void proposals::write_pool_share (delegate_trust_table & item, double live_factor, uint64_t epoch, double prior_units, uint64_t prior_epoch) {
+  item.pool_factor.emplace(live_factor);
+  item.pool_epoch.emplace(epoch);
+  item.written.emplace(eosio::current_time_point().sec_since_epoch());
+  item.prior_units.emplace(prior_units);
+  item.prior_epoch.emplace(prior_epoch);
+}
+
+// spends percentage of the voter's pool, the pools linked into it included, returns the voice spent
+// the vote is counted on the pool, erasepartpts hands it down to the delegators as participation
+uint64_t proposals::spend_pool (name delegatee, name scope, uint64_t proposal_id, double percentage, name option) {
+  delegation_pool_tables pools(get_self(), scope.value);
+  auto pitr = pools.find(delegatee.value);
+  if (pitr == pools.end()) {
+    return 0;
   }
 
-  if (ditr != deltrusts_by_delegatee_delegator.end() && ditr -> delegatee == delegatee) {
-    action next_execution(
-      permission_level{get_self(), "active"_n},
-      get_self(),
-      "mimicvote"_n,
-      std::make_tuple(delegatee, ditr -> delegator, scope, proposal_id, percentage_used, option, chunksize)
-    );
+  pools.modify(pitr, _self, [&](auto & pool){
+    pool.votes += 1;
+    if (option != abstain) {
+      pool.nonneutral = true;
+    }
+  });
 
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(delegatee.value + 1, _self);
+  if (option == abstain || !(percentage > 0)) {
+    return 0;
+  }
+  percentage = std::min(percentage, 1.0);
+
+  double spent_per_unit = pitr -> factor * voice_decay_factor(scope) * percentage;
+  uint64_t spent = pitr -> units * spent_per_unit;
+
+  pool_spend_tables spends(get_self(), delegatee.value);
+  auto sitr = spends.find(proposal_id);
+  if (sitr == spends.end()) {
+    spends.emplace(_self, [&](auto & item){
+      item.proposal_id = proposal_id;
+      item.epoch = pitr -> epoch;
+      item.spent_per_unit = spent_per_unit;
+      item.spent = spent;
+      item.timestamp = eosio::current_time_point().sec_since_epoch();
+    });
+  } else {
+    spends.modify(sitr, _self, [&](auto & item){
+      item.epoch = pitr -> epoch;
+      item.spent_per_unit = spent_per_unit;
+      item.spent = spent;
+      item.timestamp = eosio::current_time_point().sec_since_epoch();
+    });
   }
 
+  pools.modify(pitr, _self, [&](auto & pool){
+    pool.factor *= 1.0 - percentage;
+    if (pool.factor < 1e-12) {
+      // fully spent, delegators and linked pools of older epochs have no voice left
+      pool.factor = 1.0;
+      pool.units = 0.0;
+      pool.epoch += 1;
+    }
+  });
+
+  return spent;
 }
 
-ACTION proposals::mimicrevert(name delegatee, uint64_t delegator, name scope, uint64_t proposal_id, uint64_t chunksize) {
+// moves what a leaving delegator and the pool linked below it spent through the votes of the root pool on active
+// proposals into a vote of its own, so reverting the root's vote leaves it out
+void proposals::settle_pool_spends (delegation_pool_tables & pools, const delegate_trust_table & d, const pool_link & link, name scope) {
+  voice_tables voice_t(get_self(), scope.value);
+  auto vitr = voice_t.find(d.delegator.value);
 
-  require_auth(get_self());
+  auto pitr = pools.find(d.delegatee.value);
+  auto owned_itr = pools.find(d.delegator.value);
+  bool direct = link.root == d.delegatee;
 
-  delegate_trust_tables deltrusts(get_self(), scope.value);
-  auto deltrusts_by_delegatee_delegator = deltrusts.get_index<"byddelegator"_n>();
+  double units = vitr != voice_t.end() ? pool_units(vitr -> balance, vitr -> decay_factor.value_or(1.0), d.pool_factor.value()) : 0.0;
+  uint64_t written = d.written.value_or(d.timestamp);
 
-  uint128_t id = (uint128_t(delegatee.value) << 64) + delegator;
+  pool_spend_tables spends(get_self(), link.root.value);
+  auto sitr = spends.begin();
 
-  auto ditr = delegator == 0 ? deltrusts_by_delegatee_delegator.lower_bound(id) : deltrusts_by_delegatee_delegator.find(id);
-  
-  uint64_t count = 0;
+  while (sitr != spends.end()) {
+    auto spitr = props.find(sitr -> proposal_id);
+    if (spitr == props.end() || spitr -> stage != stage_active) {
+      sitr = spends.erase(sitr);
+      continue;
+    }
+    if (get_scope(spitr -> fund) != scope || sitr -> timestamp < d.timestamp || sitr -> timestamp < link.linked) {
+      sitr++;
+      continue;
+    }
 
-  while (ditr != deltrusts_by_delegatee_delegator.end() && ditr -> delegatee == delegatee && count < chunksize) {
+    // a pool linked below the root moved to a new epoch when the root was fully spent, after the vote
+    uint64_t spent_epoch = direct ? sitr -> epoch : pitr -> epoch;
 
-    name voter = ditr -> delegator;
+    bool before_write = sitr -> timestamp < written;
+    double vote_units = before_write ? d.prior_units.value_or(0.0) : units;
+    uint64_t vote_epoch = before_write ? d.prior_epoch.value_or(0) : d.pool_epoch.value_or(0);
+    uint64_t own = vote_epoch == spent_epoch ? uint64_t(vote_units * link.root_ratio * sitr -> spent_per_unit) : 0;
 
-    revertvote_delegate(voter, proposal_id);
+    uint64_t below = 0;
+    if (owned_itr != pools.end() && owned_itr -> parent == d.delegatee && owned_itr -> parent_epoch == spent_epoch && sitr -> timestamp >= owned_itr -> linked) {
+      below = uint64_t(owned_itr -> units * owned_itr -> factor / owned_itr -> parent_factor * link.root_ratio * sitr -> spent_per_unit);
+    }
 
-    ditr++;
-    count++;
-  }
+    votes_tables votes(get_self(), sitr -> proposal_id);
+    auto hitr = votes.find(link.root.value);
 
-  if (ditr != deltrusts_by_delegatee_delegator.end() && ditr -> delegatee == delegatee) {
-    action next_execution(
-      permission_level{get_self(), "active"_n},
-      get_self(),
-      "mimicrevert"_n,
-      std::make_tuple(delegatee, ditr -> delegator.value, scope, proposal_id, chunksize)
-    );
+    if (own + below > 0 && hitr != votes.end()) {
+      uint64_t available = std::min(hitr -> delegated.value_or(0), sitr -> spent);
+      own = std::min(own, available);
+      below = std::min(below, available - own);
 
-    transaction tx;
-    tx.actions.emplace_back(next_execution);
-    tx.delay_sec = 1;
-    tx.send(delegatee.value + 1, _self);
+      votes.modify(hitr, _self, [&](auto & vote){
+        vote.delegated.emplace(vote.delegated.value_or(0) - own - below);
+      });
+
+      auto vtitr = votes.find(d.delegator.value);
+      if (vtitr == votes.end()) {
+        votes.emplace(_self, [&](auto & vote){
+          vote.account = d.delegator;
+          vote.amount = own;
+          vote.favour = hitr -> favour;
+          vote.proposal_id = sitr -> proposal_id;
+          vote.delegated.emplace(below);
+        });
+      } else {
+        votes.modify(vtitr, _self, [&](auto & vote){
+          vote.amount += own;
+          vote.delegated.emplace(vote.delegated.value_or(0) + below);
+        });
+      }
+
+      spends.modify(sitr, _self, [&](auto & item){
+        item.spent -= own + below;
+      });
+    }
+
+    sitr++;
   }
+}
 
+void proposals::clear_pool_spends (name delegatee, name scope) {
+  pool_spend_tables spends(get_self(), delegatee.value);
+  auto sitr = spends.begin();
+  while (sitr != spends.end()) {
+    auto pitr = props.find(sitr -> proposal_id);
+    if (pitr == props.end() || get_scope(pitr -> fund) == scope) {
+      sitr = spends.erase(sitr);
+    } else {
+      sitr++;
+    }
+  }
 }
 
-ACTION proposals::undelegate (name delegator, name scope) {
-  check_voice_scope(scope);
+// hands the votes pools cast this cycle down to their delegators as participation, and on to the pools linked
+// below them, returns the number of delegators credited
+uint64_t proposals::credit_pools (uint64_t batch_size) {
+  double rep_multiplier = config_get(name("votedel.mul")) / 100.0;
+  uint64_t count = 0;
 
-  delegate_trust_tables deltrusts(get_self(), scope.value);
-  auto ditr = deltrusts.find(delegator.value);
+  for (auto & s : scopes) {
+    voice_tables voices(get_self(), s.value);
+    delegate_trust_tables deltrusts(get_self(), s.value);
+    auto deltrusts_by_delegatee_delegator = deltrusts.get_index<"byddelegator"_n>();
+    delegation_pool_tables pools(get_self(), s.value);
+    auto pools_by_votes = pools.get_index<"byvotes"_n>();
+
+    auto pvitr = pools_by_votes.lower_bound(1);
+    while (pvitr != pools_by_votes.end() && count < batch_size) {
+      auto pitr = pools.find(pvitr -> delegatee.value);
+      name delegatee = pitr -> delegatee;
+      name option = pitr -> nonneutral ? trust : abstain;
+
+      auto ditr = deltrusts_by_delegatee_delegator.lower_bound((uint128_t(delegatee.value) << 64) + pitr -> credit_from.value);
+      while (ditr != deltrusts_by_delegatee_delegator.end() && ditr -> delegatee == delegatee && count < batch_size) {
+        name voter = ditr -> delegator;
+
+        if (voices.find(voter.value) != voices.end()) {
+          add_participant(voter, option, rep_multiplier, pitr -> votes);
+          add_active(voter);
+        }
 
-  check(ditr != deltrusts.end(), "delegator not found");
+        auto owned_itr = pools.find(voter.value);
+        if (owned_itr != pools.end()) {
+          pools.modify(owned_itr, _self, [&](auto & pool){
+            pool.votes += pitr -> votes;
+            pool.nonneutral = pool.nonneutral || pitr -> nonneutral;
+          });
+        }
 
-  if (!has_auth(ditr -> delegatee)) {
-    require_auth(delegator);
-  } else {
-    require_auth(ditr -> delegatee);
+        ditr++;
+        count++;
+      }
+
+      if (ditr != deltrusts_by_delegatee_delegator.end() && ditr -> delegatee == delegatee) {
+        pools.modify(pitr, _self, [&](auto & pool){
+          pool.credit_from = ditr -> delegator;
+        });
+      } else {
+        pools.modify(pitr, _self, [&](auto & pool){
+          pool.votes = 0;
+          pool.nonneutral = false;
+          pool.credit_from = name();
+        });
+      }
+
+      pvitr = pools_by_votes.lower_bound(1);
+    }
   }
 
-  deltrusts.erase(ditr);
+  return count;
 }
 
 void proposals::increase_voice_cast (uint64_t amount, name option, name prop_type) {
@@ -2465,7 +2997,7 @@ ACTION proposals::migalliances (uint64_t start, uint64_t chunksize) {
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(pitr->id, _self);
+    tx.send(utils::deferred_id(tx), _self);
 
   }
 
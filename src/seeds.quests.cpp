@@ -63,15 +63,20 @@ ACTION quests::reset () {
   hypha::Document account_infos_v_doc(get_self(), get_self(), std::move(account_infos_v_cgs));
   hypha::Document proposals_doc(get_self(), get_self(), std::move(proposals_cgs));
 
-  hypha::Edge::write(get_self(), get_self(), root_doc.getHash(), account_infos_doc.getHash(), graph::OWNS_ACCOUNT_INFOS);
-  hypha::Edge::write(get_self(), get_self(), account_infos_doc.getHash(), root_doc.getHash(), graph::OWNED_BY);
-  hypha::Edge::write(get_self(), get_self(), account_infos_doc.getHash(), account_infos_v_doc.getHash(), graph::VARIABLE);
+  write_edge(get_self(), root_doc.getHash(), account_infos_doc.getHash(), graph::OWNS_ACCOUNT_INFOS);
+  write_edge(get_self(), account_infos_doc.getHash(), root_doc.getHash(), graph::OWNED_BY);
+  write_edge(get_self(), account_infos_doc.getHash(), account_infos_v_doc.getHash(), graph::VARIABLE);
 
-  hypha::Edge::write(get_self(), get_self(), root_doc.getHash(), proposals_doc.getHash(), graph::OWNS_PROPOSALS);
-  hypha::Edge::write(get_self(), get_self(), proposals_doc.getHash(), root_doc.getHash(), graph::OWNED_BY);
+  write_edge(get_self(), root_doc.getHash(), proposals_doc.getHash(), graph::OWNS_PROPOSALS);
+  write_edge(get_self(), proposals_doc.getHash(), root_doc.getHash(), graph::OWNED_BY);
 
   get_account_info(bankaccts::campaigns, true);
 
+
+  cache_stats_tables cachestats(_self, _self.value);
+  cachestats.remove();
+  cache_hits = 0;
+  cache_misses = 0;
 }
 
 ACTION quests::stake (name from, name to, asset quantity, string memo) {
@@ -172,15 +177,15 @@ ACTION quests::addquest (name creator, asset amount, string title, string descri
   hypha::Document root_doc = get_root_node();
   hypha::Document account_info_doc = get_account_info(creator, true);
 
-  hypha::Edge::write(get_self(), creator, quest_doc.getHash(), quest_v_doc.getHash(), graph::VARIABLE);
-  hypha::Edge::write(get_self(), creator, root_doc.getHash(), quest_doc.getHash(), graph::HAS_QUEST);
-  hypha::Edge::write(get_self(), creator, account_info_doc.getHash(), quest_doc.getHash(), graph::CREATE);
+  write_edge(creator, quest_doc.getHash(), quest_v_doc.getHash(), graph::VARIABLE);
+  write_edge(creator, root_doc.getHash(), quest_doc.getHash(), graph::HAS_QUEST);
+  write_edge(creator, account_info_doc.getHash(), quest_doc.getHash(), graph::CREATE);
 
 }
 
 ACTION quests::addmilestone (checksum256 quest_hash, string title, string description, uint64_t payout_percentage) {
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   name creator = quest_doc.getCreator();
 
   check_type(quest_doc, graph::QUEST);
@@ -238,22 +243,22 @@ ACTION quests::addmilestone (checksum256 quest_hash, string title, string descri
 
   hypha::Document milestone_v_doc(get_self(), creator, std::move(milestone_v_cgs));
 
-  hypha::Edge::write(get_self(), creator, milestone_doc.getHash(), milestone_v_doc.getHash(), graph::VARIABLE);
-  hypha::Edge::write(get_self(), creator, quest_hash, milestone_doc.getHash(), graph::HAS_MILESTONE);
-  hypha::Edge::write(get_self(), creator, milestone_doc.getHash(), quest_hash, graph::MILESTONE_OF);
+  write_edge(creator, milestone_doc.getHash(), milestone_v_doc.getHash(), graph::VARIABLE);
+  write_edge(creator, quest_hash, milestone_doc.getHash(), graph::HAS_MILESTONE);
+  write_edge(creator, milestone_doc.getHash(), quest_hash, graph::MILESTONE_OF);
 
 }
 
 ACTION quests::delmilestone (checksum256 milestone_hash) {
 
-  hypha::Document milestone_doc(get_self(), milestone_hash);
+  hypha::Document milestone_doc = get_doc(milestone_hash);
   hypha::Document milestone_v_doc = get_variable_node_or_fail(milestone_doc);
   hypha::ContentWrapper milestone_cw = milestone_doc.getContentWrapper();
 
   check_type(milestone_doc, graph::MILESTONE);
 
   checksum256 quest_hash = milestone_cw.getOrFail(IDENTIFIER_DETAILS, QUEST_HASH) -> getAs<checksum256>();
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   name creator = quest_doc.getCreator();
 
   require_auth(creator);
@@ -267,15 +272,15 @@ ACTION quests::delmilestone (checksum256 milestone_hash) {
     hypha::Content(UNFINISHED_MILESTONES, unfinished_milestones - 1)
   });
 
-  m_documentGraph.eraseDocument(milestone_v_doc.getHash(), true);
-  m_documentGraph.eraseDocument(milestone_hash, true);
+  erase_doc(milestone_v_doc.getHash());
+  erase_doc(milestone_hash);
 
 }
 
 // used by the quest creator
 ACTION quests::activate (checksum256 quest_hash) {
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   hypha::Document quest_v_doc = get_variable_node_or_fail(quest_doc);
 
   name creator = quest_doc.getCreator();
@@ -294,7 +299,7 @@ ACTION quests::activate (checksum256 quest_hash) {
 
   if (fund != creator) {
     hypha::Document account_creator_doc = get_account_info(creator, true);
-    hypha::Edge::write(get_self(), get_self(), quest_hash, account_creator_doc.getHash(), graph::VALIDATE);
+    write_edge(get_self(), quest_hash, account_creator_doc.getHash(), graph::VALIDATE);
 
     update_node(&quest_v_doc, VARIABLE_DETAILS, {
       hypha::Content(STAGE, quest_stage_proposed)
@@ -331,7 +336,7 @@ ACTION quests::propactivate (checksum256 quest_hash) {
 
   require_auth(get_self());
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   hypha::Document quest_v_doc = get_variable_node_or_fail(quest_doc);
 
   update_node(&quest_v_doc, VARIABLE_DETAILS, {
@@ -345,7 +350,7 @@ ACTION quests::propactivate (checksum256 quest_hash) {
 // used by the contract inside a proposal
 ACTION quests::notactivate (checksum256 quest_hash) {
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   hypha::Document quest_v_doc = get_variable_node_or_fail(quest_doc);
 
   require_auth(get_self());
@@ -367,7 +372,7 @@ ACTION quests::notactivate (checksum256 quest_hash) {
 // used by the quest cretor
 ACTION quests::delquest (checksum256 quest_hash) {
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   hypha::Document quest_v_doc = get_variable_node_or_fail(quest_doc);
 
   name creator = quest_doc.getCreator();
@@ -377,8 +382,8 @@ ACTION quests::delquest (checksum256 quest_hash) {
 
   check_quest_status_stage(quest_doc.getHash(), ""_n, quest_stage_staged, "quests: can not cancel the quest");
 
-  m_documentGraph.eraseDocument(quest_doc.getHash(), true);
-  m_documentGraph.eraseDocument(quest_v_doc.getHash(), true);
+  erase_doc(quest_doc.getHash());
+  erase_doc(quest_v_doc.getHash());
 
   print("CANCEL action executed successfully\n");
 
@@ -391,7 +396,7 @@ ACTION quests::apply (checksum256 quest_hash, name applicant, string description
 
   check_quest_status_stage(quest_hash, ""_n, quest_stage_active, "quests: user can not apply for this quest");
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   check_type(quest_doc, graph::QUEST);
 
   hypha::ContentGroups applicant_cgs {
@@ -424,8 +429,8 @@ ACTION quests::apply (checksum256 quest_hash, name applicant, string description
 
   hypha::Document applicant_v_doc(get_self(), applicant, std::move(applicant_v_cgs));
 
-  hypha::Edge::write(get_self(), applicant, quest_hash, applicant_doc.getHash(), graph::HAS_APPLICANT);
-  hypha::Edge::write(get_self(), applicant, applicant_doc.getHash(), applicant_v_doc.getHash(), graph::VARIABLE);
+  write_edge(applicant, quest_hash, applicant_doc.getHash(), graph::HAS_APPLICANT);
+  write_edge(applicant, applicant_doc.getHash(), applicant_v_doc.getHash(), graph::VARIABLE);
 
   if (is_voted_quest(quest_doc)) {
     propose_aux(applicant_doc.getHash(), quest_doc.getCreator(), name("accptapplcnt"), name("rejctapplcnt"));
@@ -436,7 +441,7 @@ ACTION quests::apply (checksum256 quest_hash, name applicant, string description
 // used by the contract inside a proposal (voted quest) or the quest creator (private quest)
 ACTION quests::accptapplcnt (checksum256 applicant_hash) {
 
-  hypha::Document applicant_doc(get_self(), applicant_hash);
+  hypha::Document applicant_doc = get_doc(applicant_hash);
   hypha::Document applicant_v_doc = get_variable_node_or_fail(applicant_doc);
   hypha::ContentWrapper applicant_cw = applicant_doc.getContentWrapper();
 
@@ -444,7 +449,7 @@ ACTION quests::accptapplcnt (checksum256 applicant_hash) {
 
   checksum256 quest_hash = applicant_cw.getOrFail(IDENTIFIER_DETAILS, QUEST_HASH) -> getAs<checksum256>();
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   name creator = quest_doc.getCreator();
 
   hypha::ContentWrapper quest_cw = quest_doc.getContentWrapper();
@@ -470,7 +475,7 @@ ACTION quests::accptapplcnt (checksum256 applicant_hash) {
     hypha::Content(ACCEPTED_DATE, int64_t(eosio::current_time_point().sec_since_epoch()))
   });
 
-  hypha::Edge::write(get_self(), creator, quest_hash, applicant_doc.getHash(), graph::HAS_ACCPTAPPL);
+  write_edge(creator, quest_hash, applicant_doc.getHash(), graph::HAS_ACCPTAPPL);
 
   name applicant_account = applicant_cw.getOrFail(FIXED_DETAILS, APPLICANT_ACCOUNT) -> getAs<name>();
   print("ACCPTAPPLCNT action executed successfully (", applicant_account, ")\n");
@@ -480,14 +485,14 @@ ACTION quests::accptapplcnt (checksum256 applicant_hash) {
 // used by the contract inside a proposal (voted quest) or the quest creator (private quest)
 ACTION quests::rejctapplcnt (checksum256 applicant_hash) {
 
-  hypha::Document applicant_doc(get_self(), applicant_hash);
+  hypha::Document applicant_doc = get_doc(applicant_hash);
   hypha::Document applicant_v_doc = get_variable_node_or_fail(applicant_doc);
   hypha::ContentWrapper applicant_cw = applicant_doc.getContentWrapper();
 
   check_type(applicant_doc, graph::APPLICANT);
 
   checksum256 quest_hash = applicant_cw.getOrFail(IDENTIFIER_DETAILS, QUEST_HASH) -> getAs<checksum256>();
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   hypha::ContentWrapper quest_cw = quest_doc.getContentWrapper();
 
   name creator = quest_doc.getCreator();
@@ -507,7 +512,7 @@ ACTION quests::accptquest (checksum256 quest_hash) {
 
   check_quest_status_stage(quest_hash, ""_n, quest_stage_active, "quests: applicant can not accept this quest");
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   check_type(quest_doc, graph::QUEST);
 
   hypha::Document maker_doc = get_doc_from_edge(quest_hash, graph::HAS_ACCPTAPPL);
@@ -529,16 +534,16 @@ ACTION quests::accptquest (checksum256 quest_hash) {
   });
 
   hypha::Edge maker_edge = hypha::Edge::get(get_self(), quest_hash, maker_doc.getHash(), graph::HAS_ACCPTAPPL);
-  maker_edge.erase();
+  erase_edge(maker_edge);
 
-  hypha::Edge::write(get_self(), quest_doc.getCreator(), quest_hash, maker_doc.getHash(), graph::HAS_MAKER);
+  write_edge(quest_doc.getCreator(), quest_hash, maker_doc.getHash(), graph::HAS_MAKER);
 
 }
 
 // the maker completes a milestone
 ACTION quests::mcomplete (checksum256 milestone_hash, string url_documentation, string description) {
 
-  hypha::Document milestone_doc(get_self(), milestone_hash);
+  hypha::Document milestone_doc = get_doc(milestone_hash);
   hypha::Document milestone_v_doc = get_variable_node_or_fail(milestone_doc);
 
   check_type(milestone_doc, graph::MILESTONE);
@@ -604,7 +609,7 @@ void quests::accept_milestone (hypha::Document & milestone_doc, hypha::Document
 // used by the quest creator
 ACTION quests::accptmilstne (checksum256 milestone_hash) {
 
-  hypha::Document milestone_doc(get_self(), milestone_hash);
+  hypha::Document milestone_doc = get_doc(milestone_hash);
   hypha::Document milestone_v_doc = get_variable_node_or_fail(milestone_doc);
 
   check_type(milestone_doc, graph::MILESTONE);
@@ -628,7 +633,7 @@ ACTION quests::propaccptmil (checksum256 milestone_hash) {
 
   require_auth(get_self());
 
-  hypha::Document milestone_doc(get_self(), milestone_hash);
+  hypha::Document milestone_doc = get_doc(milestone_hash);
   hypha::Document milestone_v_doc = get_variable_node_or_fail(milestone_doc);
 
   accept_milestone(milestone_doc, milestone_v_doc);
@@ -640,7 +645,7 @@ ACTION quests::propaccptmil (checksum256 milestone_hash) {
 // pays out an accepted milestone, can be called by anyone
 ACTION quests::payoutmilstn (checksum256 milestone_hash) {
 
-  hypha::Document milestone_doc(get_self(), milestone_hash);
+  hypha::Document milestone_doc = get_doc(milestone_hash);
   hypha::Document milestone_v_doc = get_variable_node_or_fail(milestone_doc);
   hypha::Document quest_doc = get_quest_node_from_milestone(milestone_doc);
   hypha::Document maker_doc = get_doc_from_edge(quest_doc.getHash(), graph::HAS_MAKER);
@@ -680,7 +685,7 @@ ACTION quests::payoutmilstn (checksum256 milestone_hash) {
 // used by the contract inside a proposal (voted quest) or the quest creator (private quest)
 ACTION quests::rejctmilstne (checksum256 milestone_hash) {
 
-  hypha::Document milestone_doc(get_self(), milestone_hash);
+  hypha::Document milestone_doc = get_doc(milestone_hash);
   hypha::Document milestone_v_doc = get_variable_node_or_fail(milestone_doc);
 
   check_type(milestone_doc, graph::MILESTONE);
@@ -699,7 +704,7 @@ ACTION quests::rejctmilstne (checksum256 milestone_hash) {
 
 void quests::propose_aux (const checksum256 & node_hash, const name & quest_owner, const name & passed_action, const name & rejected_action) {
 
-  hypha::Document node_doc(get_self(), node_hash);
+  hypha::Document node_doc = get_doc(node_hash);
   hypha::ContentWrapper node_cw = node_doc.getContentWrapper();
 
   name node_type = node_cw.getOrFail(FIXED_DETAILS, TYPE) -> getAs<name>();
@@ -750,13 +755,13 @@ void quests::propose_aux (const checksum256 & node_hash, const name & quest_owne
 
   hypha::Document proposal_v_doc(get_self(), get_self(), std::move(proposal_v_cgs));
 
-  hypha::Edge::write(get_self(), get_self(), proposal_doc.getHash(), node_doc.getHash(), graph::PROPOSE);
-  hypha::Edge::write(get_self(), get_self(), node_doc.getHash(), proposal_doc.getHash(), graph::PROPOSED_BY);
+  write_edge(get_self(), proposal_doc.getHash(), node_doc.getHash(), graph::PROPOSE);
+  write_edge(get_self(), node_doc.getHash(), proposal_doc.getHash(), graph::PROPOSED_BY);
 
-  hypha::Edge::write(get_self(), get_self(), proposal_doc.getHash(), proposal_v_doc.getHash(), graph::VARIABLE);
+  write_edge(get_self(), proposal_doc.getHash(), proposal_v_doc.getHash(), graph::VARIABLE);
 
   hypha::Document proposals_doc = get_proposals_node();
-  hypha::Edge::write(get_self(), get_self(), proposals_doc.getHash(), proposal_doc.getHash(), graph::OPEN);
+  write_edge(get_self(), proposals_doc.getHash(), proposal_doc.getHash(), graph::OPEN);
 
 }
 
@@ -776,7 +781,7 @@ uint64_t quests::get_size(name id) {
 // determines whether a prop passes or not, executes the corresponding action
 ACTION quests::evalprop (checksum256 proposal_hash) {
 
-  hypha::Document proposal_doc(get_self(), proposal_hash);
+  hypha::Document proposal_doc = get_doc(proposal_hash);
   hypha::ContentWrapper proposal_cw = proposal_doc.getContentWrapper();
 
   hypha::Document proposal_v_doc = get_variable_node_or_fail(proposal_doc);
@@ -808,7 +813,7 @@ ACTION quests::evalprop (checksum256 proposal_hash) {
 
     hypha::Document proposals_doc = get_proposals_node();
 
-    (hypha::Edge::get(get_self(), proposals_doc.getHash(), graph::OPEN)).erase();
+    erase_edge(proposals_doc.getHash(), graph::OPEN);
 
     if (proposal_passed && valid_quorum) {
 
@@ -817,7 +822,7 @@ ACTION quests::evalprop (checksum256 proposal_hash) {
         hypha::Content(STAGE, proposal_stage_done)
       });
 
-      hypha::Edge::write(get_self(), get_self(), proposals_doc.getHash(), proposal_doc.getHash(), graph::PASSED);
+      write_edge(get_self(), proposals_doc.getHash(), proposal_doc.getHash(), graph::PASSED);
 
       name passed_action = proposal_cw.getOrFail(FIXED_DETAILS, PASSED_ACTION) -> getAs<name>();
       checksum256 node_hash = proposal_cw.getOrFail(IDENTIFIER_DETAILS, NODE_HASH) -> getAs<checksum256>();
@@ -845,7 +850,7 @@ ACTION quests::evalprop (checksum256 proposal_hash) {
         hypha::Content(STAGE, proposal_stage_done)
       });
 
-      hypha::Edge::write(get_self(), get_self(), proposals_doc.getHash(), proposal_doc.getHash(), graph::REJECTED);
+      write_edge(get_self(), proposals_doc.getHash(), proposal_doc.getHash(), graph::REJECTED);
 
       // execute rejection action if any
       name rejected_action = proposal_cw.getOrFail(FIXED_DETAILS, REJECTED_ACTION) -> getAs<name>();
@@ -887,7 +892,7 @@ bool quests::is_active(hypha::ContentWrapper & account_info_v_cw, int64_t & cuto
 
 void quests::vote_aux (name & voter, const checksum256 & proposal_hash, int64_t & amount, const name & option) {
 
-  hypha::Document proposal_doc(get_self(), proposal_hash);
+  hypha::Document proposal_doc = get_doc(proposal_hash);
   hypha::Document proposal_v_doc = get_variable_node_or_fail(proposal_doc);
   hypha::ContentWrapper proposal_cw = proposal_doc.getContentWrapper(); 
   hypha::ContentWrapper proposal_v_cw = proposal_v_doc.getContentWrapper();
@@ -897,7 +902,7 @@ void quests::vote_aux (name & voter, const checksum256 & proposal_hash, int64_t
   name proposal_stage = proposal_v_cw.getOrFail(VARIABLE_DETAILS, STAGE) -> getAs<name>();
   name proposal_type = proposal_cw.getOrFail(FIXED_DETAILS, PROPOSAL_TYPE) -> getAs<name>();
   checksum256 node_hash = proposal_cw.getOrFail(IDENTIFIER_DETAILS, NODE_HASH) -> getAs<checksum256>();
-  hypha::Document node_doc(get_self(), node_hash);
+  hypha::Document node_doc = get_doc(node_hash);
 
   check(proposal_stage == proposal_stage_active, "can not vote for this proposal, it is not active");
   check(!edge_exists(proposal_hash, voter), "quests: only one vote");
@@ -906,6 +911,7 @@ void quests::vote_aux (name & voter, const checksum256 & proposal_hash, int64_t
 
   if (proposal_type == proposal_type_quest) {
     hypha::Edge::getOrNew(get_self(), get_self(), node_doc.getHash(), account_info_doc.getHash(), graph::VALIDATE);
+    forget_edge(node_doc.getHash(), graph::VALIDATE);
   } else {
     hypha::ContentWrapper node_cw = node_doc.getContentWrapper();
     checksum256 quest_hash = node_cw.getOrFail(IDENTIFIER_DETAILS, QUEST_HASH) -> getAs<checksum256>();
@@ -958,8 +964,8 @@ void quests::vote_aux (name & voter, const checksum256 & proposal_hash, int64_t
 
   hypha::Document vote_doc(get_self(), voter, std::move(vote_cgs));
 
-  hypha::Edge::write(get_self(), voter, proposal_hash, vote_doc.getHash(), voter);
-  hypha::Edge::write(get_self(), voter, proposal_hash, vote_doc.getHash(), graph::VOTED_BY);
+  write_edge(voter, proposal_hash, vote_doc.getHash(), voter);
+  write_edge(voter, proposal_hash, vote_doc.getHash(), graph::VOTED_BY);
 
 }
 
@@ -976,7 +982,7 @@ ACTION quests::against (name voter, checksum256 proposal_hash, int64_t amount) {
 // can expire if the quest is taking too long
 ACTION quests::expirequest (checksum256 quest_hash) {
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   hypha::Document quest_v_doc = get_variable_node_or_fail(quest_doc);
   hypha::ContentWrapper quest_cw = quest_doc.getContentWrapper();
   hypha::ContentWrapper quest_v_cw = quest_v_doc.getContentWrapper();
@@ -1038,7 +1044,7 @@ ACTION quests::expirequest (checksum256 quest_hash) {
 // can expire applicant if he/she is taking too long to accept the quest
 ACTION quests::expireappl (checksum256 maker_hash) {
 
-  hypha::Document maker_doc(get_self(), maker_hash);
+  hypha::Document maker_doc = get_doc(maker_hash);
   hypha::ContentWrapper maker_cw = maker_doc.getContentWrapper();
 
   check_type(maker_doc, graph::APPLICANT);
@@ -1057,7 +1063,7 @@ ACTION quests::expireappl (checksum256 maker_hash) {
   check(accepted_date <= cutoff, "quests: can not expire applicant, it is too soon");
 
   checksum256 quest_hash = maker_cw.getOrFail(IDENTIFIER_DETAILS, QUEST_HASH) -> getAs<checksum256>();
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   hypha::ContentWrapper quest_cw = quest_doc.getContentWrapper();
 
   name creator = quest_doc.getCreator();
@@ -1071,7 +1077,7 @@ ACTION quests::expireappl (checksum256 maker_hash) {
   }
 
   hypha::Edge maker_edge = hypha::Edge::get(get_self(), quest_doc.getHash(), maker_doc.getHash(), graph::HAS_ACCPTAPPL);
-  maker_edge.erase();
+  erase_edge(maker_edge);
 
   update_node(&maker_v_doc, VARIABLE_DETAILS, {
     hypha::Content(STATUS, applicant_status_expired)
@@ -1082,7 +1088,7 @@ ACTION quests::expireappl (checksum256 maker_hash) {
 // cancel the maker
 ACTION quests::cancelappl (checksum256 maker_hash) {
 
-  hypha::Document maker_doc(get_self(), maker_hash);
+  hypha::Document maker_doc = get_doc(maker_hash);
   hypha::ContentWrapper maker_cw = maker_doc.getContentWrapper();
 
   check_type(maker_doc, graph::APPLICANT);
@@ -1094,7 +1100,7 @@ ACTION quests::cancelappl (checksum256 maker_hash) {
   check(status == applicant_status_confirmed, "quests: can not cancel applicant, the applicant is not in confirmed status");
 
   checksum256 quest_hash = maker_cw.getOrFail(IDENTIFIER_DETAILS, QUEST_HASH) -> getAs<checksum256>();
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   hypha::ContentWrapper quest_cw = quest_doc.getContentWrapper();
 
   name creator = quest_doc.getCreator();
@@ -1108,7 +1114,7 @@ ACTION quests::cancelappl (checksum256 maker_hash) {
   }
 
   hypha::Edge maker_edge = hypha::Edge::get(get_self(), quest_doc.getHash(), maker_doc.getHash(), graph::HAS_MAKER);
-  maker_edge.erase();
+  erase_edge(maker_edge);
 
   update_node(&maker_v_doc, VARIABLE_DETAILS, {
     hypha::Content(STATUS, applicant_status_cancel)
@@ -1119,7 +1125,7 @@ ACTION quests::cancelappl (checksum256 maker_hash) {
 // cancel the application if not getting any response (used by the applicant)
 ACTION quests::retractappl (checksum256 applicant_hash) {
 
-  hypha::Document applicant_doc(get_self(), applicant_hash);
+  hypha::Document applicant_doc = get_doc(applicant_hash);
   hypha::ContentWrapper applicant_cw = applicant_doc.getContentWrapper();
 
   check_type(applicant_doc, graph::APPLICANT);
@@ -1135,7 +1141,7 @@ ACTION quests::retractappl (checksum256 applicant_hash) {
 
   checksum256 quest_hash = applicant_cw.getOrFail(IDENTIFIER_DETAILS, QUEST_HASH) -> getAs<checksum256>();
   
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   hypha::ContentWrapper quest_cw = quest_doc.getContentWrapper();
 
   name creator = quest_doc.getCreator();
@@ -1143,26 +1149,26 @@ ACTION quests::retractappl (checksum256 applicant_hash) {
 
   if (creator != fund) {
     hypha::Edge edge = hypha::Edge::get(get_self(), applicant_hash, graph::PROPOSED_BY);
-    hypha::Document proposal_doc(get_self(), edge.getToNode());
+    hypha::Document proposal_doc = get_doc(edge.getToNode());
     hypha::Document proposal_v_doc = get_variable_node_or_fail(proposal_doc);
     hypha::ContentWrapper proposal_v_cw = proposal_v_doc.getContentWrapper();
 
     name proposal_stage = proposal_v_cw.getOrFail(VARIABLE_DETAILS, STAGE) -> getAs<name>();
     check(proposal_stage == proposal_stage_staged, "quests: can not retract application");
 
-    m_documentGraph.eraseDocument(proposal_doc.getHash(), true);
-    m_documentGraph.eraseDocument(proposal_v_doc.getHash(), true);
+    erase_doc(proposal_doc.getHash());
+    erase_doc(proposal_v_doc.getHash());
   }
 
-  m_documentGraph.eraseDocument(applicant_doc.getHash(), true);
-  m_documentGraph.eraseDocument(applicant_v_doc.getHash(), true);
+  erase_doc(applicant_doc.getHash());
+  erase_doc(applicant_v_doc.getHash());
 
 }
 
 // abandone a quest (if the applicant is the maker)
 ACTION quests::quitapplcnt (checksum256 applicant_hash) {
 
-  hypha::Document applicant_doc(get_self(), applicant_hash);
+  hypha::Document applicant_doc = get_doc(applicant_hash);
   hypha::ContentWrapper applicant_cw = applicant_doc.getContentWrapper();
 
   check_type(applicant_doc, graph::APPLICANT);
@@ -1182,13 +1188,13 @@ ACTION quests::quitapplcnt (checksum256 applicant_hash) {
     hypha::Content(STATUS, applicant_status_quitted)
   });
 
-  p.second.erase();
+  erase_edge(p.second);
 
 }
 
 ACTION quests::rateapplcnt (checksum256 maker_hash, name opinion) {
 
-  hypha::Document maker_doc(get_self(), maker_hash);
+  hypha::Document maker_doc = get_doc(maker_hash);
   hypha::ContentWrapper maker_cw = maker_doc.getContentWrapper();
 
   check_type(maker_doc, graph::APPLICANT);
@@ -1199,7 +1205,7 @@ ACTION quests::rateapplcnt (checksum256 maker_hash, name opinion) {
 
   check_quest_status_stage(quest_hash, quest_status_finished, quest_stage_done, "quests: can not rate applicant");
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   name creator = quest_doc.getCreator();
 
   require_auth(creator);
@@ -1228,10 +1234,10 @@ ACTION quests::rateapplcnt (checksum256 maker_hash, name opinion) {
 
 ACTION quests::ratequest (checksum256 quest_hash, name opinion) {
 
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
   hypha::Edge edge = hypha::Edge::get(get_self(), quest_hash, graph::HAS_MAKER);
 
-  hypha::Document maker_doc(get_self(), edge.getToNode());
+  hypha::Document maker_doc = get_doc(edge.getToNode());
   name applicant_account = maker_doc.getCreator();
 
   require_auth(applicant_account);
@@ -1294,7 +1300,7 @@ void quests::update_node (hypha::Document * node_doc, const string & content_gro
     hypha::ContentWrapper::insertOrReplace(*node_cg, new_contents[i]);
   }
 
-  m_documentGraph.updateDocument(get_self(), old_node_hash, node_doc -> getContentGroups());
+  update_doc(old_node_hash, node_doc -> getContentGroups());
 
 }
 
@@ -1318,20 +1324,138 @@ name quests::get_proposal_type (name & node_type) {
 
 hypha::Document quests::get_root_node () {
 
+  if (root_hash) {
+    return get_doc(*root_hash);
+  }
+
   document_table d_t(get_self(), get_self().value);
   auto root_itr = d_t.begin();
 
   check(root_itr != d_t.end(), "There is no root node");
 
-  hypha::Document root_doc(get_self(), root_itr -> getHash());
+  cache_misses++;
+  root_hash = root_itr -> getHash();
+  hypha::Document root_doc = *root_itr;
+  doc_cache[*root_hash] = root_doc;
   return root_doc;
 
 }
 
 hypha::Document quests::get_doc_from_edge (const checksum256 & node_hash, const name & edge_name) {
-  std::vector<hypha::Edge> edges = m_documentGraph.getEdgesFromOrFail(node_hash, edge_name);
-  hypha::Document node_to(get_self(), edges[0].getToNode());
-  return node_to;
+  auto [exists, to_node] = find_edge_to(node_hash, edge_name);
+  if (!exists) {
+    check(false, "no edges exist: from " + hypha::readableHash(node_hash) + " with name " + edge_name.to_string());
+  }
+  return get_doc(to_node);
+}
+
+hypha::Document quests::get_doc (const checksum256 & hash) {
+  auto citr = doc_cache.find(hash);
+  if (citr != doc_cache.end()) {
+    cache_hits++;
+    return citr -> second;
+  }
+
+  cache_misses++;
+  hypha::Document doc(get_self(), hash);
+  doc_cache[hash] = doc;
+  return doc;
+}
+
+std::pair<bool, checksum256> quests::find_edge_to (const checksum256 & from_node_hash, const name & edge_name) {
+  auto key = std::make_pair(from_node_hash, edge_name.value);
+  auto citr = edge_cache.find(key);
+  if (citr != edge_cache.end()) {
+    cache_hits++;
+    return std::make_pair(true, citr -> second);
+  }
+
+  cache_misses++;
+  auto [exists, edge] = m_documentGraph.edgesFrom(from_node_hash, edge_name).first();
+  if (!exists) {
+    return std::make_pair(false, checksum256());
+  }
+
+  edge_cache[key] = edge.to_node;
+  return std::make_pair(true, edge.to_node);
+}
+
+// documents are content addressed, an update creates a new node and moves the edges over,
+// so the cache is written back under the new hash and edges pointing at the old one follow
+hypha::Document quests::update_doc (const checksum256 & old_hash, const hypha::ContentGroups & content_groups) {
+  hypha::Document new_doc = m_documentGraph.updateDocument(get_self(), old_hash, content_groups);
+  checksum256 new_hash = new_doc.getHash();
+
+  doc_cache.erase(old_hash);
+  doc_cache[new_hash] = new_doc;
+
+  if (root_hash && *root_hash == old_hash) {
+    root_hash = new_hash;
+  }
+
+  std::map<std::pair<checksum256, uint64_t>, checksum256> moved;
+  for (auto eitr = edge_cache.begin(); eitr != edge_cache.end();) {
+    if (eitr -> second == old_hash) {
+      eitr -> second = new_hash;
+    }
+    if (eitr -> first.first == old_hash) {
+      moved[std::make_pair(new_hash, eitr -> first.second)] = eitr -> second;
+      eitr = edge_cache.erase(eitr);
+    } else {
+      eitr++;
+    }
+  }
+  edge_cache.insert(moved.begin(), moved.end());
+
+  return new_doc;
+}
+
+void quests::erase_doc (const checksum256 & hash) {
+  m_documentGraph.eraseDocument(hash, true);
+
+  doc_cache.erase(hash);
+
+  if (root_hash && *root_hash == hash) {
+    root_hash.reset();
+  }
+
+  for (auto eitr = edge_cache.begin(); eitr != edge_cache.end();) {
+    if (eitr -> first.first == hash || eitr -> second == hash) {
+      eitr = edge_cache.erase(eitr);
+    } else {
+      eitr++;
+    }
+  }
+}
+
+void quests::erase_edge (const checksum256 & from_node_hash, const name & edge_name) {
+  hypha::Edge edge = hypha::Edge::get(get_self(), from_node_hash, edge_name);
+  erase_edge(edge);
+}
+
+void quests::erase_edge (hypha::Edge & edge) {
+  edge.erase();
+  forget_edge(edge.from_node, edge.edge_name);
+}
+
+void quests::write_edge (const name & creator, const checksum256 & from_node_hash, const checksum256 & to_node_hash, const name & edge_name) {
+  hypha::Edge::write(get_self(), creator, from_node_hash, to_node_hash, edge_name);
+  forget_edge(from_node_hash, edge_name);
+}
+
+// a cached edge is the first one found from the node, any write or erase can change it
+void quests::forget_edge (const checksum256 & from_node_hash, const name & edge_name) {
+  edge_cache.erase(std::make_pair(from_node_hash, edge_name.value));
+}
+
+void quests::save_cache_stats () {
+  if (cache_hits == 0 && cache_misses == 0) { return; }
+
+  cache_stats_tables cachestats(get_self(), get_self().value);
+  auto stats = cachestats.get_or_default();
+  stats.hits += cache_hits;
+  stats.misses += cache_misses;
+  cachestats.set(stats, get_self());
 }
 
 hypha::Document quests::get_account_infos_node () {
@@ -1358,10 +1482,8 @@ void quests::check_auth (name & creator, name & fund) {
 
 void quests::check_quest_status_stage (const checksum256 & quest_hash, const name & status, const name & stage, const string & error_msg) {
 
-  hypha::Document quest_doc(get_self(), quest_hash);
-  std::vector<hypha::Edge> edges = m_documentGraph.getEdgesFromOrFail(quest_hash, graph::VARIABLE);
-
-  hypha::Document quest_v_doc(get_self(), edges[0].getToNode());
+  hypha::Document quest_doc = get_doc(quest_hash);
+  hypha::Document quest_v_doc = get_doc_from_edge(quest_hash, graph::VARIABLE);
   hypha::ContentWrapper cw = quest_v_doc.getContentWrapper();
 
   check_quest_status_stage(cw, status, stage, error_msg);
@@ -1384,12 +1506,12 @@ void quests::check_quest_status_stage (hypha::ContentWrapper & cw, const name &
 
 void quests::validate_milestones (const checksum256 & quest_hash) {
 
-  std::vector<hypha::Edge> edges = m_documentGraph.getEdgesFromOrFail(quest_hash, graph::HAS_MILESTONE);
+  auto milestones = m_documentGraph.edgesFrom(quest_hash, graph::HAS_MILESTONE);
   int64_t total = 0;
 
-  for (int i = 0; i < edges.size(); i++) {
+  for (const hypha::Edge & edge : milestones) {
 
-    hypha::Document milestone_doc(get_self(), edges[i].getToNode());
+    hypha::Document milestone_doc = get_doc(edge.to_node);
     hypha::ContentWrapper cw = milestone_doc.getContentWrapper();
 
     hypha::Content * milestone_content = cw.getOrFail(FIXED_DETAILS, PAYOUT_PERCENTAGE);
@@ -1420,10 +1542,30 @@ void quests::update_balance (hypha::Document & balance_doc, asset & quantity, co
     hypha::ContentGroup * cg = old_cw.getGroupOrFail(VARIABLE_DETAILS);
     hypha::ContentWrapper::insertOrReplace(*cg, new_balance);
 
-    m_documentGraph.updateDocument(get_self(), oldHash, balance_doc.getContentGroups());
+    update_doc(oldHash, balance_doc.getContentGroups());
 
 }
 
+ACTION quests::reindexedges (uint64_t start, uint64_t chunksize) {
+  require_auth(get_self());
+
+  auto [more, next] = hypha::Edge::reindex(get_self(), start, chunksize);
+
+  if (more) {
+    action next_execution(
+      permission_level{get_self(), "active"_n},
+      get_self(),
+      "reindexedges"_n,
+      std::make_tuple(next, chunksize)
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(next_execution);
+    tx.delay_sec = 1;
+    tx.send(utils::deferred_id(tx), _self);
+  }
+}
+
 void quests::add_balance (hypha::Document & balance_doc, asset & quantity) {
   utils::check_asset(quantity);
   update_balance(balance_doc, quantity, false);
@@ -1437,11 +1579,11 @@ void quests::sub_balance (hypha::Document & balance_doc, asset & quantity) {
 hypha::Document quests::get_account_info (name & account, const bool & create_if_not_exists) {
 
   hypha::Document account_infos_doc = get_account_infos_node();
-  std::vector<hypha::Edge> edges = m_documentGraph.getEdgesFrom(account_infos_doc.getHash(), account);
+  auto [exists, edge] = m_documentGraph.edgesFrom(account_infos_doc.getHash(), account).first();
 
   if (create_if_not_exists) {
-    if (edges.size() > 0) {
-      hypha::Document account_info_doc(get_self(), edges[0].getToNode());
+    if (exists) {
+      hypha::Document account_info_doc = get_doc(edge.getToNode());
       return account_info_doc;
     } else {
       hypha::ContentGroups account_info_cgs {
@@ -1470,14 +1612,14 @@ hypha::Document quests::get_account_info (name & account, const bool & create_if
       hypha::Document account_info_doc(get_self(), get_self(), std::move(account_info_cgs));
       hypha::Document account_info_v_doc(get_self(), get_self(), std::move(account_info_v_cgs));
 
-      hypha::Edge::write(get_self(), get_self(), account_infos_doc.getHash(), account_info_doc.getHash(), account);
-      hypha::Edge::write(get_self(), get_self(), account_info_doc.getHash(), account_info_v_doc.getHash(), graph::VARIABLE);
+      write_edge(get_self(), account_infos_doc.getHash(), account_info_doc.getHash(), account);
+      write_edge(get_self(), account_info_doc.getHash(), account_info_v_doc.getHash(), graph::VARIABLE);
 
       return account_info_doc;
     }
   } else {
-    check(edges.size() > 0, "quests: account has no info entry");
-    hypha::Document account_info_doc(get_self(), edges[0].getToNode());
+    check(exists, "quests: account has no info entry");
+    hypha::Document account_info_doc = get_doc(edge.getToNode());
     return account_info_doc;
   }
 
@@ -1493,7 +1635,7 @@ hypha::Document quests::get_quest_node_from_milestone (hypha::Document & milesto
   hypha::ContentWrapper milestone_cw = milestone_doc.getContentWrapper();
 
   checksum256 quest_hash = milestone_cw.getOrFail(IDENTIFIER_DETAILS, QUEST_HASH) -> getAs<checksum256>();
-  hypha::Document quest_doc(get_self(), quest_hash);
+  hypha::Document quest_doc = get_doc(quest_hash);
 
   return quest_doc;
 
@@ -1513,7 +1655,7 @@ void quests::update_milestone_status (hypha::Document * milestone_v_doc, const n
   hypha::ContentGroup * cg = milestone_v_cw.getGroupOrFail(VARIABLE_DETAILS);
   hypha::ContentWrapper::insertOrReplace(*cg, hypha::Content(STATUS, new_status));
   
-  m_documentGraph.updateDocument(get_self(), old_hash, milestone_v_doc -> getContentGroups());
+  update_doc(old_hash, milestone_v_doc -> getContentGroups());
 
 }
 
@@ -1547,8 +1689,7 @@ void quests::send_to_escrow (const name & fromfund, const name & recipient, asse
 }
 
 bool quests::edge_exists (const checksum256 & from_node_hash, const name & edge_name) {
-  std::vector<hypha::Edge> edges = m_documentGraph.getEdgesFrom(from_node_hash, edge_name);
-  return edges.size() > 0;
+  return m_documentGraph.hasEdgesFrom(from_node_hash, edge_name);
 }
 
 bool quests::is_voted_quest (hypha::Document & quest_doc) {
@@ -334,7 +334,7 @@ ACTION referendums::updatevoice(uint64_t start, uint64_t batchsize) {
     transaction tx;
     tx.actions.emplace_back(next_execution);
     tx.delay_sec = 1;
-    tx.send(next_value, _self);
+    tx.send(utils::deferred_id(tx), _self);
   }
 }
 
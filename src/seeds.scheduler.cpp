@@ -5,46 +5,83 @@
 #include <string>
 
 
-uint64_t scheduler::is_ready_op (const name & operation, const uint64_t & timestamp) {
+uint64_t scheduler::op_due (const operations_table & op) {
+    return op.timestamp + op.period;
+}
 
-    auto itr = operations.find(operation.value);
+// 0 when the moon phase the op is waiting for has not been added yet
+uint64_t scheduler::moon_op_due (const moon_ops_table & moonop) {
 
-    if(itr -> pause > 0) {
-        print(" transaction " + operation.to_string() + " is paused");
-        return 0;
+    if (moonop.start_time > moonop.last_moon_cycle_id) {
+        return moonop.start_time;
     }
 
-    uint64_t periods = 0;
-
-    periods = (timestamp - itr -> timestamp) / itr -> period;
+    auto mpitr = moonphases.find(moonop.last_moon_cycle_id);
+    for (uint64_t i = 0; i < moonop.quarter_moon_cycles && mpitr != moonphases.end(); i++) {
+        mpitr++;
+    }
 
-    print("\nPERIODS: " + std::to_string(periods) + ", current_time: " + std::to_string(timestamp) + ", last_timestap: " + std::to_string(itr->timestamp) );
+    return mpitr != moonphases.end() ? mpitr->timestamp : 0;
 
-    return periods > 0 ? timestamp : 0;
-    
 }
 
-uint64_t scheduler::is_ready_moon_op (const name & operation, const uint64_t & timestamp) {
-
-    auto mitr = moonops.find(operation.value);
-
-    if (mitr->pause > 0) {
-        print("moon op " + operation.to_string() + " is paused");
-        return 0;
+void scheduler::set_due (name id, uint64_t due, bool moon) {
+    auto ditr = dueops.find(id.value);
+    if (ditr != dueops.end()) {
+        dueops.modify(ditr, _self, [&](auto & item){
+            item.due = due;
+            item.moon = moon;
+        });
+    } else {
+        dueops.emplace(_self, [&](auto & item){
+            item.id = id;
+            item.due = due;
+            item.moon = moon;
+        });
     }
+}
 
-    uint64_t moon_timestamp = 0;
+void scheduler::unschedule (name id) {
+    auto ditr = dueops.find(id.value);
+    if (ditr != dueops.end()) {
+        dueops.erase(ditr);
+    }
+}
 
-    if (mitr->start_time > mitr->last_moon_cycle_id) {
-        moon_timestamp = mitr->start_time;
-    } else {
-        auto mpitr = moonphases.find(mitr->last_moon_cycle_id);
-        std::advance(mpitr, mitr->quarter_moon_cycles);
-        moon_timestamp = mpitr->timestamp;
+void scheduler::schedule_op (name id) {
+    auto itr = operations.find(id.value);
+    if (itr == operations.end() || itr->pause > 0) {
+        unschedule(id);
+        return;
     }
+    set_due(id, op_due(*itr), false);
+}
 
-    return timestamp >= moon_timestamp ? moon_timestamp : 0;
+void scheduler::schedule_moon_op (name id) {
+    auto mitr = moonops.find(id.value);
+    if (mitr == moonops.end() || mitr->pause > 0) {
+        unschedule(id);
+        return;
+    }
+    uint64_t due = moon_op_due(*mitr);
+    if (due == 0) {
+        unschedule(id);
+        return;
+    }
+    set_due(id, due, true);
+}
 
+void scheduler::rebuild_due () {
+    auto ditr = dueops.begin();
+    while (ditr != dueops.end()) {
+        ditr = dueops.erase(ditr);
+    }
+    for (auto itr = operations.begin(); itr != operations.end(); itr++) {
+        schedule_op(itr->id);
+    }
+    for (auto mitr = moonops.begin(); mitr != moonops.end(); mitr++) {
+        schedule_moon_op(mitr->id);
+    }
 }
 
 
@@ -340,6 +377,8 @@ void scheduler::reset_aux(bool destructive) {
     }' -p cycle.seeds@active
     */
 
+    rebuild_due();
+
 }
 
 
@@ -376,6 +415,8 @@ ACTION scheduler::configop(name id, name action, name contract, uint64_t period,
             noperation.timestamp = start - period;
         });
     }
+
+    schedule_op(id);
 }
 
 ACTION scheduler::addmoonop(name id, name action, name contract, uint64_t quarter_moon_cycles, string start_phase_name) {
@@ -445,6 +486,8 @@ ACTION scheduler::configmoonop(name id, name action, name contract, uint64_t qua
             op.pause = 0;
         });
     }
+
+    schedule_moon_op(id);
 }
 
 ACTION scheduler::moonphase(uint64_t timestamp, string phase_name, string eclipse) {
@@ -475,6 +518,11 @@ ACTION scheduler::moonphase(uint64_t timestamp, string phase_name, string eclips
         });
     }
 
+    // moon ops waiting for this phase become due
+    for (auto mitr = moonops.begin(); mitr != moonops.end(); mitr++) {
+        schedule_moon_op(mitr->id);
+    }
+
 }
 
 ACTION scheduler::removeop(name id) {
@@ -483,12 +531,14 @@ ACTION scheduler::removeop(name id) {
     auto itr = operations.find(id.value);
     if (itr != operations.end()) {
         operations.erase(itr);
+        unschedule(id);
         return;
     }
 
     auto mitr = moonops.find(id.value);
     if (mitr != moonops.end()) {
         moonops.erase(mitr);
+        unschedule(id);
         return;
     }
 
@@ -503,6 +553,7 @@ ACTION scheduler::pauseop(name id, uint8_t pause) {
         operations.modify(itr, _self, [&](auto & moperation) {
             moperation.pause = pause;
         });
+        schedule_op(id);
         return;
     }
 
@@ -511,6 +562,7 @@ ACTION scheduler::pauseop(name id, uint8_t pause) {
         moonops.modify(mitr, _self, [&](auto & moonop){
             moonop.pause = pause;
         });
+        schedule_moon_op(id);
         return;
     }
 
@@ -557,58 +609,74 @@ ACTION scheduler::execute() {
     // execute operations
     // =======================
 
-    auto ops_by_last_executed = operations.get_index<"bytimestamp"_n>();
-    auto itr = ops_by_last_executed.begin();
-    bool has_executed = false;
+    // every op that is due is sent in this tick, in due order, up to sched.ops
+    // each op runs in its own deferred transaction, one that fails does not roll back the tick
+
+    // deployments from before the due index have ops but no dueops rows yet
+    if (dueops.begin() == dueops.end() &&
+        (operations.begin() != operations.end() || moonops.begin() != moonops.end())) {
+        rebuild_due();
+    }
 
     uint64_t timestamp = eosio::current_time_point().sec_since_epoch();
 
-    while(itr != ops_by_last_executed.end()) {
-        if(is_ready_op(itr -> id, timestamp)){
+    uint64_t max_ops = config.get(ops_per_tick.value, (contracts::scheduler.to_string() + ": the parameter " + ops_per_tick.to_string() + " is not configured in " + contracts::settings.to_string()).c_str()).value;
 
-            print("\nOperation to be executed: " + itr -> id.to_string(), "\n");
+    auto ops_by_due = dueops.get_index<"bydue"_n>();
+    auto ditr = ops_by_due.begin();
+    uint64_t executed = 0;
 
-            exec_op(itr->id, itr->contract, itr->operation);
+    while (ditr != ops_by_due.end() && ditr->due <= timestamp && executed < max_ops) {
+        name id = ditr->id;
 
-            ops_by_last_executed.modify(itr, _self, [&](auto & operation) {
-                operation.timestamp = timestamp;
-            });
+        if (ditr->moon) {
+            uint64_t used_timestamp = ditr->due;
+            auto mitr = moonops.find(id.value);
 
-            has_executed = true;
-            
-            break;
-        }
-        itr++;
-    }
-
-    if (!has_executed) {
-        auto moonops_by_last_cycle = moonops.get_index<"bylastcycle"_n>();
-        auto mitr = moonops_by_last_cycle.begin();
-        
-        while (mitr != moonops_by_last_cycle.end()) {
-            uint64_t used_timestamp = is_ready_moon_op(mitr->id, timestamp);
-            if (used_timestamp) {
-                print("\nMoon operation to be executed: " + mitr->id.to_string(), "\n");
+            if (mitr != moonops.end()) {
+                print("\nMoon operation to be executed: " + id.to_string(), "\n");
 
-                exec_op(mitr->id, mitr->contract, mitr->action);
+                send_op(id, mitr->contract, mitr->action);
 
-                moonops_by_last_cycle.modify(mitr, _self, [&](auto & operation){
+                moonops.modify(mitr, _self, [&](auto & operation){
                     operation.last_moon_cycle_id = used_timestamp;
                 });
 
-                has_executed = true;
+                executed++;
+            }
+
+            schedule_moon_op(id);
+        } else {
+            auto itr = operations.find(id.value);
+
+            if (itr != operations.end()) {
+                print("\nOperation to be executed: " + id.to_string(), "\n");
+
+                send_op(id, itr->contract, itr->operation);
 
-                break;
+                operations.modify(itr, _self, [&](auto & operation) {
+                    operation.timestamp = timestamp;
+                });
+
+                executed++;
             }
-            mitr++;
+
+            schedule_op(id);
         }
+
+        ditr = ops_by_due.begin();
     }
 
     // =======================
     // schedule next execution
     // =======================
 
-    auto it_s = has_executed ? 1 : config.get(seconds_to_execute.value, (contracts::scheduler.to_string() + ": the parameter " + seconds_to_execute.to_string() + " is not configured in " + contracts::settings.to_string()).c_str()).value;
+    uint64_t it_s = config.get(seconds_to_execute.value, (contracts::scheduler.to_string() + ": the parameter " + seconds_to_execute.to_string() + " is not configured in " + contracts::settings.to_string()).c_str()).value;
+
+    ditr = ops_by_due.begin();
+    if (ditr != ops_by_due.end()) {
+        it_s = ditr->due <= timestamp ? 1 : std::min(it_s, ditr->due - timestamp);
+    }
 
     action next_execution(
         permission_level{get_self(), "active"_n},
@@ -635,45 +703,18 @@ ACTION scheduler::checknext() {
     // check operations
     // =======================
 
-    auto ops_by_last_executed = operations.get_index<"bytimestamp"_n>();
-    auto itr = ops_by_last_executed.begin();
-    bool has_executed = false;
-
-    uint64_t timestamp = eosio::current_time_point().sec_since_epoch();
-
-    while(itr != ops_by_last_executed.end()) {
-        print(" checking op " + (itr -> id).to_string());
-        if(is_ready_op(itr -> id, timestamp)){
-
-            print(" next op: " + (itr -> id).to_string());
+    auto ops_by_due = dueops.get_index<"bydue"_n>();
+    auto ditr = ops_by_due.begin();
 
-            has_executed = true;
-            
-            break;
-        }
-        itr++;
+    if (ditr == ops_by_due.end()) {
+        print(" no op scheduled");
+        return;
     }
 
-    if (!has_executed) {
-
-        auto moonops_by_last_cycle = moonops.get_index<"bylastcycle"_n>();
-        auto mitr = moonops_by_last_cycle.begin();
-
-        print(" checking moon op " + (mitr -> id).to_string());
-        
-        while (mitr != moonops_by_last_cycle.end()) {
-            uint64_t used_timestamp = is_ready_moon_op(mitr->id, timestamp);
-            if (used_timestamp) {
-                
-                print(" next op: " + (mitr -> id).to_string());
-                
-                has_executed = true;
-                break;
-            }
-            mitr++;
-        }
-    }
+    uint64_t timestamp = eosio::current_time_point().sec_since_epoch();
 
+    print(" next op: " + (ditr -> id).to_string() + (ditr -> moon ? " (moon)" : "") + 
+        ", due: " + std::to_string(ditr -> due) + ", current_time: " + std::to_string(timestamp));
 
 }
 
@@ -752,6 +793,21 @@ void scheduler::exec_op(name id, name contract, name operation) {
     a.send();
 }
 
+void scheduler::send_op(name id, name contract, name operation) {
+
+    action a = action(
+        permission_level{contract, "execute"_n},
+        contract,
+        operation,
+        std::make_tuple()
+    );
+
+    transaction tx;
+    tx.actions.emplace_back(a);
+    tx.delay_sec = 0;
+    tx.send(utils::deferred_id(tx), _self);
+}
+
 // not using this
 uint64_t scheduler::next_valid_moon_phase(uint64_t moon_cycle_id, uint64_t quarter_moon_cycles) {
     uint64_t now = eosio::current_time_point().sec_since_epoch();
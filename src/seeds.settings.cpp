@@ -22,6 +22,8 @@ void settings::reset() {
   confwithdesc(name("prop.cyc.qb"), 2, "Prop cycles to take into account for calculating quorum basis", high_impact);
 
   confwithdesc(name("prop.evl.psh"), 100, "Rep points the proposer will lose if the proposal fails in evaluate state", high_impact);
+
+  confwithdesc(name("prop.evl.bt"), 10, "Number of proposals evaluated per action after onperiod", medium_impact);
   
   confwithdesc(name("unity.high"), 90, "High unity threshold (in percentage)", high_impact);
   confwithdesc(name("unity.medium"), 85, "Medium unity threshold (in percentage)", high_impact);
@@ -49,6 +51,7 @@ void settings::reset() {
   confwithdesc(name("hrvstreward"), 100000, "Harvest reward", high_impact);
   confwithdesc(name("mooncyclesec"), utils::moon_cycle, "Number of seconds a moon cycle has", high_impact);
   confwithdesc(name("batchsize"), 200, "Number of elements per batch", high_impact);
+  confwithdesc(name("rank.lazy"), 0, "Ranking passes only publish percentile boundaries and ranks are resolved on read (1), or rank is written into every row (0)", high_impact);
   confwithdesc(name("region.fee"), uint64_t(1000) * uint64_t(10000), "Minimum amount to create a region (in Seeds)", high_impact);
   confwithdesc(name("vdecayprntge"), 11, "The percentage of voice decay (in percentage)", high_impact);
   confwithdesc(name("decaytime"), utils::proposal_cycle / 2, "Minimum amount of seconds before start voice decay", high_impact);
@@ -67,6 +70,8 @@ void settings::reset() {
   confwithdesc(name("txlimit.min"), 7, "Minimum number of transactions per user", high_impact);
 
   confwithdesc(name("htry.trx.max"), 2, "Maximum number of transactions to take into account for transaction score between to users per day", high_impact);
+  confwithdesc(name("htry.batch"), 50, "Number of pending transfers history processes per action", medium_impact);
+  confwithdesc(name("htry.stale"), 300, "Seconds pending transfers wait before their processor is sent again", medium_impact);
   confwithdesc(name("qev.trx.cap"), uint64_t(1777) * uint64_t(10000), "Maximum number of seeds to take into account as qualifying volume", high_impact);
 
   conffloatdsc(name("infation.per"), 0.0, "Economic inflation per period. Example 0.01 = 1%", high_impact);
@@ -76,6 +81,7 @@ void settings::reset() {
   confwithdesc(name("hrvst.rgns"), 300000, "Percentage of the harvest that Regions will receive (4 decimals of precision)", high_impact);
   confwithdesc(name("hrvst.orgs"), 200000, "Percentage of the harvest that Organizations will receive (4 decimals of precision)", high_impact);
   confwithdesc(name("hrvst.global"), 200000, "Percentage of the harvest that Global G-DHO will receive (4 decimals of precision)", high_impact);
+  confwithdesc(name("hrvst.autocl"), 1, "Pay out unclaimed harvest when an account plants or unplants (1 = on, 0 = off)", medium_impact);
   
   confwithdesc(name("org.minharv"), 2, "Minimum status for a organization to be eligible for receiving part of the harvest ", high_impact);
 
@@ -133,6 +139,7 @@ void settings::reset() {
 
   // Scheduler cycle
   confwithdesc(name("secndstoexec"), 60, "Seconds to execute", high_impact);
+  confwithdesc(name("sched.ops"), 5, "Maximum number of due operations the scheduler executes per cycle", high_impact);
 
   // =====================================
   // citizenship path 
@@ -194,7 +194,7 @@ void token::check_limit_transactions(name from) {
     transaction_tables transactions(get_self(), seeds_symbol.code().raw());
     auto titr = transactions.find(from.value);
 
-    if (titr != transactions.end()) {
+    if (titr != transactions.end() && titr -> epoch.value_or(0) >= current_trx_epoch()) {
       check(max_trx > titr -> outgoing_transactions, "Maximum limit of allowed transactions reached.");
     }
   }
@@ -219,55 +219,32 @@ void token::check_limit(const name& from) {
 
   transaction_tables transactions(get_self(), seeds_symbol.code().raw());
   auto titr = transactions.find(from.value);
-  uint64_t current = titr->outgoing_transactions;
+  uint64_t current = titr->epoch.value_or(0) >= current_trx_epoch() ? titr->outgoing_transactions : 0;
 
   check(current < limit, "too many outgoing transactions");
 }
 
-void token::reset_weekly_aux(uint64_t begin) {
-
-  config_tables config(contracts::settings, contracts::settings.value);
-
-  auto batch_size = config.get(name("batchsize").value, "The batchsize parameter has not been initialized yet.");
-  auto sym_code_raw = seeds_symbol.code().raw();
-  uint64_t count = 0;
-
-  transaction_tables transactions(get_self(), sym_code_raw);
-
-  auto titr = begin == 0 ? transactions.begin() : transactions.lower_bound(begin);
-  while (titr != transactions.end() && count < batch_size.value) {
-    transactions.modify(titr, _self, [&](auto& user) {
-      user.incoming_transactions = 0;
-      user.outgoing_transactions = 0;
-      user.total_transactions = 0;
-      user.transactions_volume = asset(0, seeds_symbol);
-    });
-    titr++;
-    count++;
-  }
+uint64_t token::current_trx_epoch() {
+  return trxepoch.get_or_default().epoch;
+}
 
-  if (titr != transactions.end()) {
-    transaction trx{};
-    trx.actions.emplace_back(
-      permission_level(_self, "active"_n),
-      _self,
-      "resetwhelper"_n,
-      std::make_tuple((titr -> account).value)
-    );
-    trx.delay_sec = 1;
-    trx.send(eosio::current_time_point().sec_since_epoch(), _self);
+void token::roll_trx_epoch(transaction_stats & stats, uint64_t epoch) {
+  if (stats.epoch.value_or(0) < epoch) {
+    stats.transactions_volume = asset(0, stats.transactions_volume.symbol);
+    stats.total_transactions = 0;
+    stats.incoming_transactions = 0;
+    stats.outgoing_transactions = 0;
+    stats.epoch.emplace(epoch);
   }
-
 }
 
 void token::resetweekly() {
   require_auth(get_self());
-  reset_weekly_aux((uint64_t)0);
-}
 
-void token::resetwhelper (uint64_t begin) {
-  require_auth(get_self());
-  reset_weekly_aux(begin);
+  auto epoch = trxepoch.get_or_default();
+  epoch.epoch += 1;
+  epoch.timestamp = eosio::current_time_point().sec_since_epoch();
+  trxepoch.set(epoch, get_self());
 }
 
 void token::update_stats( const name& from, const name& to, const asset& quantity ) {
@@ -285,6 +262,7 @@ void token::update_stats( const name& from, const name& to, const asset& quantit
 
     auto fromitr = transactions.find(from.value);
     auto toitr = transactions.find(to.value);
+    uint64_t epoch = current_trx_epoch();
 
     if (fromitr == transactions.end()) {
       transactions.emplace(get_self(), [&](auto& user) {
@@ -293,9 +271,11 @@ void token::update_stats( const name& from, const name& to, const asset& quantit
         user.total_transactions = 1;
         user.incoming_transactions = 0;
         user.outgoing_transactions = 1;
+        user.epoch.emplace(epoch);
       });
     } else {
       transactions.modify(fromitr, get_self(), [&](auto& user) {
+          roll_trx_epoch(user, epoch);
           user.transactions_volume += quantity;
           user.outgoing_transactions += 1;
           user.total_transactions += 1;
@@ -309,9 +289,11 @@ void token::update_stats( const name& from, const name& to, const asset& quantit
         user.total_transactions = 1;
         user.incoming_transactions = 1;
         user.outgoing_transactions = 0;
+        user.epoch.emplace(epoch);
       });
     } else {
       transactions.modify(toitr, get_self(), [&](auto& user) {
+        roll_trx_epoch(user, epoch);
         user.transactions_volume += quantity;
         user.total_transactions += 1;
         user.incoming_transactions += 1;
@@ -391,7 +373,7 @@ void token::updatecirc() {
       std::make_tuple()
     );
     trx.delay_sec = 60 * 60; // TODO use scheduler for this - run every hour
-    trx.send(eosio::current_time_point().sec_since_epoch() + 19, _self);
+    trx.send(utils::deferred_id(trx), _self);
     
 }
 
@@ -441,5 +423,5 @@ void token::minthrvst (const name& to, const asset& quantity, const string& memo
 
 } /// namespace eosio
 
-EOSIO_DISPATCH( eosio::token, (create)(issue)(transfer)(open)(close)(retire)(burn)(resetweekly)(resetwhelper)(updatecirc)(minthrvst) )
+EOSIO_DISPATCH( eosio::token, (create)(issue)(transfer)(open)(close)(retire)(burn)(resetweekly)(updatecirc)(minthrvst) )
   
\ No newline at end of file
@@ -131,6 +131,12 @@ async function resetContracts () {
 
 async function getVoice (account) {
   const voice = []
+  const voiceDecay = await getTableRows({
+    code: dao,
+    scope: dao,
+    table: 'voicedecay',
+    json: true
+  })
   for (const s of scopes) {
     const voiceTable = await getTableRows({
       code: dao,
@@ -141,9 +147,47 @@ async function getVoice (account) {
       limit: 1
     })
     if (voiceTable.rows.length > 0) {
+      // balances are stored against the scope decay factor at write time
+      const { decay_factor, ...row } = voiceTable.rows[0]
+      const decay = voiceDecay.rows.find(r => r.scope == s)
+      const factor = decay ? parseFloat(decay.factor) : 1
+      const written = decay_factor != null ? parseFloat(decay_factor) : 1
+      let balance = written == factor ? row.balance : Math.floor(row.balance * (factor / written))
+      // delegators' balances are also scaled by their delegatee's pool
+      const delegation = await getTableRows({
+        code: dao,
+        scope: s,
+        table: 'deltrusts',
+        json: true,
+        lower_bound: account,
+        upper_bound: account
+      })
+      if (delegation.rows.length > 0 && delegation.rows[0].pool_factor != null) {
+        const pools = await getTableRows({
+          code: dao,
+          scope: s,
+          table: 'delpools',
+          json: true,
+          limit: 1000
+        })
+        const d = delegation.rows[0]
+        const pool = pools.rows.find(p => p.delegatee == d.delegatee)
+        // a pool linked into its delegatee's follows that pool's live factor
+        let live = pool && pool.epoch == d.pool_epoch ? parseFloat(pool.factor) : 0
+        let current = pool
+        while (live > 0 && current.parent) {
+          const parent = pools.rows.find(p => p.delegatee == current.parent)
+          if (!parent) { break }
+          live = parent.epoch != current.parent_epoch ? 0 : live * parseFloat(parent.factor) / parseFloat(current.parent_factor)
+          current = parent
+        }
+        const written = parseFloat(d.pool_factor)
+        balance = live == 0 ? 0 : (live == written ? balance : balance - Math.floor(balance * (1 - live / written)))
+      }
       voice.push({
         scope: s,
-        ...voiceTable.rows[0]
+        ...row,
+        balance
       })
     }
   }
@@ -962,9 +1006,9 @@ describe('Voting', async assert => {
     should: 'have the votes',
     actual: votesTable.rows,
     expected: [
-      { proposal_id: 1, account: firstuser, amount: 10, favour: 1 },
-      { proposal_id: 1, account: seconduser, amount: 5, favour: 0 },
-      { proposal_id: 1, account: thirduser, amount: 0, favour: 0 }
+      { proposal_id: 1, account: firstuser, amount: 10, favour: 1, delegated: 0 },
+      { proposal_id: 1, account: seconduser, amount: 5, favour: 0, delegated: 0 },
+      { proposal_id: 1, account: thirduser, amount: 0, favour: 0, delegated: 0 }
     ]
   })
 
@@ -1206,6 +1250,7 @@ describe('Voice Delegation', async assert => {
   console.log('\n')
   console.log(proposalsTable2)
 
+  // seconduser took the voice it spent into its own vote when it undelegated
   assert({
     given: 'delegated vote',
     should: 'have the correct favour and against',
@@ -239,6 +239,10 @@ describe('Token Sale Rounds', async assert => {
 
   let roundsAfterAdd = await getRounds()
 
+  const addedRound = roundsAfterAdd.rows[50]
+  const addedUsd = parseFloat(addedRound.usd_total) - parseFloat(roundsAfterAdd.rows[49].usd_total)
+  delete addedRound.usd_total
+
   assert({
     given: `rounds price with 3.3% cumulative increase `,
     should: `match values from spreadsheet`,
@@ -249,7 +253,7 @@ describe('Token Sale Rounds', async assert => {
   assert({
     given: `add round `,
     should: `be appended to rounds`,
-    actual: roundsAfterAdd.rows[50],
+    actual: addedRound,
     expected: {
       "id": 50,
       "max_sold": 50000000 + vol,
@@ -257,6 +261,13 @@ describe('Token Sale Rounds', async assert => {
     }
   })
 
+  assert({
+    given: `add round `,
+    should: `add the round's usd value to the cumulative total`,
+    actual: addedUsd.toFixed(2),
+    expected: (vol * 10000 / 11000).toFixed(2)
+  })
+
 
 })
 
@@ -869,7 +880,10 @@ describe('Update Volume', async assert => {
       rounds.rows[4],
       rounds.rows[5],
       rounds.rows[49],
-    ],
+    ].map(r => {
+      delete r.usd_total
+      return r
+    }),
     expected: [
       {
         "id": 4,
@@ -244,15 +244,15 @@ describe('gratitude many acks', async assert => {
   }
 
   const getAcks = async (account) => {
-    const acksTable = await getTableRows({
+    const ackTotalsTable = await getTableRows({
       code: 'gratz.seeds',
       scope: 'gratz.seeds',
-      table: 'acks',
+      table: 'acktotals',
       json: true
     })
-    if (acksTable.rows) {
-      var acks =  acksTable.rows.reduce(function(map, obj) {
-        map[obj.donor] = obj.receivers;
+    if (ackTotalsTable.rows) {
+      var acks =  ackTotalsTable.rows.reduce(function(map, obj) {
+        map[obj.donor] = obj.total;
         return map;
       }, {})
       return acks[account]
@@ -265,7 +265,7 @@ describe('gratitude many acks', async assert => {
     assert({
       given: `${user} performed ack`,
       should: 'have the correct num acks',
-      actual: acks.length,
+      actual: acks,
       expected: expected
     })
   }
@@ -337,11 +337,25 @@ describe('gratitude many acks', async assert => {
 
   console.log('new round')
   await contracts.gratitude.newround({ authorization: `${gratitude}@active` })
-  await sleep(5000) // wait for parallel processing
+  await sleep(15000) // wait for parallel processing, one ack count per batch
 
   const contractBalanceAfter = await getBalance(gratitude)
   const balancesAfter = [await getBalance(firstuser), await getBalance(seconduser), await getBalance(thirduser), await getBalance(fourthuser)]
 
+  const ackCounts = await getTableRows({
+    code: gratitude,
+    scope: firstuser,
+    table: 'ackcounts',
+    json: true
+  })
+
+  assert({
+    given: 'a donor with more receivers than the batch size',
+    should: 'settle all its acks across batches',
+    actual: ackCounts.rows.length,
+    expected: 0
+  })
+
   const statsTable = await getTableRows({
     code: gratitude,
     scope: gratitude,
@@ -369,6 +383,20 @@ describe('gratitude many acks', async assert => {
     actual: contractBalanceAfter,
     expected: contractBalanceBefore
   })
+
+  const roundStatus = await getTableRows({
+    code: gratitude,
+    scope: gratitude,
+    table: 'roundstatus',
+    json: true
+  })
+
+  assert({
+    given: 'gratitude round finished',
+    should: 'be idle on the next round',
+    actual: [roundStatus.rows[0].stage, roundStatus.rows[0].round_id],
+    expected: ['idle', statsTable.rows[statsTable.rows.length - 1].round_id]
+  })
 })
 
 describe('testing pot keep', async assert => {
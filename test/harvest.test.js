@@ -1383,6 +1383,11 @@ async function testHarvest (assert, dSeeds) {
 
   await sleep(1000)
 
+  console.log('claim harvest')
+  for (const account of [...users, ...orgs]) {
+    await contracts.harvest.claimharvest(account, { authorization: `${account}@active` })
+  }
+
   const userBalancesAfter = await Promise.all(users.map(user => getTestBalance(user)))
   const orgBalancesAfter = await Promise.all(orgs.map(org => getTestBalance(org)))
   const rgnBalancesAfter = await Promise.all(rgns.map(rgn => getHarvestBalance(rgn)))
@@ -1446,6 +1451,149 @@ async function testHarvest (assert, dSeeds) {
 
 }
 
+describe('harvest claims', async assert => {
+
+  if (!isLocal()) {
+    console.log("only run unit tests on local - don't reset accounts on mainnet or testnet")
+    return
+  }
+
+  const contracts = await initContracts({ accounts, harvest, settings, token })
+
+  console.log('settings reset')
+  await contracts.settings.reset({ authorization: `${settings}@active` })
+
+  console.log('accounts reset')
+  await contracts.accounts.reset({ authorization: `${accounts}@active` })
+
+  console.log('harvest reset')
+  await contracts.harvest.reset({ authorization: `${harvest}@active` })
+
+  console.log('join users')
+  await contracts.accounts.adduser(firstuser, 'first user', 'individual', { authorization: `${accounts}@active` })
+  await contracts.accounts.adduser(seconduser, 'second user', 'individual', { authorization: `${accounts}@active` })
+
+  console.log('disable auto claim')
+  await contracts.settings.configure('hrvst.autocl', 0, { authorization: `${settings}@active` })
+
+  console.log('plant seeds')
+  await contracts.token.transfer(seconduser, harvest, '10.0000 SEEDS', '', { authorization: `${seconduser}@active` })
+
+  const getTestBalance = async (user) => {
+    const balance = await eos.getCurrencyBalance(names.token, user, 'TESTS')
+    return Number.parseFloat(balance[0]) || 0
+  }
+
+  const harvested = async (before) => {
+    const after = await Promise.all([firstuser, seconduser].map(user => getTestBalance(user)))
+    return after.map((balance, index) => Math.round((balance - before[index]) * 10000) / 10000)
+  }
+
+  const getOutstanding = async () => {
+    const claimPools = await getTableRows({
+      code: harvest,
+      scope: harvest,
+      table: 'claimpools',
+      json: true
+    })
+    return claimPools.rows.map(r => r.outstanding)
+  }
+
+  console.log('update contribution scores')
+  await contracts.harvest.testupdatecs(firstuser, 10, { authorization: `${harvest}@active` })
+  await contracts.harvest.testupdatecs(seconduser, 30, { authorization: `${harvest}@active` })
+
+  const balancesBefore = await Promise.all([firstuser, seconduser].map(user => getTestBalance(user)))
+
+  console.log('accrue harvest, 1 TESTS per rank point held')
+  await contracts.harvest.testaccrue(harvest, '40.0000 TESTS', { authorization: `${harvest}@active` })
+
+  console.log('first user claims')
+  await contracts.harvest.claimharvest(firstuser, { authorization: `${firstuser}@active` })
+  const partialClaim = await harvested(balancesBefore)
+
+  console.log('first user rank changes')
+  await contracts.harvest.testupdatecs(firstuser, 30, { authorization: `${harvest}@active` })
+
+  console.log('accrue harvest, 1 TESTS per rank point held')
+  await contracts.harvest.testaccrue(harvest, '60.0000 TESTS', { authorization: `${harvest}@active` })
+
+  console.log('both users claim')
+  await contracts.harvest.claimharvest(firstuser, { authorization: `${firstuser}@active` })
+  await contracts.harvest.claimharvest(seconduser, { authorization: `${seconduser}@active` })
+  const fullClaim = await harvested(balancesBefore)
+  const outstandingAfterClaims = await getOutstanding()
+
+  console.log('enable auto claim')
+  await contracts.settings.configure('hrvst.autocl', 1, { authorization: `${settings}@active` })
+
+  const balancesBeforeAuto = await Promise.all([firstuser, seconduser].map(user => getTestBalance(user)))
+
+  console.log('accrue harvest, 1 TESTS per rank point held')
+  await contracts.harvest.testaccrue(harvest, '60.0000 TESTS', { authorization: `${harvest}@active` })
+  const outstandingBeforeAuto = await getOutstanding()
+
+  console.log('first user plants, second user unplants')
+  await contracts.token.transfer(firstuser, harvest, '1.0000 SEEDS', '', { authorization: `${firstuser}@active` })
+  await contracts.harvest.unplant(seconduser, '1.0000 SEEDS', { authorization: `${seconduser}@active` })
+  const autoClaim = await harvested(balancesBeforeAuto)
+  const outstandingAfterAuto = await getOutstanding()
+
+  console.log('first user drops out of the ranking')
+  await contracts.harvest.testupdatecs(firstuser, 0, { authorization: `${harvest}@active` })
+
+  const balancesBeforeDrop = await Promise.all([firstuser, seconduser].map(user => getTestBalance(user)))
+
+  console.log('accrue harvest, only the second user holds a rank')
+  await contracts.harvest.testaccrue(harvest, '30.0000 TESTS', { authorization: `${harvest}@active` })
+  await contracts.harvest.claimharvest(seconduser, { authorization: `${seconduser}@active` })
+  const claimAfterDrop = await harvested(balancesBeforeDrop)
+  const outstandingAfterDrop = await getOutstanding()
+
+  assert({
+    given: 'harvest accrued and only the first user claimed',
+    should: 'pay the first user its share only',
+    actual: partialClaim,
+    expected: [10, 0]
+  })
+
+  assert({
+    given: 'first user rank changed between harvests',
+    should: 'pay the old rank for the first harvest and the new rank for the second',
+    actual: fullClaim,
+    expected: [40, 60]
+  })
+
+  assert({
+    given: 'every account claimed',
+    should: 'have nothing outstanding',
+    actual: outstandingAfterClaims,
+    expected: [0]
+  })
+
+  assert({
+    given: 'auto claim on',
+    should: 'pay the harvest on plant and unplant',
+    actual: autoClaim,
+    expected: [30, 30]
+  })
+
+  assert({
+    given: 'harvest accrued and then paid on plant and unplant',
+    should: 'track the outstanding claims',
+    actual: [outstandingBeforeAuto, outstandingAfterAuto],
+    expected: [[600000], [0]]
+  })
+
+  assert({
+    given: 'first user dropped to rank zero before the harvest',
+    should: 'share the harvest among the ranks still held and leave nothing unclaimable',
+    actual: [claimAfterDrop, outstandingAfterDrop],
+    expected: [[0, 30], [0]]
+  })
+
+})
+
 describe('Mint Rate and Harvest', async assert => {
 
   const contracts = await initContracts({ pool })
@@ -1529,6 +1677,11 @@ describe('Mint Rate and Harvest, dSeeds > 0', async assert => {
 
   console.log('mintedSeeds...')
 
+  console.log('claim pool payouts')
+  for (const user of users.slice(1)) {
+    await contracts.pool.claim(user, { authorization: `${user}@active` })
+  }
+
   const poolBalanceTable = await getTableRows({
     code: pool,
     scope: pool,
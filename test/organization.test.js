@@ -495,6 +495,20 @@ describe('app', async assert => {
     })
     console.log(dausScoresTable1)
 
+    const appsTableAfterCalc = await getTableRows({
+        code: organization,
+        scope: organization,
+        table: 'apps',
+        json: true
+    })
+
+    assert({
+        given: 'apps used',
+        should: 'keep running trailing totals on the apps',
+        actual: appsTableAfterCalc.rows.filter(r => r.app_name == 'app2' || r.app_name == 'app4').map(r => [r.trailing_points, r.trailing_users]),
+        expected: [[22, 2], [20, 1]]
+    })
+
     assert({
         given: 'apps used',
         should: 'have the correct app points',
@@ -541,7 +555,7 @@ describe('app', async assert => {
     assert({
         given: 'registered an app',
         should: 'have an entry in the apps table',
-        actual: appsTableAfterBan.rows,
+        actual: appsTableAfterBan.rows.map(({ trailing_points, trailing_users, window_start, ...app }) => app),
         expected: [
             {
                 app_name: 'app1',
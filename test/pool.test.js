@@ -31,7 +31,7 @@ describe('Pool transfer and payout', async assert => {
     assert({
       given,
       should,
-      actual: balanceTable.rows,
+      actual: balanceTable.rows.map(({ account, balance }) => ({ account, balance })),
       expected
     })
     assert({
@@ -73,18 +73,25 @@ describe('Pool transfer and payout', async assert => {
     should: 'have the correct balances'
   })
 
-  console.log('set batchsize to 2')
-  await contracts.settings.configure('batchsize', 2, { authorization: `${settings}@active` })
+  const claimAll = async () => {
+    for (const user of users) {
+      try {
+        await contracts.pool.claim(user, { authorization: `${user}@active` })
+      } catch (err) {
+        console.log(`${user} has nothing to claim`)
+      }
+    }
+  }
 
   console.log('payout Seeds')
   await contracts.pool.payouts('10.0000 SEEDS', { authorization: `${pool}@active` })
-  await sleep(2000)
+  await claimAll()
 
   await checkBalances({
     expected: [
       { account: firstuser, balance: '8.3334 SEEDS' },
       { account: seconduser, balance: '16.6667 SEEDS' },
-      { account: thirduser, balance: '25.0000 SEEDS' }
+      { account: thirduser, balance: '24.9999 SEEDS' }
     ],
     given: 'payout SEEDS',
     should: 'have the correct balances'
@@ -92,21 +99,21 @@ describe('Pool transfer and payout', async assert => {
 
   console.log('payout more Seeds')
   await contracts.pool.payouts('20.0000 SEEDS', { authorization: `${pool}@active` })
-  await sleep(4000)
+  await claimAll()
 
   await checkBalances({
     expected: [
       { account: firstuser, balance: '5.0001 SEEDS' },
       { account: seconduser, balance: '10.0001 SEEDS' },
-      { account: thirduser, balance: '15.0001 SEEDS' }
+      { account: thirduser, balance: '14.9998 SEEDS' }
     ],
     given: 'payout more SEEDS',
     should: 'have the correct balances'
   })
 
   console.log('payout all the Seeds')
-  await contracts.pool.payouts('30.0003 SEEDS', { authorization: `${pool}@active` })
-  await sleep(2000)
+  await contracts.pool.payouts('30.0000 SEEDS', { authorization: `${pool}@active` })
+  await claimAll()
 
   await checkBalances({
     expected: [],
@@ -125,3 +132,91 @@ describe('Pool transfer and payout', async assert => {
   })
 
 })
+
+describe('Pool drained with uneven shares', async assert => {
+
+  if (!isLocal()) {
+    console.log("only run unit tests on local - don't reset accounts on mainnet or testnet")
+    return
+  }
+
+  const contracts = await initContracts({ pool, accounts, settings, token })
+
+  const users = [firstuser, seconduser, thirduser]
+
+  const getTotal = async () => {
+    const sizesTable = await getTableRows({
+      code: pool,
+      scope: pool,
+      table: 'sizes',
+      json: true
+    })
+    return sizesTable.rows.filter(r => r.id === 'total.sz')[0].size
+  }
+
+  console.log('reset pool')
+  await contracts.pool.reset({ authorization: `${pool}@active` })
+
+  console.log('reset token')
+  await contracts.token.resetweekly({ authorization: `${token}@active` })
+
+  console.log('get initial balances')
+  const poolBefore = await getBalanceFloat(pool)
+  const balancesBefore = await Promise.all(users.map(user => getBalanceFloat(user)))
+
+  console.log(`transfer to ${pool}`)
+  const deposits = ['1.0000 SEEDS', '2.0000 SEEDS', '4.0000 SEEDS']
+  for (let i = 0; i < users.length; i++) {
+    await contracts.token.transfer(users[i], escrow, deposits[i], '', { authorization: `${users[i]}@active` })
+    await contracts.token.transfer(escrow, pool, deposits[i], users[i], { authorization: `${escrow}@active` })
+  }
+
+  console.log('payouts with shares that do not divide evenly')
+  await contracts.pool.payouts('1.0000 SEEDS', { authorization: `${pool}@active` })
+  await contracts.pool.claim(firstuser, { authorization: `${firstuser}@active` })
+  await contracts.pool.payouts('1.3333 SEEDS', { authorization: `${pool}@active` })
+  await contracts.pool.claim(seconduser, { authorization: `${seconduser}@active` })
+  await contracts.pool.claim(thirduser, { authorization: `${thirduser}@active` })
+  await contracts.pool.claim(firstuser, { authorization: `${firstuser}@active` })
+  await contracts.pool.payouts('0.7777 SEEDS', { authorization: `${pool}@active` })
+  await contracts.pool.claim(thirduser, { authorization: `${thirduser}@active` })
+
+  console.log('payout the rest')
+  const rest = await getTotal()
+  await contracts.pool.payouts(`${(rest / 10000).toFixed(4)} SEEDS`, { authorization: `${pool}@active` })
+  for (const user of users) {
+    await contracts.pool.claim(user, { authorization: `${user}@active` })
+  }
+
+  const balanceTable = await getTableRows({
+    code: pool,
+    scope: pool,
+    table: 'balances',
+    json: true
+  })
+
+  const poolAfter = await getBalanceFloat(pool)
+  const balancesAfter = await Promise.all(users.map(user => getBalanceFloat(user)))
+
+  assert({
+    given: 'the whole pool paid out and claimed',
+    should: 'have no balances left',
+    actual: [balanceTable.rows.length, await getTotal()],
+    expected: [0, 0]
+  })
+
+  assert({
+    given: 'the whole pool paid out and claimed',
+    should: 'hold no SEEDS for the users anymore',
+    actual: Math.round((poolAfter - poolBefore) * 10000),
+    expected: 0
+  })
+
+  assert({
+    given: 'the whole pool paid out and claimed',
+    should: 'return every deposit to the users',
+    actual: Math.round(balancesAfter.map((balanceAfter, index) => balanceAfter - balancesBefore[index]).reduce((acc, curr) => acc + curr) * 10000),
+    expected: 0
+  })
+
+})
@@ -1062,7 +1062,10 @@ describe('Participants', async assert => {
   assert({
     given: 'voice after voting',
     should: 'have the correct voice amount',
-    actual: voiceAfter.rows,
+    actual: voiceAfter.rows.map(r => {
+      delete r.decay_factor
+      return r
+    }),
     expected: [
       { account: firstuser, balance: 12 },
       { account: seconduser, balance: 32 },
@@ -1075,9 +1078,9 @@ describe('Participants', async assert => {
     should: 'have votes entry',
     actual: votes.rows,
     expected: [
-      { proposal_id: 1, account: firstuser, amount: 8, favour: 0 },
-      { proposal_id: 1, account: seconduser, amount: 8, favour: 1 },
-      { proposal_id: 1, account: thirduser, amount: 0, favour: 0 }
+      { proposal_id: 1, account: firstuser, amount: 8, favour: 0, delegated: 0 },
+      { proposal_id: 1, account: seconduser, amount: 8, favour: 1, delegated: 0 },
+      { proposal_id: 1, account: thirduser, amount: 0, favour: 0, delegated: 0 }
     ]
   })
 
@@ -1916,22 +1919,38 @@ describe('Voice decay', async assert => {
       json: true,
     })
 
+    const voiceDecay = await eos.getTableRows({
+      code: proposals,
+      scope: proposals,
+      table: 'voicedecay',
+      json: true,
+    })
+
+    const decayedBalances = (rows, scope) => {
+      const decay = voiceDecay.rows.find(r => r.scope == scope)
+      const factor = decay ? parseFloat(decay.factor) : 1
+      return rows.map(r => {
+        const written = r.decay_factor != null ? parseFloat(r.decay_factor) : 1
+        return written == factor ? r.balance : Math.floor(r.balance * (factor / written))
+      })
+    }
+
     assert({
       given: 'ran voice decay for the ' + n + ' time',
       should: 'decay voices if required',
-      actual: voice.rows.map(r => r.balance),
+      actual: decayedBalances(voice.rows, proposals),
       expected: expectedValues
     })
     assert({
       given: 'ran voice decay for the ' + n + ' time',
       should: 'decay voices for alliance if required',
-      actual: voiceAlliance.rows.map(r => r.balance),
+      actual: decayedBalances(voiceAlliance.rows, 'alliance'),
       expected: expectedValues
     })
     assert({
       given: 'ran voice decay for the ' + n + ' time',
       should: 'decay voices for hypha if required',
-      actual: voiceHypha.rows.map(r => r.balance),
+      actual: decayedBalances(voiceHypha.rows, 'milestone'),
       expected: expectedValues
     })
   }
@@ -1947,7 +1966,7 @@ describe('Voice decay', async assert => {
   await sleep(1000)
   await testVoiceDecay([34, 75, 0], 4)
   await sleep(4000)
-  await testVoiceDecay([28, 63, 0], 5)
+  await testVoiceDecay([28, 64, 0], 5)
   await sleep(2000)
 
   await contracts.proposals.onperiod({ authorization: `${proposals}@active` })
@@ -2037,7 +2056,10 @@ describe('Voice scope', async assert => {
       { account: 'seedsuseraaa', balance: 40 },
       { account: 'seedsuserbbb', balance: 44 }
     ],
-    actual: voiceCampaignsAfter.rows
+    actual: voiceCampaignsAfter.rows.map(r => {
+      delete r.decay_factor
+      return r
+    })
   })
 
   assert({
@@ -2047,7 +2069,10 @@ describe('Voice scope', async assert => {
       { account: 'seedsuseraaa', balance: 40 },
       { account: 'seedsuserbbb', balance: 52 }
     ],
-    actual: voiceAlliancesAfter.rows
+    actual: voiceAlliancesAfter.rows.map(r => {
+      delete r.decay_factor
+      return r
+    })
   })
 
 })
@@ -2072,6 +2097,11 @@ describe('delegate trust', async assert => {
   // this means voters get 2 points, and users who delegated get 1 point (50% of 2)
   console.log('configure votedel.mul to 50')
   await contracts.settings.configure('votedel.mul', 50, { authorization: `${settings}@active` })
+
+  // delegators are credited when the cycle ends, so only participation rep is counted then
+  console.log('configure voterep1.ind and proppass.rep to 0')
+  await contracts.settings.configure('voterep1.ind', 0, { authorization: `${settings}@active` })
+  await contracts.settings.configure('proppass.rep', 0, { authorization: `${settings}@active` })
   
   console.log('accounts reset')
   await contracts.accounts.reset({ authorization: `${accounts}@active` })
@@ -2141,29 +2171,42 @@ describe('delegate trust', async assert => {
     console.log('no cycles allowed')
   }
 
-  const getVoices = async () => {
-    const voiceCampaigns = await eos.getTableRows({
-      code: proposals,
-      scope: scopeCampaigns,
-      table: 'voice',
-      json: true,
-    })
-    const voiceAlliances = await eos.getTableRows({
+  // delegators' balances are scaled by their delegatee's pool
+  const getScopeVoices = async (scope) => {
+    const getRows = async (table) => (await eos.getTableRows({
       code: proposals,
-      scope: scopeAlliance,
-      table: 'voice',
-      json: true,
-    })
-    const voiceHypha = await eos.getTableRows({
-      code: proposals,
-      scope: scopeHypha,
-      table: 'voice',
+      scope,
+      table,
       json: true,
+    })).rows
+    const voice = await getRows('voice')
+    const deltrusts = await getRows('deltrusts')
+    const pools = await getRows('delpools')
+    return voice.map(({ account, balance }) => {
+      const d = deltrusts.find(r => r.delegator == account)
+      if (d && d.pool_factor != null) {
+        const pool = pools.find(r => r.delegatee == d.delegatee)
+        // a pool linked into its delegatee's follows that pool's live factor
+        let live = pool && pool.epoch == d.pool_epoch ? parseFloat(pool.factor) : 0
+        let current = pool
+        while (live > 0 && current.parent) {
+          const parent = pools.find(r => r.delegatee == current.parent)
+          if (!parent) { break }
+          live = parent.epoch != current.parent_epoch ? 0 : live * parseFloat(parent.factor) / parseFloat(current.parent_factor)
+          current = parent
+        }
+        const written = parseFloat(d.pool_factor)
+        balance = live == 0 ? 0 : (live == written ? balance : balance - Math.floor(balance * (1 - live / written)))
+      }
+      return { account, balance }
     })
+  }
+
+  const getVoices = async () => {
     return {
-      campaigns: voiceCampaigns.rows,
-      alliances: voiceAlliances.rows,
-      hypha: voiceHypha.rows
+      campaigns: await getScopeVoices(scopeCampaigns),
+      alliances: await getScopeVoices(scopeAlliance),
+      hypha: await getScopeVoices(scopeHypha)
     }
   }
 
@@ -2213,6 +2256,12 @@ describe('delegate trust', async assert => {
   await contracts.proposals.against(thirduser, 3, 50, { authorization: `${thirduser}@active` })
   await sleep(5000)
 
+  const voicesAfterVote = await getVoices()
+
+  console.log('pass proposals')
+  await contracts.proposals.onperiod({ authorization: `${proposals}@active` })
+  await sleep(3000)
+
   const usersTable = await eos.getTableRows({
     code: accounts,
     scope: accounts,
@@ -2222,12 +2271,6 @@ describe('delegate trust', async assert => {
 
   const reps = usersTable.rows.map(r => r.reputation)
 
-  const voicesAfterVote = await getVoices()
-
-  console.log('pass proposals')
-  await contracts.proposals.onperiod({ authorization: `${proposals}@active` })
-  await sleep(3000)
-
   for (let i = 0; i < users.length; i++) {
     await contracts.proposals.testsetvoice(users[i], voices[i], { authorization: `${proposals}@active` })
   }
@@ -2285,6 +2328,11 @@ describe('delegate trust', async assert => {
     should: 'have the correct delegation entries',
     actual: delegations.rows.map(r => {
       delete r.timestamp
+      delete r.pool_factor
+      delete r.pool_epoch
+      delete r.written
+      delete r.prior_units
+      delete r.prior_epoch
       return r
     }),
     expected: [
@@ -2317,7 +2365,7 @@ describe('delegate trust', async assert => {
     given: 'user delegated its voice',
     should: 'give a user a percentage of the earned reputation',
     actual: reps,
-    expected: [2, 1, 1, 1, 0]
+    expected: [2, 1, 2, 1, 0]
   })
 
   assert({
@@ -2349,6 +2397,8 @@ describe('delegate trust', async assert => {
     }
   })
 
+  // 25% of seedsuseraaa's pool (10 + 50) and of seedsuserccc's pool (35) is spent with the vote,
+  // seedsuserxxx takes its share into its own vote when it cancels the delegation
   assert({
     given: 'vote table after delegatee has voted',
     should: 'have delegate votes in it',
@@ -2357,22 +2407,14 @@ describe('delegate trust', async assert => {
       "proposal_id": 1,
       "account": "seedsuseraaa",
       "amount": 5,
-      "favour": 1
-    },{
-      "proposal_id": 1,
-      "account": "seedsuserbbb",
-      "amount": 2,
-      "favour": 1
-    },{
-      "proposal_id": 1,
-      "account": "seedsuserccc",
-      "amount": 12,
-      "favour": 1
+      "favour": 1,
+      "delegated": 15
     },{
       "proposal_id": 1,
       "account": "seedsuserxxx",
       "amount": 8,
-      "favour": 1
+      "favour": 1,
+      "delegated": 0
     }
   ]
   })
@@ -2385,22 +2427,14 @@ describe('delegate trust', async assert => {
       "proposal_id": 1,
       "account": "seedsuseraaa",
       "amount": 5,
-      "favour": 0
-    },{
-      "proposal_id": 1,
-      "account": "seedsuserbbb",
-      "amount": 2,
-      "favour": 0
-    },{
-      "proposal_id": 1,
-      "account": "seedsuserccc",
-      "amount": 12,
-      "favour": 0
+      "favour": 0,
+      "delegated": 15
     },{
       "proposal_id": 1,
       "account": "seedsuserxxx",
       "amount": 8,
-      "favour": 1
+      "favour": 1,
+      "delegated": 0
     }
   ]
   })
@@ -2414,8 +2448,8 @@ describe('delegate trust', async assert => {
       campAfterDelegateVote.rows[0].against,
     ],
     expected: [
-      27,
-      27,
+      28,
+      28,
       0,
     ]
   })
@@ -2429,9 +2463,9 @@ describe('delegate trust', async assert => {
       campAfterDelegateRevert.rows[0].against,
     ],
     expected: [
-      27,
+      28,
       8,
-      19,
+      20,
     ]
   })
 
@@ -2960,7 +2994,10 @@ describe('Hypha proposals', async assert => {
   assert({
     given: 'voted on hypha props',
     should: 'have the correct voice',
-    actual: voiceTable.rows,
+    actual: voiceTable.rows.map(r => {
+      delete r.decay_factor
+      return r
+    }),
     expected: [
       { account: firstuser, balance: 90 },
       { account: seconduser, balance: 80 },
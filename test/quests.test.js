@@ -572,6 +572,20 @@ describe('Private quests', async assert => {
     expected: true
   })
 
+  const cacheStats = await getTableRows({
+    code: quests,
+    scope: quests,
+    table: 'cachestats',
+    json: true
+  })
+
+  assert({
+    given: 'quests actions ran',
+    should: 'count document and edge cache hits and misses',
+    actual: cacheStats.rows.length === 1 && cacheStats.rows[0].hits > 0 && cacheStats.rows[0].misses > 0,
+    expected: true
+  })
+
 })
 
 
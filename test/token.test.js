@@ -65,7 +65,7 @@ describe('token.transfer.history', async assert => {
   assert({
     given: 'transactions',
     should: 'have transaction stat entries',
-    actual: stats.rows.filter( (item) => item.account == firstuser || item.account == seconduser),
+    actual: stats.rows.filter( (item) => item.account == firstuser || item.account == seconduser).map(({ epoch, ...item }) => item),
     expected: [
       {
         "account": "seedsuseraaa",
@@ -295,10 +295,20 @@ describe('token.resetweekly', async assert => {
     json: true
   })
 
+  const trxEpoch = await getTableRows({
+    code: token,
+    scope: token,
+    table: 'trxepoch',
+    json: true
+  })
+
+  const currentEpoch = trxEpoch.rows[0].epoch
+
   balancesAfter = balancesAfter.rows.filter(row => 
     row.account == firstuser || row.account == seconduser || row.account == thirduser)
 
-  balancesAfter = balancesAfter.map(row => row.outgoing_transactions)
+  // rows from an older epoch count as zero until the account transacts again
+  balancesAfter = balancesAfter.map(row => (row.epoch || 0) < currentEpoch ? 0 : row.outgoing_transactions)
 
   await contracts.settings.reset({ authorization: `${settings}@active` })
 